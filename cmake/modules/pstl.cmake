@@ -0,0 +1,18 @@
+cmake_minimum_required(VERSION 3.10)
+
+option(PSTL "Enable the std::execution backend (needs TBB with libstdc++)" ON)
+
+if(PSTL)
+    find_package(TBB QUIET)
+
+    if(TBB_FOUND)
+        message(STATUS "Enabling std::execution (TBB).")
+        set(SPLINE_PSTL ON)
+    else()
+        message(WARNING "TBB not found. ExecutionBackend::Par falls back to the thread pool.")
+        set(SPLINE_PSTL OFF)
+    endif()
+else()
+    message(STATUS "std::execution disabled.")
+    set(SPLINE_PSTL OFF)
+endif()
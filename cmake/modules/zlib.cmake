@@ -0,0 +1,18 @@
+cmake_minimum_required(VERSION 3.10)
+
+option(ZLIB_COMPRESSION "Enable compressed columns in binary files (zlib)" ON)
+
+if(ZLIB_COMPRESSION)
+    find_package(ZLIB QUIET)
+
+    if(ZLIB_FOUND)
+        message(STATUS "Enabling zlib compression.")
+        set(SPLINE_ZLIB ON)
+    else()
+        message(WARNING "zlib not found. Compiling without compressed columns.")
+        set(SPLINE_ZLIB OFF)
+    endif()
+else()
+    message(STATUS "zlib compression disabled.")
+    set(SPLINE_ZLIB OFF)
+endif()
@@ -4,36 +4,60 @@
 #include <spdlog/spdlog.h>
 
 #include "points/points.h"
+#include "points/pointsbatch.h"
 #include "inputreader/prep.h"      // Points prep(double eps_cut, const Points& lm)
+#include "inputreader/csvreader.h" // preprocess::readCurve
+#include "storage/resultwriter.h"   // storage::ResultWriter
 #include "geom/shoelace.h"         // geom::Shoelace
 #include "simulation/simulation.h" // sim::computeAreaTimeslices, computeMomentumTimeslices
+#include "geom/simd/isa.h"          // geom::simd::activeIsa
+#include "parallel/execution.h"     // reproducible
 
-int main() {
+int main(int argc, char** argv) {
 
     using clock = std::chrono::high_resolution_clock;
 
+    spdlog::info("Shoelace kernels : {} (set SPLINE_ISA to force a level)",
+            geom::simd::isaName(geom::simd::activeIsa()));
+    spdlog::info("Reproducible reductions : {} (set SPLINE_REPRODUCIBLE=1 to turn on)",
+            reproducible() ? "on" : "off");
+
 
     /////////////////////////////////////////////////////////////////////////
-    // 1) Python _cc = [[0/1000,0],[3/1000,180],[10/1000,180]]
+    // 1) Python _cc = [[0/1000,0],[3/1000,180],[10/1000,180]],
+    //    or an epsilon,sigma CSV file given as first argument
 
     const std::vector<double> epsilon = {0.0 / 1000.0, 3.0 / 1000.0, 10.0 / 1000.0};
     const std::vector<double> sigma   = {0.0,          180.0,        180.0};
     
     Points cc(epsilon, sigma);
 
+    if (argc > 1) {
+        auto start_read = clock::now();
+        cc = preprocess::readCurve(argv[1]);
+        auto end_read = clock::now();
+        if (cc.size() == 0) {
+            return 1;
+        }
+        spdlog::info("Read {} points from {} : {} ns", cc.size(), argv[1],
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end_read - start_read).count());
+    }
+
 
-    // 2) eps_cc: 0 ~ 10/1000, num_timesteps
+    // 2) eps_cc: over the strain range of cc (0 ~ 10/1000), num_timesteps
     const std::size_t num_timesteps = 10000;
     std::vector<double> eps_cc(num_timesteps);
 
-    const double eps_min = 0.0;
-    const double eps_max = 10.0 / 1000.0;
+    const double eps_min = cc.get_epsilon().front();
+    const double eps_max = cc.get_epsilon().back();
     const double step = (eps_max - eps_min) / static_cast<double>(num_timesteps - 1);
 
     for (std::size_t t = 0; t < num_timesteps; ++t) {
         eps_cc[t] = eps_min + step * static_cast<double>(t);
     }
 
+    auto start_build = clock::now();
+
     std::vector<Points> timeslices;
     timeslices.reserve(num_timesteps);
 
@@ -41,7 +65,21 @@ int main() {
         timeslices.push_back(preprocess::prep(eps_cc[t], cc)); 
     }
 
-    /*TODO : INPUT FILE FORMAT */
+    auto end_build = clock::now();
+    spdlog::info("Build time (vector<Points>) : {} ns",
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end_build - start_build).count());
+
+    // same timeslices, back to back in one CSR batch
+    auto start_build_batch = clock::now();
+
+    PointsBatch cc_batch;
+    std::vector<preprocess::PrepStatus> cc_status;
+    preprocess::prep(std::span<const double>(eps_cc.data(), num_timesteps), cc, cc_batch, cc_status);
+
+    auto end_build_batch = clock::now();
+    spdlog::info("Build time (PointsBatch) : {} ns",
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end_build_batch - start_build_batch).count());
+
     /////////////////////////////////////////////////////////////////////////
     auto start_time = clock::now();
 
@@ -60,6 +98,61 @@ int main() {
     spdlog::info("Execution time2 : {} ns",
             std::chrono::duration_cast<std::chrono::nanoseconds>(end_time2 - start_time2).count());
 
+    geom::PolygonMatrix cc_matrix(timeslices);
+
+    auto start_time3 = clock::now();
+
+    std::vector<std::pair<double,double>> am_cc_batch = computeAreaAndMomentumTimeslicesBatch(cc_matrix);
+    auto end_time3 = clock::now();
+    spdlog::info("Execution time3 (batch) : {} ns",
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end_time3 - start_time3).count());
+
+    auto start_time4 = clock::now();
+
+    std::vector<std::pair<double,double>> am_cc_cuts = computeAreaAndMomentumCuts(eps_cc, cc);
+    auto end_time4 = clock::now();
+    spdlog::info("Execution time4 (fused trim) : {} ns",
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end_time4 - start_time4).count());
+
+    preprocess::CompiledCurve cc_compiled(cc);
+
+    auto start_time5 = clock::now();
+
+    std::vector<std::pair<double,double>> am_cc_compiled = computeAreaAndMomentumCuts(eps_cc, cc_compiled);
+    auto end_time5 = clock::now();
+    spdlog::info("Execution time5 (fused trim, compiled curve) : {} ns",
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end_time5 - start_time5).count());
+
+    auto start_time6 = clock::now();
+
+    std::vector<std::pair<double,double>> am_cc_csr = computeAreaAndMomentumTimeslices(cc_batch);
+    auto end_time6 = clock::now();
+    spdlog::info("Execution time6 (PointsBatch) : {} ns",
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end_time6 - start_time6).count());
+
+    // the whole curve as one polygon, split across threads (compare with SPLINE_REPRODUCIBLE=1)
+    auto start_time7 = clock::now();
+    std::pair<double,double> am_whole = geom::Shoelace::calculateAreaAndMomentumParallel(cc);
+    auto end_time7 = clock::now();
+    spdlog::info("Execution time7 (one polygon, {} vertices, parallel sum) : {} ns, area = {}",
+            cc.size(), std::chrono::duration_cast<std::chrono::nanoseconds>(end_time7 - start_time7).count(), am_whole.first);
+
+    // results streamed to a file given as second argument (.csv: text, otherwise column file)
+    if (argc > 2) {
+        auto start_write = clock::now();
+
+        storage::ResultWriter writer(storage::openResultSink(argv[2], {"m0", "m1"}), 2);
+        computeAreaAndMomentumCuts(eps_cc, cc_compiled, writer);
+        const bool written = writer.close();
+
+        auto end_write = clock::now();
+        spdlog::info("Write time ({}) : {} ns", argv[2],
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end_write - start_write).count());
+        if (!written) {
+            return 1;
+        }
+    }
+
     for (std::size_t t = 0; t < 30; ++t) {
         std::cout << "eps_cc[" << t << "] = " << eps_cc[t]
                 << ", m0cc = " << m0cc[t]
@@ -0,0 +1,53 @@
+#include "polygonmatrix.h"
+#include <algorithm>
+
+namespace geom {
+
+PolygonMatrix::PolygonMatrix(std::span<const Points> polygons)
+{
+    _fill(polygons);
+}
+
+PolygonMatrix::PolygonMatrix(std::span<const PointsView> polygons)
+{
+    _fill(polygons);
+}
+
+PolygonMatrix::PolygonMatrix(const PointsBatch& polygons)
+{
+    _fill(polygons);
+}
+
+template <class Polygons>
+void PolygonMatrix::_fill(const Polygons& polygons)
+{
+    num_polygons = polygons.size();
+
+    for (std::size_t p = 0; p < num_polygons; ++p) {
+        num_vertices = std::max(num_vertices, polygons[p].size());
+    }
+
+    column_stride = (num_polygons + lane_padding - 1) / lane_padding * lane_padding;
+
+    epsilon_data.assign(num_vertices * column_stride, 0.0);
+    sigma_data.assign(num_vertices * column_stride, 0.0);
+
+    for (std::size_t p = 0; p < num_polygons; ++p) {
+        const std::size_t n = polygons[p].size();
+        if (n < 3) {
+            continue; // Invalid polygon -> zero column
+        }
+
+        const auto& eps = polygons[p].get_epsilon();
+        const auto& sig = polygons[p].get_sigma();
+
+        for (std::size_t k = 0; k < num_vertices; ++k) {
+            // repeat the last vertex to pad the polygon
+            std::size_t src = std::min(k, n - 1);
+            epsilon_data[k * column_stride + p] = eps[src];
+            sigma_data[k * column_stride + p] = sig[src];
+        }
+    }
+}
+
+} // namespace geom
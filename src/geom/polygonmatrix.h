@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include "points/points.h"
+#include "points/pointsview.h"
+#include "points/pointsbatch.h"
+
+// Many polygons packed into one padded, column-major block (like _cc_pad in
+// resources.py, but transposed): vertex k of polygon p is stored at
+// k * stride() + p, so neighbouring polygons sit in neighbouring SIMD lanes.
+//
+// Shorter polygons are padded by repeating their last vertex. The extra edges
+// have zero length and leave area and momentum unchanged, also for polygons that
+// do not end on their start point. Polygons with fewer than 3 vertices are
+// stored as zeros and evaluate to 0, like in Shoelace.
+
+namespace geom {
+
+    class PolygonMatrix {
+    public:
+        // number of lanes the column count is padded to (widest supported vector)
+        static constexpr std::size_t lane_padding = 8;
+
+        PolygonMatrix() = default;
+
+        explicit PolygonMatrix(std::span<const Points> polygons);
+
+        explicit PolygonMatrix(std::span<const PointsView> polygons);
+
+        explicit PolygonMatrix(const PointsBatch& polygons);
+
+        // number of polygons
+        std::size_t size() const {
+            return num_polygons;
+        }
+
+        // padded number of vertices per polygon
+        std::size_t vertices() const {
+            return num_vertices;
+        }
+
+        // distance between two vertices of the same polygon
+        std::size_t stride() const {
+            return column_stride;
+        }
+
+        const double* epsilon() const {
+            return epsilon_data.data();
+        }
+
+        const double* sigma() const {
+            return sigma_data.data();
+        }
+
+    private:
+        // any indexable range of polygons
+        template <class Polygons>
+        void _fill(const Polygons& polygons);
+
+        std::size_t num_polygons = 0;
+        std::size_t num_vertices = 0;
+        std::size_t column_stride = 0;
+
+        std::vector<double> epsilon_data;
+        std::vector<double> sigma_data;
+    };
+
+}
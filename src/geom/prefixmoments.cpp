@@ -0,0 +1,183 @@
+#include "prefixmoments.h"
+#include <algorithm>
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+namespace geom {
+
+PrefixMoments::PrefixMoments(PointsView lm)
+    : PrefixMoments(preprocess::CompiledCurve(lm))
+{
+}
+
+PrefixMoments::PrefixMoments(const preprocess::CompiledCurve& compiled)
+    : curve(compiled)
+{
+    const auto& epsilon = curve.get_epsilon();
+    const auto& sigma = curve.get_sigma();
+    const std::size_t n = epsilon.size();
+
+    cross_sum.resize(n, 0.0);
+    momentum_sum.resize(n, 0.0);
+
+    // accumulate in the same order as Shoelace walks the polygon, so that the
+    // table reproduces calculateAreaAndMomentum(prep(...)) exactly
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        std::size_t j = i + 1;
+        double tmp_area = epsilon[i] * sigma[j] - epsilon[j] * sigma[i];
+
+        cross_sum[j] = cross_sum[i] + tmp_area;
+        momentum_sum[j] = momentum_sum[i] + (epsilon[i] + epsilon[j]) * tmp_area;
+    }
+}
+
+preprocess::PrepResult<AreaMomentumDerivative> PrefixMoments::_signed_sums(double eps_cut, unsigned parts) const
+{
+    AreaMomentumDerivative sums;
+
+    const auto& epsilon = curve.get_epsilon();
+    const auto& sigma = curve.get_sigma();
+
+    const std::size_t n = epsilon.size();
+    if (n < 2) {
+        return {sums, preprocess::PrepStatus::InvalidCurve};
+    }
+
+    // NaN fails both comparisons
+    if (!(eps_cut >= epsilon.front() && eps_cut <= epsilon.back())) {
+        return {sums, preprocess::PrepStatus::OutOfRange};
+    }
+
+    std::size_t k = curve.lower_bound(eps_cut);
+
+    // a cut on the first vertex gives a degenerate polygon; treating it as a cut in
+    // the first segment keeps the sums at exactly zero and gives the right-hand slope
+    k = std::max<std::size_t>(k, 1);
+
+    // intersection point, interpolated exactly like preprocess::_preprocess_polyline
+    double sig_cut;
+    if (epsilon[k] == eps_cut) {
+        sig_cut = sigma[k];
+    } else {
+        double t = (eps_cut - epsilon[k - 1]) / (epsilon[k] - epsilon[k - 1]);
+        sig_cut = sigma[k - 1] + t * (sigma[k] - sigma[k - 1]);
+    }
+
+    const double e_last = epsilon[k - 1];
+    const double s_last = sigma[k - 1];
+    const double e0 = epsilon[0];
+    const double s0 = sigma[0];
+
+    // closing edges v_{k-1} -> P -> Q -> v_0
+    const double c_lp = e_last * sig_cut - eps_cut * s_last;
+    const double c_pq = eps_cut * 0.0 - eps_cut * sig_cut;
+    const double c_q0 = eps_cut * s0 - e0 * 0.0;
+
+    if (parts & area_part) {
+        double area = cross_sum[k - 1];
+        area += c_lp;
+        area += c_pq;
+        area += c_q0;
+
+        // wrap-around edge v_0 -> v_0, kept so rounding matches the polygon walk
+        sums.area = area + e0 * s0 - e0 * s0;
+    }
+
+    if (parts & momentum_part) {
+        double momentum = momentum_sum[k - 1];
+        momentum += (e_last + eps_cut) * c_lp;
+        momentum += (eps_cut + eps_cut) * c_pq;
+        momentum += (eps_cut + e0) * c_q0;
+
+        sums.momentum = momentum;
+    }
+
+    if (parts & derivative_part) {
+        const double slope = curve.slope(k - 1);
+
+        const double dc_lp = e_last * slope - s_last;
+        const double dc_pq = -(sig_cut + eps_cut * slope);
+        const double dc_q0 = s0;
+
+        sums.darea = dc_lp + dc_pq + dc_q0;
+        sums.dmomentum = c_lp + (e_last + eps_cut) * dc_lp
+                       + 2.0 * c_pq + (eps_cut + eps_cut) * dc_pq
+                       + c_q0 + (eps_cut + e0) * dc_q0;
+    }
+
+    return {sums, preprocess::PrepStatus::Ok};
+}
+
+void PrefixMoments::_log(double eps_cut, preprocess::PrepStatus status) const
+{
+    if (status == preprocess::PrepStatus::InvalidCurve) {
+        spdlog::error("Interpolation failed: polyline contains fewer than 2 points.");
+    } else if (status == preprocess::PrepStatus::OutOfRange) {
+        spdlog::error("eps_cut={} is out of range [{}, {}].",
+                eps_cut, epsilon_front(), epsilon_back());
+    }
+}
+
+preprocess::PrepResult<double> PrefixMoments::tryArea(double eps_cut) const
+{
+    preprocess::PrepResult<AreaMomentumDerivative> sums = _signed_sums(eps_cut, area_part);
+    return {std::abs(sums.value.area) * 0.5, sums.status};
+}
+
+preprocess::PrepResult<double> PrefixMoments::tryMomentum(double eps_cut) const
+{
+    preprocess::PrepResult<AreaMomentumDerivative> sums = _signed_sums(eps_cut, momentum_part);
+    return {std::abs(sums.value.momentum) / 6.0, sums.status};
+}
+
+preprocess::PrepResult<std::pair<double,double>> PrefixMoments::tryAreaAndMomentum(double eps_cut) const
+{
+    preprocess::PrepResult<AreaMomentumDerivative> sums = _signed_sums(eps_cut, area_part | momentum_part);
+    return {std::make_pair(std::abs(sums.value.area) * 0.5, std::abs(sums.value.momentum) / 6.0), sums.status};
+}
+
+preprocess::PrepResult<AreaMomentumDerivative> PrefixMoments::tryAreaAndMomentumDerivative(double eps_cut) const
+{
+    preprocess::PrepResult<AreaMomentumDerivative> sums =
+        _signed_sums(eps_cut, area_part | momentum_part | derivative_part);
+    const AreaMomentumDerivative& signed_sums = sums.value;
+
+    // d|x| = sign(x) dx
+    AreaMomentumDerivative result;
+    result.area = std::abs(signed_sums.area) * 0.5;
+    result.momentum = std::abs(signed_sums.momentum) / 6.0;
+    result.darea = (signed_sums.area < 0.0 ? -signed_sums.darea : signed_sums.darea) * 0.5;
+    result.dmomentum = (signed_sums.momentum < 0.0 ? -signed_sums.dmomentum : signed_sums.dmomentum) / 6.0;
+
+    return {result, sums.status};
+}
+
+double PrefixMoments::calculateArea(double eps_cut) const
+{
+    preprocess::PrepResult<double> area = tryArea(eps_cut);
+    _log(eps_cut, area.status);
+    return area.value;
+}
+
+double PrefixMoments::calculateMomentum(double eps_cut) const
+{
+    preprocess::PrepResult<double> momentum = tryMomentum(eps_cut);
+    _log(eps_cut, momentum.status);
+    return momentum.value;
+}
+
+std::pair<double,double> PrefixMoments::calculateAreaAndMomentum(double eps_cut) const
+{
+    preprocess::PrepResult<std::pair<double,double>> sums = tryAreaAndMomentum(eps_cut);
+    _log(eps_cut, sums.status);
+    return sums.value;
+}
+
+AreaMomentumDerivative PrefixMoments::calculateAreaAndMomentumDerivative(double eps_cut) const
+{
+    preprocess::PrepResult<AreaMomentumDerivative> result = tryAreaAndMomentumDerivative(eps_cut);
+    _log(eps_cut, result.status);
+    return result.value;
+}
+
+} // namespace geom
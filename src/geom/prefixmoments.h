@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include "points/points.h"
+#include "geom/shoelace.h"
+#include "inputreader/compiledcurve.h"
+#include "inputreader/prepstatus.h"
+
+// Precomputed shoelace sums of a polyline (epsilon sorted ascending).
+//
+// For the trimmed polygon built by preprocess::prep(eps_cut, lm)
+//     v_0, ..., v_{k-1}, P = [eps_cut, sig(eps_cut)], Q = [eps_cut, 0], v_0
+// the shoelace sums split into the edges v_0 .. v_{k-1}, which only depend on k,
+// and the three closing edges v_{k-1} -> P -> Q -> v_0. The first part is stored
+// as a prefix sum, so area and momentum at any cut cost one binary search plus a
+// constant number of operations, and no polygon is built.
+
+namespace geom {
+
+    class PrefixMoments {
+    public:
+        PrefixMoments() = default;
+
+        explicit PrefixMoments(PointsView lm);
+
+        explicit PrefixMoments(const preprocess::CompiledCurve& curve);
+
+        std::size_t size() const {
+            return curve.size();
+        }
+
+        // strain range [front, back] in which cuts are valid
+        double epsilon_front() const {
+            return curve.epsilon_front();
+        }
+
+        double epsilon_back() const {
+            return curve.epsilon_back();
+        }
+
+        double calculateArea(double eps_cut) const;
+
+        double calculateMomentum(double eps_cut) const;
+
+        // Same result as Shoelace::calculateAreaAndMomentum(preprocess::prep(eps_cut, lm))
+        std::pair<double,double> calculateAreaAndMomentum(double eps_cut) const;
+
+        // area and momentum with their derivatives d/d(eps_cut), at the same cost
+        AreaMomentumDerivative calculateAreaAndMomentumDerivative(double eps_cut) const;
+
+        // The same without logging: a cut outside the polyline (or on one of fewer than
+        // 2 points) is reported through the status, for batches to count and report once
+        preprocess::PrepResult<double> tryArea(double eps_cut) const;
+
+        preprocess::PrepResult<double> tryMomentum(double eps_cut) const;
+
+        preprocess::PrepResult<std::pair<double,double>> tryAreaAndMomentum(double eps_cut) const;
+
+        preprocess::PrepResult<AreaMomentumDerivative> tryAreaAndMomentumDerivative(double eps_cut) const;
+
+    private:
+        // parts of _signed_sums to compute
+        static constexpr unsigned area_part       = 1u << 0;
+        static constexpr unsigned momentum_part   = 1u << 1;
+        static constexpr unsigned derivative_part = 1u << 2;
+
+        // signed sums of the trimmed polygon (before abs and scaling) and their derivatives,
+        // only the requested parts are computed; all zero if eps_cut is outside the polyline
+        preprocess::PrepResult<AreaMomentumDerivative> _signed_sums(double eps_cut, unsigned parts) const;
+
+        // logs the failure of a cut, for the functions without try_
+        void _log(double eps_cut, preprocess::PrepStatus status) const;
+
+        // breakpoint search and segment slopes
+        preprocess::CompiledCurve curve;
+
+        // cross_sum[k]    = sum_{i<k} eps[i] * sig[i+1] - eps[i+1] * sig[i]
+        // momentum_sum[k] = sum_{i<k} (eps[i] + eps[i+1]) * (eps[i] * sig[i+1] - eps[i+1] * sig[i])
+        std::vector<double> cross_sum;
+        std::vector<double> momentum_sum;
+    };
+
+}
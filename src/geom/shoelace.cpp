@@ -1,17 +1,71 @@
 #include "shoelace.h"
-#include <immintrin.h>
+#include <algorithm>
+#include <tuple>
+#include <spdlog/spdlog.h>
+#include "geom/simd/kernels.h"
+#include "points/polylinecut.h"
 
+namespace geom {
+
+// Signed chain sums over the edges [first, last) of (eps, sig), i.e. over the vertices first .. last
+static std::pair<double, double> chain_sums(const StridedSpan& eps, const StridedSpan& sig,
+                                            std::size_t first, std::size_t last) {
+    double area = 0.0;
+    double momentum = 0.0;
+
+    if (eps.contiguous() && sig.contiguous()) {
+        const simd::ShoelaceKernels& k = simd::kernels();
+        (reproducible() ? k.ordered_chain_sums : k.chain_sums)(eps.data() + first, sig.data() + first,
+                                                               last - first + 1, area, momentum);
+        return std::make_pair(area, momentum);
+    }
+
+    if (reproducible()) {
+        // the lanes of ordered_chain_sums, counted from first, so a strided view of
+        // a polygon gives the same bits as a contiguous one
+        double area_lane[simd::ordered_lanes] = {0.0, 0.0, 0.0, 0.0};
+        double momentum_lane[simd::ordered_lanes] = {0.0, 0.0, 0.0, 0.0};
 
+        simd::ordered_chain_tail(eps.subspan(first, last - first + 1), sig.subspan(first, last - first + 1),
+                                 0, last - first + 1, area_lane, momentum_lane);
+
+        return std::make_pair(simd::ordered_lane_sum(area_lane), simd::ordered_lane_sum(momentum_lane));
+    }
+
+    for (size_t i = first; i < last; ++i) {
+        size_t j = i + 1;
+        double tmp_area = eps[i] * sig[j] - eps[j] * sig[i];
+        area += tmp_area;
+
+        momentum += (eps[i] + eps[j]) * tmp_area;
+    }
 
-static inline double extractsum(__m256d vec) {
-    alignas(32) double tmp[4];
-    _mm256_store_pd(tmp, vec);
-    return tmp[0] + tmp[1] + tmp[2] + tmp[3];
+    return std::make_pair(area, momentum);
 }
 
-namespace geom {
+// Chain sums over the edges [0, edges), blocks in parallel, added in block order
+static std::pair<double, double> parallel_chain_sums(const StridedSpan& eps, const StridedSpan& sig,
+                                                     std::size_t edges, const ExecutionPolicy& policy) {
+    // fixed, equal blocks whatever the thread count, so the combine order is too
+    // (in reproducible mode parallelReduce fixes them itself)
+    ExecutionPolicy blocks = policy;
+    if (blocks.chunk_size == 0) {
+        blocks.chunk_size = Shoelace::parallel_block_edges;
+    }
+    if (blocks.schedule == ExecutionSchedule::Guided) {
+        blocks.schedule = ExecutionSchedule::Dynamic;
+    }
+
+    return parallelReduce(blocks, edges, std::make_pair(0.0, 0.0),
+        [&](std::size_t first, std::size_t last) {
+            return chain_sums(eps, sig, first, last);
+        },
+        [](const std::pair<double, double>& a, const std::pair<double, double>& b) {
+            return std::make_pair(a.first + b.first, a.second + b.second);
+        });
+}
 
-double Shoelace:: calculateArea(const Points& points) {
+double Shoelace:: calculateArea(PointsView points) {
     double area = 0.0;
     size_t n = points.size();
     if(n < 3) {
@@ -33,7 +87,7 @@ double Shoelace:: calculateArea(const Points& points) {
     return std::abs(area) * 0.5;
 }
 
-double Shoelace:: calculateMomentum(const Points& points) {
+double Shoelace:: calculateMomentum(PointsView points) {
     double momentum = 0.0;
     size_t n = points.size();
 
@@ -53,7 +107,7 @@ double Shoelace:: calculateMomentum(const Points& points) {
     return std::abs(momentum) / 6.0;
 }
 
-std::pair<double, double> Shoelace:: calculateAreaAndMomentum(const Points& points) {
+std::pair<double, double> Shoelace:: calculateAreaAndMomentum(PointsView points) {
     double area = 0.0;
     double momentum = 0.0;
     size_t n = points.size();
@@ -62,6 +116,10 @@ std::pair<double, double> Shoelace:: calculateAreaAndMomentum(const Points& poin
         return std::make_pair(0.0, 0.0); // Invalid input
     }
 
+    if (n >= parallel_threshold) {
+        return calculateAreaAndMomentumParallel(points);
+    }
+
     const auto& eps = points.get_epsilon();
     const auto& sig = points.get_sigma();
     
@@ -81,11 +139,8 @@ std::pair<double, double> Shoelace:: calculateAreaAndMomentum(const Points& poin
     return std::make_pair(area, momentum);
 }
 
-std :: pair<double, double> Shoelace:: calculateAreaAndMomentum_simd(const Points& points) {
-    double area = 0.0;
-    double momentum = 0.0;
+std::pair<double, double> Shoelace:: calculateAreaAndMomentumParallel(PointsView points, const ExecutionPolicy& policy) {
     size_t n = points.size();
-    size_t i =0;
 
     if(n < 3) {
         return std::make_pair(0.0, 0.0); // Invalid input
@@ -94,46 +149,219 @@ std :: pair<double, double> Shoelace:: calculateAreaAndMomentum_simd(const Point
     const auto& eps = points.get_epsilon();
     const auto& sig = points.get_sigma();
 
-    __m256d area_simd = _mm256_setzero_pd();
-    __m256d momentum_simd = _mm256_setzero_pd();
-    
-    for(i = 0; i + 5 < n; i += 4){
-        __m256d eps_i_simd = _mm256_loadu_pd(&eps[i]);
-        __m256d sig_i_simd = _mm256_loadu_pd(&sig[i]);
+    auto [area, momentum] = parallel_chain_sums(eps, sig, n - 1, policy);
 
-        __m256d eps_j_simd = _mm256_loadu_pd(&eps[i + 1]);
-        __m256d sig_j_simd = _mm256_loadu_pd(&sig[i + 1]);
+    area = area + eps[n - 1] * sig[0] - eps[0] * sig[n - 1];
 
-        __m256d term1 = _mm256_mul_pd(eps_i_simd, sig_j_simd);
-        __m256d term2 = _mm256_mul_pd(eps_j_simd, sig_i_simd);
-        __m256d term3 = _mm256_add_pd(eps_j_simd, eps_i_simd);
+    area = std::abs(area) * 0.5;
+    momentum = std::abs(momentum) / 6.0;
 
-        __m256d area_vec = _mm256_sub_pd(term1, term2);
+    return std::make_pair(area, momentum);
+}
 
-        area_simd = _mm256_add_pd(area_simd, area_vec);
+AreaMomentumDerivative Shoelace:: calculateAreaAndMomentumDerivative(PointsView polygon, double dsigma_cut) {
+    AreaMomentumDerivative result;
+    size_t n = polygon.size();
 
-        __m256d momentum_vec = _mm256_mul_pd(term3, area_vec);
-        momentum_simd = _mm256_add_pd(momentum_simd, momentum_vec);
+    if(n < 3) {
+        return result; // Invalid input
     }
-    
-    area += extractsum(area_simd);
-    momentum += extractsum(momentum_simd);
 
-    for (; i < n - 1; ++i) {
-        size_t j = i + 1; // Next vertex index, wrapping around
+    const auto& eps = polygon.get_epsilon();
+    const auto& sig = polygon.get_sigma();
+
+    // vertices that move with eps_cut: intersection point and its projection
+    const size_t cut = n - 3;
+    const size_t projection = n - 2;
+
+    auto deps = [&](size_t i) { return (i == cut || i == projection) ? 1.0 : 0.0; };
+    auto dsig = [&](size_t i) { return (i == cut) ? dsigma_cut : 0.0; };
+
+    double area = 0.0;
+    double momentum = 0.0;
+    double darea = 0.0;
+    double dmomentum = 0.0;
+
+    for (size_t i = 0; i < n - 1; ++i) {
+        size_t j = i + 1;
         double tmp_area = eps[i] * sig[j] - eps[j] * sig[i];
         area += tmp_area;
-
         momentum += (eps[i] + eps[j]) * tmp_area;
+
+        // only the edges touching the moving vertices contribute
+        if (j >= cut) {
+            double dtmp_area = deps(i) * sig[j] + eps[i] * dsig(j) - deps(j) * sig[i] - eps[j] * dsig(i);
+            darea += dtmp_area;
+            dmomentum += (deps(i) + deps(j)) * tmp_area + (eps[i] + eps[j]) * dtmp_area;
+        }
+    }
+
+    // closing edge (area only); it moves only if the intersection point is the first vertex
+    area = area + eps[n - 1] * sig[0] - eps[0] * sig[n - 1];
+    darea += deps(n - 1) * sig[0] + eps[n - 1] * dsig(0) - deps(0) * sig[n - 1] - eps[0] * dsig(n - 1);
+
+    // d|x| = sign(x) dx
+    result.area = std::abs(area) * 0.5;
+    result.momentum = std::abs(momentum) / 6.0;
+    result.darea = (area < 0.0 ? -darea : darea) * 0.5;
+    result.dmomentum = (momentum < 0.0 ? -dmomentum : dmomentum) / 6.0;
+
+    return result;
+}
+
+// Shoelace sums of v_0 .. v_{k-1}, [eps_cut, sig_cut], [eps_cut, 0], v_0 without building it
+static std::pair<double, double> trimmed_area_and_momentum(StridedSpan eps, StridedSpan sig,
+                                                           std::size_t k, double eps_cut, double sig_cut) {
+    double area = 0.0;
+    double momentum = 0.0;
+
+    // edges between the kept vertices v_0 .. v_{k-1}, same order as the polygon walk
+    if (k >= Shoelace::parallel_threshold) {
+        std::tie(area, momentum) = parallel_chain_sums(eps, sig, k - 1, defaultExecution());
+    } else {
+        for (size_t i = 0; i + 1 < k; ++i) {
+            size_t j = i + 1;
+            double tmp_area = eps[i] * sig[j] - eps[j] * sig[i];
+            area += tmp_area;
+
+            momentum += (eps[i] + eps[j]) * tmp_area;
+        }
     }
 
+    // closing vertices v_{k-1}, P = [eps_cut, sig_cut], Q = [eps_cut, 0], v_0
+    double tail_eps[4];
+    double tail_sig[4];
+    std::size_t m = 0;
+    if (k > 0) {
+        tail_eps[m] = eps[k - 1];
+        tail_sig[m] = sig[k - 1];
+        ++m;
+    }
+    tail_eps[m] = eps_cut; tail_sig[m] = sig_cut; ++m;
+    tail_eps[m] = eps_cut; tail_sig[m] = 0.0;     ++m;
+    tail_eps[m] = eps[0];  tail_sig[m] = sig[0];  ++m;
+
+    for (size_t i = 0; i + 1 < m; ++i) {
+        size_t j = i + 1;
+        double tmp_area = tail_eps[i] * tail_sig[j] - tail_eps[j] * tail_sig[i];
+        area += tmp_area;
+
+        momentum += (tail_eps[i] + tail_eps[j]) * tmp_area;
+    }
+
+    // wrap-around edge from the last vertex (v_0) to the first one (v_0, or P if k == 0)
+    const double first_eps = (k > 0) ? eps[0] : eps_cut;
+    const double first_sig = (k > 0) ? sig[0] : sig_cut;
+    area = area + eps[0] * first_sig - first_eps * sig[0];
+
+    area = std::abs(area) * 0.5;
+    momentum = std::abs(momentum) / 6.0;
+
+    return std::make_pair(area, momentum);
+}
+
+preprocess::PrepResult<std::pair<double,double>> Shoelace:: tryTrimmedAreaAndMomentum(double eps_cut, PointsView lm) {
+    preprocess::PrepResult<PolylineCut> cut = locateCut(eps_cut, lm);
+
+    if (!cut) {
+        return {std::make_pair(0.0, 0.0), cut.status};
+    }
+
+    return {trimmed_area_and_momentum(lm.get_epsilon(), lm.get_sigma(), cut.value.idx, eps_cut, cut.value.sigma),
+            preprocess::PrepStatus::Ok};
+}
+
+preprocess::PrepResult<std::pair<double,double>> Shoelace:: tryTrimmedAreaAndMomentum(double eps_cut, const preprocess::CompiledCurve& curve) {
+    preprocess::PrepResult<preprocess::CutPoint> cut = curve.try_locate(eps_cut);
+
+    if (!cut) {
+        return {std::make_pair(0.0, 0.0), cut.status};
+    }
+
+    return {trimmed_area_and_momentum(curve.get_epsilon(), curve.get_sigma(), cut.value.idx, eps_cut, cut.value.sigma),
+            preprocess::PrepStatus::Ok};
+}
+
+std::pair<double, double> Shoelace:: calculateTrimmedAreaAndMomentum(double eps_cut, PointsView lm) {
+    preprocess::PrepResult<std::pair<double,double>> result = tryTrimmedAreaAndMomentum(eps_cut, lm);
+
+    if (!result) {
+        spdlog::error("Preprocessing failed: could not compute intersection point (eps_cut={}: {}).",
+                eps_cut, preprocess::statusName(result.status));
+    }
+
+    return result.value;
+}
+
+std::pair<double, double> Shoelace:: calculateTrimmedAreaAndMomentum(double eps_cut, const preprocess::CompiledCurve& curve) {
+    preprocess::PrepResult<std::pair<double,double>> result = tryTrimmedAreaAndMomentum(eps_cut, curve);
+
+    if (!result) {
+        spdlog::error("Preprocessing failed: could not compute intersection point (eps_cut={}: {}).",
+                eps_cut, preprocess::statusName(result.status));
+    }
+
+    return result.value;
+}
+
+std :: pair<double, double> Shoelace:: calculateAreaAndMomentum_simd(PointsView points) {
+    double area = 0.0;
+    double momentum = 0.0;
+    size_t n = points.size();
+
+    if(n < 3) {
+        return std::make_pair(0.0, 0.0); // Invalid input
+    }
+
+    // the kernels read contiguous arrays
+    if (!points.contiguous()) {
+        return calculateAreaAndMomentum(points);
+    }
+
+    if (n >= parallel_threshold) {
+        return calculateAreaAndMomentumParallel(points);
+    }
+
+    const auto& eps = points.get_epsilon();
+    const auto& sig = points.get_sigma();
+
+    // kernel of the instruction set selected at load time (geom/simd/isa.h), or the
+    // ordered one that gives the same bits on every level
+    const simd::ShoelaceKernels& k = simd::kernels();
+    (reproducible() ? k.ordered_chain_sums : k.chain_sums)(eps.data(), sig.data(), n, area, momentum);
+
     area = area +  eps[n - 1] * sig[0] - eps[0] * sig[n - 1];
 
-    
     area = std::abs(area) * 0.5;
     momentum = std::abs(momentum) / 6.0;
 
     return std::make_pair(area, momentum);
 }
 
-} // namespace geom
\ No newline at end of file
+void Shoelace:: calculateAreaAndMomentumBatch(const PolygonMatrix& polygons,
+                                              std::size_t first, std::size_t last,
+                                              std::span<double> area, std::span<double> momentum)
+{
+    const std::size_t n = polygons.vertices();
+
+    last = std::min(last, polygons.size());
+
+    if (n < 3) {
+        for (std::size_t p = first; p < last; ++p) {
+            area[p] = 0.0;
+            momentum[p] = 0.0;
+        }
+        return;
+    }
+
+    simd::kernels().batch(polygons.epsilon(), polygons.sigma(), n, polygons.stride(),
+                          first, last, area.data(), momentum.data());
+}
+
+void Shoelace:: calculateAreaAndMomentumBatch(const PolygonMatrix& polygons,
+                                              std::span<double> area, std::span<double> momentum)
+{
+    calculateAreaAndMomentumBatch(polygons, 0, polygons.size(), area, momentum);
+}
+
+} // namespace geom
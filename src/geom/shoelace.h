@@ -2,19 +2,78 @@
 
 #include <vector>
 #include <cmath>
+#include <span>
 #include "points/points.h"
+#include "points/pointsview.h"
+#include "geom/polygonmatrix.h"
+#include "inputreader/compiledcurve.h"
+#include "inputreader/prepstatus.h"
+#include "parallel/execution.h"
 
 namespace geom {
 
+    // area and momentum of a trimmed polygon with their derivatives d/d(eps_cut)
+    struct AreaMomentumDerivative {
+        double area      = 0.0;
+        double momentum  = 0.0;
+        double darea     = 0.0;
+        double dmomentum = 0.0;
+    };
+
     class Shoelace {
     public:
-        static double calculateArea(const Points& points);
+        static double calculateArea(PointsView points);
+
+        static double calculateMomentum(PointsView points);
+
+        static std::pair<double,double> calculateAreaAndMomentum(PointsView points);
+
+        static std::pair<double,double> calculateAreaAndMomentum_simd(PointsView points);
+
+        // Area and momentum of one polygon, with its edges split across threads. The edges
+        // are cut into blocks of policy.chunk_size (parallel_block_edges if 0); each block is
+        // summed by the SIMD chain kernel over its vertices first .. last, so consecutive
+        // blocks share a vertex and the seam edge between them is summed exactly once.
+        // The block sums are added in block order: the result depends on the block size
+        // only, not on the backend or the number of threads, but may differ from the
+        // sequential sum in the last bits. In reproducible mode (parallel/execution.h) the
+        // block size is fixed and the blocks use the ordered kernel, so it depends on
+        // nothing but the vertices.
+        static std::pair<double,double> calculateAreaAndMomentumParallel(PointsView points,
+                                                                         const ExecutionPolicy& policy = defaultExecution());
+
+        // calculateAreaAndMomentum, calculateAreaAndMomentum_simd and the trimmed versions
+        // switch to the parallel sum from this many vertices on
+        static constexpr std::size_t parallel_threshold = std::size_t(1) << 20;
+
+        static constexpr std::size_t parallel_block_edges = std::size_t(1) << 16;
+
+        // Area and momentum of a polygon built by preprocess::prep(eps_cut, lm), together with
+        // their derivatives with respect to eps_cut, in one pass. Only the intersection point
+        // [eps_cut, sigma(eps_cut)] and its projection [eps_cut, 0] move with eps_cut;
+        // dsigma_cut is d sigma / d eps_cut at the cut (see preprocess::_preprocess_polyline_derivative).
+        static AreaMomentumDerivative calculateAreaAndMomentumDerivative(PointsView polygon, double dsigma_cut);
+
+        // Same result as calculateAreaAndMomentum(preprocess::prep(eps_cut, lm)), without
+        // building the trimmed polygon: the vertices of lm below eps_cut are streamed and the
+        // closing vertices [eps_cut, sigma(eps_cut)], [eps_cut, 0] and lm[0] are added on the fly.
+        static std::pair<double,double> calculateTrimmedAreaAndMomentum(double eps_cut, PointsView lm);
+
+        static std::pair<double,double> calculateTrimmedAreaAndMomentum(double eps_cut, const preprocess::CompiledCurve& curve);
+
+        // Same without logging; a failed cut gives (0, 0) and its status
+        static preprocess::PrepResult<std::pair<double,double>> tryTrimmedAreaAndMomentum(double eps_cut, PointsView lm);
 
-        static double calculateMomentum(const Points& points);
+        static preprocess::PrepResult<std::pair<double,double>> tryTrimmedAreaAndMomentum(double eps_cut, const preprocess::CompiledCurve& curve);
 
-        static std::pair<double,double> calculateAreaAndMomentum(const Points& points);
+        // Area and momentum of polygons [first, last) of a padded polygon matrix,
+        // one polygon per SIMD lane. Results are written to area[p] and momentum[p].
+        static void calculateAreaAndMomentumBatch(const PolygonMatrix& polygons,
+                                                  std::size_t first, std::size_t last,
+                                                  std::span<double> area, std::span<double> momentum);
 
-        static std::pair<double,double> calculateAreaAndMomentum_simd(const Points& points);
+        static void calculateAreaAndMomentumBatch(const PolygonMatrix& polygons,
+                                                  std::span<double> area, std::span<double> momentum);
 
     };
 
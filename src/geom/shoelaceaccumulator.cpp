@@ -0,0 +1,115 @@
+#include "shoelaceaccumulator.h"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace geom {
+
+void ShoelaceAccumulator:: add(double eps, double sig) {
+    if (count == 0) {
+        first_eps = eps;
+        first_sig = sig;
+    } else {
+        // edge from the last vertex, which may be the end of the previous chunk
+        double tmp_area = last_eps * sig - eps * last_sig;
+        area += tmp_area;
+
+        momentum += (last_eps + eps) * tmp_area;
+    }
+
+    last_eps = eps;
+    last_sig = sig;
+    ++count;
+}
+
+void ShoelaceAccumulator:: add(std::span<const double> eps, std::span<const double> sig) {
+    const std::size_t n = std::min(eps.size(), sig.size());
+    if (n == 0) {
+        return;
+    }
+
+    add(eps[0], sig[0]);
+
+    // edges inside the chunk, with the running sums in registers
+    double chunk_area = area;
+    double chunk_momentum = momentum;
+
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        std::size_t j = i + 1;
+        double tmp_area = eps[i] * sig[j] - eps[j] * sig[i];
+        chunk_area += tmp_area;
+
+        chunk_momentum += (eps[i] + eps[j]) * tmp_area;
+    }
+
+    area = chunk_area;
+    momentum = chunk_momentum;
+
+    last_eps = eps[n - 1];
+    last_sig = sig[n - 1];
+    count += n - 1;
+}
+
+void ShoelaceAccumulator:: add(PointsView chunk) {
+    const std::size_t n = chunk.size();
+    if (chunk.contiguous()) {
+        add(std::span<const double>(chunk.get_epsilon().data(), n),
+            std::span<const double>(chunk.get_sigma().data(), n));
+        return;
+    }
+
+    const auto& eps = chunk.get_epsilon();
+    const auto& sig = chunk.get_sigma();
+    for (std::size_t i = 0; i < n; ++i) {
+        add(eps[i], sig[i]);
+    }
+}
+
+std::pair<double, double> ShoelaceAccumulator:: finalize() const {
+    if (count < 3) {
+        return std::make_pair(0.0, 0.0); // Invalid input
+    }
+
+    // closing edge (area only), as in Shoelace::calculateAreaAndMomentum
+    double closed_area = area + last_eps * first_sig - first_eps * last_sig;
+
+    return std::make_pair(std::abs(closed_area) * 0.5, std::abs(momentum) / 6.0);
+}
+
+void ShoelaceAccumulator:: reset() {
+    *this = ShoelaceAccumulator();
+}
+
+std::pair<double, double> accumulateAreaAndMomentum(VertexGenerator vertices, std::size_t chunk_size) {
+    chunk_size = std::max<std::size_t>(chunk_size, 1);
+
+    std::vector<double> eps(chunk_size);
+    std::vector<double> sig(chunk_size);
+    ShoelaceAccumulator accumulator;
+
+    while (std::size_t n = vertices(std::span<double>(eps), std::span<double>(sig))) {
+        n = std::min(n, chunk_size);
+        accumulator.add(std::span<const double>(eps.data(), n), std::span<const double>(sig.data(), n));
+    }
+
+    return accumulator.finalize();
+}
+
+std::pair<double, double> accumulateAreaAndMomentum(const std::string& path, const preprocess::CsvOptions& options) {
+    ShoelaceAccumulator accumulator;
+
+    preprocess::CsvStreamResult result = preprocess::streamCsv(path, 2, 0,
+        [&](const std::vector<std::vector<double>>& columns, std::size_t rows) {
+            accumulator.add(std::span<const double>(columns[0].data(), rows),
+                            std::span<const double>(columns[1].data(), rows));
+            return true;
+        }, options);
+
+    if (!result.ok) {
+        return std::make_pair(0.0, 0.0);
+    }
+    return accumulator.finalize();
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include "points/pointsview.h"
+#include "inputreader/csvreader.h"
+
+// Shoelace sums of a polygon whose vertices arrive in chunks.
+//
+// Shoelace needs the whole polygon in memory. The accumulator instead takes the
+// vertices in order, any number at a time, and keeps only the running sums, the
+// first vertex (for the closing edge) and the last one (for the edge to the next
+// chunk), so memory is O(1) however many vertices there are. The edges are summed
+// one by one in polygon order, so the result does not depend on how the vertices
+// were split into chunks, and for fewer than Shoelace::parallel_threshold vertices
+// it is exactly Shoelace::calculateAreaAndMomentum of the whole polygon.
+//
+// Curves larger than memory or coming from an acquisition stream can thus be
+// integrated in one pass, e.g. with accumulateAreaAndMomentum below.
+
+namespace geom {
+
+    class ShoelaceAccumulator {
+    public:
+        void add(double eps, double sig);
+
+        // vertices eps[i], sig[i] in order; eps and sig have the same size
+        void add(std::span<const double> eps, std::span<const double> sig);
+
+        void add(PointsView chunk);
+
+        std::size_t vertices() const {
+            return count;
+        }
+
+        // Area and momentum of the polygon closed from the last vertex back to the first
+        // one, (0, 0) below 3 vertices. More vertices can still be added afterwards.
+        std::pair<double,double> finalize() const;
+
+        void reset();
+
+    private:
+        double area = 0.0;
+        double momentum = 0.0;
+
+        double first_eps = 0.0;
+        double first_sig = 0.0;
+        double last_eps = 0.0;
+        double last_sig = 0.0;
+        std::size_t count = 0;
+    };
+
+    // Fills eps and sig (same size) with the next vertices and returns how many it
+    // wrote (at most eps.size()); 0 ends the polygon
+    using VertexGenerator = std::function<std::size_t(std::span<double> eps, std::span<double> sig)>;
+
+    // area and momentum of the polygon the generator produces, chunk_size vertices at a time
+    std::pair<double,double> accumulateAreaAndMomentum(VertexGenerator vertices, std::size_t chunk_size = 1 << 14);
+
+    // Area and momentum of the curve (epsilon, sigma) of a CSV file as a closed polygon,
+    // read chunk by chunk (preprocess::streamCsv); (0, 0) and a logged error on failure
+    std::pair<double,double> accumulateAreaAndMomentum(const std::string& path,
+                                                       const preprocess::CsvOptions& options = preprocess::CsvOptions());
+
+}
@@ -0,0 +1,133 @@
+#include "geom/simd/isa.h"
+#include "geom/simd/kernels.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+
+namespace geom::simd {
+
+static const ShoelaceKernels* table(Isa isa)
+{
+    switch (isa) {
+        case Isa::AVX512: return avx512_kernels();
+        case Isa::AVX2:   return avx2_kernels();
+        case Isa::SSE2:   return sse2_kernels();
+        case Isa::Scalar: return scalar_kernels();
+    }
+    return scalar_kernels();
+}
+
+static bool cpu_supports(Isa isa)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    switch (isa) {
+        case Isa::AVX512: return __builtin_cpu_supports("avx512f");
+        case Isa::AVX2:   return __builtin_cpu_supports("avx2");
+        case Isa::SSE2:   return __builtin_cpu_supports("sse2");
+        case Isa::Scalar: return true;
+    }
+    return false;
+#else
+    return isa == Isa::Scalar;
+#endif
+}
+
+static bool supported(Isa isa)
+{
+    return table(isa) != nullptr && cpu_supports(isa);
+}
+
+Isa detectIsa()
+{
+    for (Isa isa : {Isa::AVX512, Isa::AVX2, Isa::SSE2}) {
+        if (supported(isa)) {
+            return isa;
+        }
+    }
+    return Isa::Scalar;
+}
+
+// level chosen at load time: SPLINE_ISA if set and supported, else the best one
+static Isa initial_isa()
+{
+    Isa best = detectIsa();
+
+    const char* env = std::getenv("SPLINE_ISA");
+    if (env == nullptr) {
+        return best;
+    }
+
+    Isa forced;
+    if (!parseIsa(env, forced)) {
+        spdlog::warn("SPLINE_ISA={} is unknown, using {}", env, isaName(best));
+        return best;
+    }
+    if (!supported(forced)) {
+        spdlog::warn("SPLINE_ISA={} is not supported on this CPU, using {}", env, isaName(best));
+        return best;
+    }
+    return forced;
+}
+
+static std::atomic<Isa>& current_isa()
+{
+    static std::atomic<Isa> isa{initial_isa()};
+    return isa;
+}
+
+static std::atomic<const ShoelaceKernels*>& current_kernels()
+{
+    static std::atomic<const ShoelaceKernels*> kernels{table(current_isa().load())};
+    return kernels;
+}
+
+// select the kernels when the library is loaded, not on the first call
+[[maybe_unused]] static const bool selected_at_load = (current_kernels(), true);
+
+Isa activeIsa()
+{
+    return current_isa().load(std::memory_order_relaxed);
+}
+
+bool setIsa(Isa isa)
+{
+    if (!supported(isa)) {
+        spdlog::warn("setIsa: {} is not supported on this CPU, keeping {}",
+                isaName(isa), isaName(activeIsa()));
+        return false;
+    }
+    current_isa().store(isa);
+    current_kernels().store(table(isa));
+    return true;
+}
+
+const ShoelaceKernels& kernels()
+{
+    return *current_kernels().load(std::memory_order_relaxed);
+}
+
+const char* isaName(Isa isa)
+{
+    switch (isa) {
+        case Isa::AVX512: return "avx512";
+        case Isa::AVX2:   return "avx2";
+        case Isa::SSE2:   return "sse2";
+        case Isa::Scalar: return "scalar";
+    }
+    return "unknown";
+}
+
+bool parseIsa(const std::string& name, Isa& isa)
+{
+    for (Isa candidate : {Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::AVX512}) {
+        if (name == isaName(candidate)) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace geom::simd
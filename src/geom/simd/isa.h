@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+
+// Runtime selection of the instruction set used by the Shoelace kernels.
+//
+// The library is built for the baseline architecture; the kernels in
+// geom/simd/kernels_*.cpp are additionally compiled for SSE2, AVX2 and AVX-512.
+// The best level supported by the CPU is picked once when the library is loaded.
+// It can be forced with the environment variable SPLINE_ISA
+// (scalar, sse2, avx2, avx512) or with setIsa(), e.g. for benchmarking.
+
+namespace geom::simd {
+
+    enum class Isa {
+        Scalar = 0,
+        SSE2   = 1,
+        AVX2   = 2,
+        AVX512 = 3
+    };
+
+    // best level supported by this CPU and this build
+    Isa detectIsa();
+
+    // level currently used by the kernels
+    Isa activeIsa();
+
+    // force a level, returns false (and keeps the current one) if it is not supported
+    bool setIsa(Isa isa);
+
+    const char* isaName(Isa isa);
+
+    // parse "scalar", "sse2", "avx2" or "avx512", returns false for unknown names
+    bool parseIsa(const std::string& name, Isa& isa);
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+
+// Kernel table of the Shoelace routines, one instance per instruction set.
+//
+// Each kernels_*.cpp is compiled with its own -m flags. Those translation units
+// must only include this header and <immintrin.h>: any inline function they pull
+// in from other headers could be emitted with wide instructions and be picked by
+// the linker for the whole library. Helpers shared between them are therefore
+// static (internal linkage), and use compiler builtins (__builtin_fabs) rather
+// than functions of <cmath>.
+
+namespace geom::simd {
+
+    struct ShoelaceKernels {
+        // signed sums over the open chain v_0 -> ... -> v_{n-1} (no closing edge), n >= 2
+        //   area     = sum eps[i] * sig[i+1] - eps[i+1] * sig[i]
+        //   momentum = sum (eps[i] + eps[i+1]) * (eps[i] * sig[i+1] - eps[i+1] * sig[i])
+        void (*chain_sums)(const double* eps, const double* sig, std::size_t n,
+                           double& area, double& momentum);
+
+        // same sums in a fixed order that every level reproduces bit for bit: edge i goes
+        // to lane i % 4, and the lanes are added as (lane_0 + lane_1) + (lane_2 + lane_3).
+        // chain_sums adds in the order that suits its own vector width instead.
+        void (*ordered_chain_sums)(const double* eps, const double* sig, std::size_t n,
+                                   double& area, double& momentum);
+
+        // area and momentum of polygons [first, last) of a padded column-major matrix
+        // (vertex k of polygon p at k * stride + p), n >= 3
+        void (*batch)(const double* eps, const double* sig, std::size_t n, std::size_t stride,
+                      std::size_t first, std::size_t last, double* area, double* momentum);
+    };
+
+    // nullptr if the build has no kernels for this level
+    const ShoelaceKernels* scalar_kernels();
+    const ShoelaceKernels* sse2_kernels();
+    const ShoelaceKernels* avx2_kernels();
+    const ShoelaceKernels* avx512_kernels();
+
+    // kernels of the active level
+    const ShoelaceKernels& kernels();
+
+    inline constexpr std::size_t ordered_lanes = 4;
+
+    // Edges first .. n-2 of ordered_chain_sums into their lanes, for the scalar
+    // kernel and the remainders of the vector ones (first a multiple of 4).
+    // Values is a pointer or a StridedSpan (strided views in reproducible mode).
+    template <class Values>
+    static inline void ordered_chain_tail(const Values& eps, const Values& sig,
+                                          std::size_t first, std::size_t n,
+                                          double* area_lane, double* momentum_lane)
+    {
+        for (std::size_t i = first; i + 1 < n; ++i) {
+            std::size_t j = i + 1;
+            double tmp_area = eps[i] * sig[j] - eps[j] * sig[i];
+            area_lane[i % ordered_lanes] += tmp_area;
+
+            momentum_lane[i % ordered_lanes] += (eps[i] + eps[j]) * tmp_area;
+        }
+    }
+
+    static inline double ordered_lane_sum(const double* lane)
+    {
+        return (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    }
+
+    // Area and momentum of one column of a polygon matrix, in polygon order
+    static inline void column_area_momentum(const double* eps, const double* sig,
+                                            std::size_t n, std::size_t stride, std::size_t p,
+                                            double& area_out, double& momentum_out)
+    {
+        double area = 0.0;
+        double momentum = 0.0;
+
+        for (std::size_t k = 0; k + 1 < n; ++k) {
+            std::size_t i = k * stride + p;
+            std::size_t j = i + stride;
+            double tmp_area = eps[i] * sig[j] - eps[j] * sig[i];
+            area += tmp_area;
+
+            momentum += (eps[i] + eps[j]) * tmp_area;
+        }
+
+        std::size_t last = (n - 1) * stride + p;
+        area = area + eps[last] * sig[p] - eps[p] * sig[last];
+
+        area_out = __builtin_fabs(area) * 0.5;
+        momentum_out = __builtin_fabs(momentum) / 6.0;
+    }
+
+}
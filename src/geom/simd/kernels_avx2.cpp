@@ -0,0 +1,159 @@
+#include "geom/simd/kernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace geom::simd {
+
+static inline double extractsum(__m256d vec) {
+    alignas(32) double tmp[4];
+    _mm256_store_pd(tmp, vec);
+    return tmp[0] + tmp[1] + tmp[2] + tmp[3];
+}
+
+static void chain_sums(const double* eps, const double* sig, std::size_t n,
+                       double& area, double& momentum)
+{
+    __m256d area_simd = _mm256_setzero_pd();
+    __m256d momentum_simd = _mm256_setzero_pd();
+
+    std::size_t i = 0;
+    for (; i + 4 < n; i += 4) {
+        __m256d eps_i_simd = _mm256_loadu_pd(&eps[i]);
+        __m256d sig_i_simd = _mm256_loadu_pd(&sig[i]);
+
+        __m256d eps_j_simd = _mm256_loadu_pd(&eps[i + 1]);
+        __m256d sig_j_simd = _mm256_loadu_pd(&sig[i + 1]);
+
+        __m256d term1 = _mm256_mul_pd(eps_i_simd, sig_j_simd);
+        __m256d term2 = _mm256_mul_pd(eps_j_simd, sig_i_simd);
+        __m256d term3 = _mm256_add_pd(eps_j_simd, eps_i_simd);
+
+        __m256d area_vec = _mm256_sub_pd(term1, term2);
+        area_simd = _mm256_add_pd(area_simd, area_vec);
+
+        __m256d momentum_vec = _mm256_mul_pd(term3, area_vec);
+        momentum_simd = _mm256_add_pd(momentum_simd, momentum_vec);
+    }
+
+    area = extractsum(area_simd);
+    momentum = extractsum(momentum_simd);
+
+    for (; i + 1 < n; ++i) {
+        std::size_t j = i + 1;
+        double tmp_area = eps[i] * sig[j] - eps[j] * sig[i];
+        area += tmp_area;
+
+        momentum += (eps[i] + eps[j]) * tmp_area;
+    }
+}
+
+static void ordered_chain_sums(const double* eps, const double* sig, std::size_t n,
+                               double& area, double& momentum)
+{
+    __m256d area_simd = _mm256_setzero_pd();
+    __m256d momentum_simd = _mm256_setzero_pd();
+
+    // one vector of 4 lanes: edge i in lane i % 4
+    std::size_t i = 0;
+    for (; i + 4 < n; i += 4) {
+        __m256d eps_i_simd = _mm256_loadu_pd(&eps[i]);
+        __m256d sig_i_simd = _mm256_loadu_pd(&sig[i]);
+
+        __m256d eps_j_simd = _mm256_loadu_pd(&eps[i + 1]);
+        __m256d sig_j_simd = _mm256_loadu_pd(&sig[i + 1]);
+
+        __m256d area_vec = _mm256_sub_pd(_mm256_mul_pd(eps_i_simd, sig_j_simd),
+                                         _mm256_mul_pd(eps_j_simd, sig_i_simd));
+        area_simd = _mm256_add_pd(area_simd, area_vec);
+
+        __m256d momentum_vec = _mm256_mul_pd(_mm256_add_pd(eps_i_simd, eps_j_simd), area_vec);
+        momentum_simd = _mm256_add_pd(momentum_simd, momentum_vec);
+    }
+
+    alignas(32) double area_lane[ordered_lanes];
+    alignas(32) double momentum_lane[ordered_lanes];
+    _mm256_store_pd(area_lane, area_simd);
+    _mm256_store_pd(momentum_lane, momentum_simd);
+
+    ordered_chain_tail(eps, sig, i, n, area_lane, momentum_lane);
+
+    area = ordered_lane_sum(area_lane);
+    momentum = ordered_lane_sum(momentum_lane);
+}
+
+static void batch(const double* eps, const double* sig, std::size_t n, std::size_t stride,
+                  std::size_t first, std::size_t last, double* area, double* momentum)
+{
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d six = _mm256_set1_pd(6.0);
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+
+    std::size_t p = first;
+
+    // 4 polygons per iteration, walking all of their edges at once
+    for (; p + 4 <= last; p += 4) {
+        __m256d area_simd = _mm256_setzero_pd();
+        __m256d momentum_simd = _mm256_setzero_pd();
+
+        __m256d eps_i_simd = _mm256_loadu_pd(&eps[p]);
+        __m256d sig_i_simd = _mm256_loadu_pd(&sig[p]);
+
+        for (std::size_t k = 1; k < n; ++k) {
+            __m256d eps_j_simd = _mm256_loadu_pd(&eps[k * stride + p]);
+            __m256d sig_j_simd = _mm256_loadu_pd(&sig[k * stride + p]);
+
+            __m256d term1 = _mm256_mul_pd(eps_i_simd, sig_j_simd);
+            __m256d term2 = _mm256_mul_pd(eps_j_simd, sig_i_simd);
+            __m256d term3 = _mm256_add_pd(eps_i_simd, eps_j_simd);
+
+            __m256d area_vec = _mm256_sub_pd(term1, term2);
+            area_simd = _mm256_add_pd(area_simd, area_vec);
+
+            __m256d momentum_vec = _mm256_mul_pd(term3, area_vec);
+            momentum_simd = _mm256_add_pd(momentum_simd, momentum_vec);
+
+            eps_i_simd = eps_j_simd;
+            sig_i_simd = sig_j_simd;
+        }
+
+        // closing edge v_{n-1} -> v_0 (area only, like calculateAreaAndMomentum)
+        __m256d eps_0_simd = _mm256_loadu_pd(&eps[p]);
+        __m256d sig_0_simd = _mm256_loadu_pd(&sig[p]);
+        area_simd = _mm256_add_pd(area_simd, _mm256_mul_pd(eps_i_simd, sig_0_simd));
+        area_simd = _mm256_sub_pd(area_simd, _mm256_mul_pd(eps_0_simd, sig_i_simd));
+
+        // abs() by clearing the sign bit
+        area_simd = _mm256_mul_pd(_mm256_andnot_pd(sign_mask, area_simd), half);
+        momentum_simd = _mm256_div_pd(_mm256_andnot_pd(sign_mask, momentum_simd), six);
+
+        _mm256_storeu_pd(&area[p], area_simd);
+        _mm256_storeu_pd(&momentum[p], momentum_simd);
+    }
+
+    // remaining polygons one by one
+    for (; p < last; ++p) {
+        column_area_momentum(eps, sig, n, stride, p, area[p], momentum[p]);
+    }
+}
+
+const ShoelaceKernels* avx2_kernels()
+{
+    static const ShoelaceKernels table{chain_sums, ordered_chain_sums, batch};
+    return &table;
+}
+
+} // namespace geom::simd
+
+#else
+
+namespace geom::simd {
+
+const ShoelaceKernels* avx2_kernels()
+{
+    return nullptr;
+}
+
+} // namespace geom::simd
+
+#endif
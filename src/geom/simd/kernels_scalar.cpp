@@ -0,0 +1,46 @@
+#include "geom/simd/kernels.h"
+
+namespace geom::simd {
+
+static void chain_sums(const double* eps, const double* sig, std::size_t n,
+                       double& area, double& momentum)
+{
+    area = 0.0;
+    momentum = 0.0;
+
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        std::size_t j = i + 1;
+        double tmp_area = eps[i] * sig[j] - eps[j] * sig[i];
+        area += tmp_area;
+
+        momentum += (eps[i] + eps[j]) * tmp_area;
+    }
+}
+
+static void ordered_chain_sums(const double* eps, const double* sig, std::size_t n,
+                               double& area, double& momentum)
+{
+    double area_lane[ordered_lanes] = {0.0, 0.0, 0.0, 0.0};
+    double momentum_lane[ordered_lanes] = {0.0, 0.0, 0.0, 0.0};
+
+    ordered_chain_tail(eps, sig, 0, n, area_lane, momentum_lane);
+
+    area = ordered_lane_sum(area_lane);
+    momentum = ordered_lane_sum(momentum_lane);
+}
+
+static void batch(const double* eps, const double* sig, std::size_t n, std::size_t stride,
+                  std::size_t first, std::size_t last, double* area, double* momentum)
+{
+    for (std::size_t p = first; p < last; ++p) {
+        column_area_momentum(eps, sig, n, stride, p, area[p], momentum[p]);
+    }
+}
+
+const ShoelaceKernels* scalar_kernels()
+{
+    static const ShoelaceKernels table{chain_sums, ordered_chain_sums, batch};
+    return &table;
+}
+
+} // namespace geom::simd
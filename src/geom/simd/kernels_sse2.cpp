@@ -0,0 +1,160 @@
+#include "geom/simd/kernels.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+
+namespace geom::simd {
+
+static inline double extractsum(__m128d vec) {
+    alignas(16) double tmp[2];
+    _mm_store_pd(tmp, vec);
+    return tmp[0] + tmp[1];
+}
+
+static void chain_sums(const double* eps, const double* sig, std::size_t n,
+                       double& area, double& momentum)
+{
+    __m128d area_simd = _mm_setzero_pd();
+    __m128d momentum_simd = _mm_setzero_pd();
+
+    std::size_t i = 0;
+    for (; i + 2 < n; i += 2) {
+        __m128d eps_i_simd = _mm_loadu_pd(&eps[i]);
+        __m128d sig_i_simd = _mm_loadu_pd(&sig[i]);
+
+        __m128d eps_j_simd = _mm_loadu_pd(&eps[i + 1]);
+        __m128d sig_j_simd = _mm_loadu_pd(&sig[i + 1]);
+
+        __m128d area_vec = _mm_sub_pd(_mm_mul_pd(eps_i_simd, sig_j_simd),
+                                      _mm_mul_pd(eps_j_simd, sig_i_simd));
+        area_simd = _mm_add_pd(area_simd, area_vec);
+
+        __m128d momentum_vec = _mm_mul_pd(_mm_add_pd(eps_j_simd, eps_i_simd), area_vec);
+        momentum_simd = _mm_add_pd(momentum_simd, momentum_vec);
+    }
+
+    area = extractsum(area_simd);
+    momentum = extractsum(momentum_simd);
+
+    for (; i + 1 < n; ++i) {
+        std::size_t j = i + 1;
+        double tmp_area = eps[i] * sig[j] - eps[j] * sig[i];
+        area += tmp_area;
+
+        momentum += (eps[i] + eps[j]) * tmp_area;
+    }
+}
+
+static void ordered_chain_sums(const double* eps, const double* sig, std::size_t n,
+                               double& area, double& momentum)
+{
+    // lanes 0, 1 in the low vectors, lanes 2, 3 in the high ones
+    __m128d area_lo = _mm_setzero_pd();
+    __m128d area_hi = _mm_setzero_pd();
+    __m128d momentum_lo = _mm_setzero_pd();
+    __m128d momentum_hi = _mm_setzero_pd();
+
+    std::size_t i = 0;
+    for (; i + 4 < n; i += 4) {
+        __m128d eps_i_lo = _mm_loadu_pd(&eps[i]);
+        __m128d sig_i_lo = _mm_loadu_pd(&sig[i]);
+        __m128d eps_j_lo = _mm_loadu_pd(&eps[i + 1]);
+        __m128d sig_j_lo = _mm_loadu_pd(&sig[i + 1]);
+
+        __m128d eps_i_hi = _mm_loadu_pd(&eps[i + 2]);
+        __m128d sig_i_hi = _mm_loadu_pd(&sig[i + 2]);
+        __m128d eps_j_hi = _mm_loadu_pd(&eps[i + 3]);
+        __m128d sig_j_hi = _mm_loadu_pd(&sig[i + 3]);
+
+        __m128d area_vec_lo = _mm_sub_pd(_mm_mul_pd(eps_i_lo, sig_j_lo), _mm_mul_pd(eps_j_lo, sig_i_lo));
+        __m128d area_vec_hi = _mm_sub_pd(_mm_mul_pd(eps_i_hi, sig_j_hi), _mm_mul_pd(eps_j_hi, sig_i_hi));
+        area_lo = _mm_add_pd(area_lo, area_vec_lo);
+        area_hi = _mm_add_pd(area_hi, area_vec_hi);
+
+        momentum_lo = _mm_add_pd(momentum_lo, _mm_mul_pd(_mm_add_pd(eps_i_lo, eps_j_lo), area_vec_lo));
+        momentum_hi = _mm_add_pd(momentum_hi, _mm_mul_pd(_mm_add_pd(eps_i_hi, eps_j_hi), area_vec_hi));
+    }
+
+    alignas(16) double area_lane[ordered_lanes];
+    alignas(16) double momentum_lane[ordered_lanes];
+    _mm_store_pd(&area_lane[0], area_lo);
+    _mm_store_pd(&area_lane[2], area_hi);
+    _mm_store_pd(&momentum_lane[0], momentum_lo);
+    _mm_store_pd(&momentum_lane[2], momentum_hi);
+
+    ordered_chain_tail(eps, sig, i, n, area_lane, momentum_lane);
+
+    area = ordered_lane_sum(area_lane);
+    momentum = ordered_lane_sum(momentum_lane);
+}
+
+static void batch(const double* eps, const double* sig, std::size_t n, std::size_t stride,
+                  std::size_t first, std::size_t last, double* area, double* momentum)
+{
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d six = _mm_set1_pd(6.0);
+    const __m128d sign_mask = _mm_set1_pd(-0.0);
+
+    std::size_t p = first;
+
+    // 2 polygons per iteration
+    for (; p + 2 <= last; p += 2) {
+        __m128d area_simd = _mm_setzero_pd();
+        __m128d momentum_simd = _mm_setzero_pd();
+
+        __m128d eps_i_simd = _mm_loadu_pd(&eps[p]);
+        __m128d sig_i_simd = _mm_loadu_pd(&sig[p]);
+
+        for (std::size_t k = 1; k < n; ++k) {
+            __m128d eps_j_simd = _mm_loadu_pd(&eps[k * stride + p]);
+            __m128d sig_j_simd = _mm_loadu_pd(&sig[k * stride + p]);
+
+            __m128d area_vec = _mm_sub_pd(_mm_mul_pd(eps_i_simd, sig_j_simd),
+                                          _mm_mul_pd(eps_j_simd, sig_i_simd));
+            area_simd = _mm_add_pd(area_simd, area_vec);
+
+            __m128d momentum_vec = _mm_mul_pd(_mm_add_pd(eps_i_simd, eps_j_simd), area_vec);
+            momentum_simd = _mm_add_pd(momentum_simd, momentum_vec);
+
+            eps_i_simd = eps_j_simd;
+            sig_i_simd = sig_j_simd;
+        }
+
+        // closing edge v_{n-1} -> v_0 (area only)
+        __m128d eps_0_simd = _mm_loadu_pd(&eps[p]);
+        __m128d sig_0_simd = _mm_loadu_pd(&sig[p]);
+        area_simd = _mm_add_pd(area_simd, _mm_mul_pd(eps_i_simd, sig_0_simd));
+        area_simd = _mm_sub_pd(area_simd, _mm_mul_pd(eps_0_simd, sig_i_simd));
+
+        area_simd = _mm_mul_pd(_mm_andnot_pd(sign_mask, area_simd), half);
+        momentum_simd = _mm_div_pd(_mm_andnot_pd(sign_mask, momentum_simd), six);
+
+        _mm_storeu_pd(&area[p], area_simd);
+        _mm_storeu_pd(&momentum[p], momentum_simd);
+    }
+
+    for (; p < last; ++p) {
+        column_area_momentum(eps, sig, n, stride, p, area[p], momentum[p]);
+    }
+}
+
+const ShoelaceKernels* sse2_kernels()
+{
+    static const ShoelaceKernels table{chain_sums, ordered_chain_sums, batch};
+    return &table;
+}
+
+} // namespace geom::simd
+
+#else
+
+namespace geom::simd {
+
+const ShoelaceKernels* sse2_kernels()
+{
+    return nullptr;
+}
+
+} // namespace geom::simd
+
+#endif
@@ -0,0 +1,165 @@
+#include "compiledcurve.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+namespace preprocess {
+
+CompiledCurve::CompiledCurve(PointsView lm)
+{
+    const auto& e = lm.get_epsilon();
+    const auto& s = lm.get_sigma();
+    const std::size_t n = e.size();
+
+    if (n < 2) {
+        spdlog::error("CompiledCurve: polyline contains fewer than 2 points.");
+        return;
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!std::isfinite(e[i]) || !std::isfinite(s[i])) {
+            spdlog::error("CompiledCurve: point {} is not finite.", i);
+            return;
+        }
+        if (i > 0 && e[i] < e[i - 1]) {
+            spdlog::error("CompiledCurve: epsilon is not sorted at point {} ({} < {}).", i, e[i], e[i - 1]);
+            return;
+        }
+    }
+
+    eps.resize(n);
+    sig.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        eps[i] = e[i];
+        sig[i] = s[i];
+    }
+
+    slopes.resize(n - 1);
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        const double width = eps[i + 1] - eps[i];
+        slopes[i] = (width > 0.0) ? (sig[i + 1] - sig[i]) / width : 0.0;
+    }
+
+    // in-order walk of the implicit tree fills it with the sorted breakpoints
+    eytzinger.resize(n + 1);
+    eytzinger_index.resize(n + 1);
+
+    std::size_t next = 0;
+    auto fill = [&](auto& self, std::size_t k) -> void {
+        if (k > n) {
+            return;
+        }
+        self(self, 2 * k);
+        eytzinger[k] = eps[next];
+        eytzinger_index[k] = next;
+        ++next;
+        self(self, 2 * k + 1);
+    };
+    fill(fill, 1);
+}
+
+std::size_t CompiledCurve::lower_bound(double eps_cut) const
+{
+    const std::size_t n = eps.size();
+
+    // descend to a leaf; the comparison result selects the child without a branch
+    std::size_t k = 1;
+    while (k <= n) {
+        k = 2 * k + static_cast<std::size_t>(eytzinger[k] < eps_cut);
+    }
+
+    // undo the right turns below the last left turn, which was at the answer
+    k >>= std::countr_one(k) + 1;
+
+    return (k == 0) ? n : eytzinger_index[k];
+}
+
+std::size_t CompiledCurve::lower_bound(double eps_cut, std::size_t& hint) const
+{
+    const std::size_t n = eps.size();
+
+    auto is_lower_bound = [&](std::size_t idx) {
+        return idx <= n
+            && (idx == n || eps[idx] >= eps_cut)
+            && (idx == 0 || eps[idx - 1] < eps_cut);
+    };
+
+    // the same segment as before or one of its neighbours
+    if (is_lower_bound(hint)) {
+        return hint;
+    }
+    if (is_lower_bound(hint + 1)) {
+        return ++hint;
+    }
+    if (hint > 0 && is_lower_bound(hint - 1)) {
+        return --hint;
+    }
+
+    hint = lower_bound(eps_cut);
+    return hint;
+}
+
+CutPoint CompiledCurve::_interpolate(double eps_cut, std::size_t idx) const
+{
+    CutPoint cut;
+    cut.idx = idx;
+
+    // segment [j-1, j], the first one for a cut on the first vertex
+    const std::size_t j = std::max<std::size_t>(idx, 1);
+    cut.dsigma = slopes[j - 1];
+
+    if (eps[idx] == eps_cut) {
+        cut.sigma = sig[idx];
+    } else {
+        cut.sigma = sig[j - 1] + (eps_cut - eps[j - 1]) * cut.dsigma;
+    }
+
+    return cut;
+}
+
+PrepResult<CutPoint> CompiledCurve::try_locate(double eps_cut) const
+{
+    if (!valid()) {
+        return {CutPoint{}, PrepStatus::InvalidCurve};
+    }
+    if (!(eps_cut >= eps.front() && eps_cut <= eps.back())) {
+        return {CutPoint{}, PrepStatus::OutOfRange};
+    }
+
+    return {_interpolate(eps_cut, lower_bound(eps_cut)), PrepStatus::Ok};
+}
+
+PrepResult<CutPoint> CompiledCurve::try_locate(double eps_cut, std::size_t& hint) const
+{
+    if (!valid()) {
+        return {CutPoint{}, PrepStatus::InvalidCurve};
+    }
+    if (!(eps_cut >= eps.front() && eps_cut <= eps.back())) {
+        return {CutPoint{}, PrepStatus::OutOfRange};
+    }
+
+    return {_interpolate(eps_cut, lower_bound(eps_cut, hint)), PrepStatus::Ok};
+}
+
+CutPoint CompiledCurve::locate(double eps_cut) const
+{
+    PrepResult<CutPoint> cut = try_locate(eps_cut);
+    if (!cut) {
+        spdlog::error("eps_cut={} is out of range [{}, {}].",
+                eps_cut, epsilon_front(), epsilon_back());
+    }
+    return cut.value;
+}
+
+CutPoint CompiledCurve::locate(double eps_cut, std::size_t& hint) const
+{
+    PrepResult<CutPoint> cut = try_locate(eps_cut, hint);
+    if (!cut) {
+        spdlog::error("eps_cut={} is out of range [{}, {}].",
+                eps_cut, epsilon_front(), epsilon_back());
+    }
+    return cut.value;
+}
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include "points/points.h"
+#include "points/pointsview.h"
+#include "inputreader/prepstatus.h"
+
+// Immutable, validated form of a material curve for repeated cuts.
+//
+// _preprocess_polyline re-validates the polyline, binary-searches it and divides
+// by the segment width on every call. A CompiledCurve does the validation once,
+// stores the breakpoints a second time in Eytzinger (BFS) order, where the search
+// touches the same few cache lines for every query and runs without data-dependent
+// branches, and stores the slope of every segment, so a cut costs one search and
+// one multiply-add. Queries that stay close to the previous one (Newton iterates,
+// sweeps over sorted cuts) can pass a hint and skip the search altogether.
+
+namespace preprocess {
+
+    // Intersection point together with d sigma / d eps_cut, the slope of the segment
+    // that contains eps_cut (the left one if eps_cut is a vertex).
+    struct CutPoint {
+        std::size_t idx = 0;
+        double sigma = 0.0;
+        double dsigma = 0.0;
+    };
+
+    class CompiledCurve {
+    public:
+        CompiledCurve() = default;
+
+        // lm needs at least 2 points, finite values and ascending epsilon;
+        // otherwise an error is logged and the curve stays empty (valid() == false)
+        explicit CompiledCurve(PointsView lm);
+
+        bool valid() const {
+            return !eps.empty();
+        }
+
+        std::size_t size() const {
+            return eps.size();
+        }
+
+        // strain range [front, back] in which cuts are valid
+        double epsilon_front() const {
+            return eps.empty() ? 0.0 : eps.front();
+        }
+
+        double epsilon_back() const {
+            return eps.empty() ? 0.0 : eps.back();
+        }
+
+        const std::vector<double>& get_epsilon() const {
+            return eps;
+        }
+
+        const std::vector<double>& get_sigma() const {
+            return sig;
+        }
+
+        // slope of segment [i, i+1]; 0 for a segment of zero width
+        double slope(std::size_t i) const {
+            return slopes[i];
+        }
+
+        // index of the first breakpoint >= eps_cut, size() if there is none
+        // (same as std::lower_bound over the breakpoints)
+        std::size_t lower_bound(double eps_cut) const;
+
+        // same, starting from the index returned for the previous query; hint is updated
+        std::size_t lower_bound(double eps_cut, std::size_t& hint) const;
+
+        // intersection point and slope at eps_cut, like _preprocess_polyline_derivative;
+        // a default CutPoint (and an error) if eps_cut is outside the curve
+        CutPoint locate(double eps_cut) const;
+
+        CutPoint locate(double eps_cut, std::size_t& hint) const;
+
+        // same without logging: the reason is in the status (see prepstatus.h)
+        PrepResult<CutPoint> try_locate(double eps_cut) const;
+
+        PrepResult<CutPoint> try_locate(double eps_cut, std::size_t& hint) const;
+
+    private:
+        CutPoint _interpolate(double eps_cut, std::size_t idx) const;
+
+        std::vector<double> eps;
+        std::vector<double> sig;
+        std::vector<double> slopes;     // size() - 1 segments
+
+        // breakpoints in Eytzinger order, 1-based (eytzinger[0] is unused), and the
+        // sorted index of every entry
+        std::vector<double> eytzinger;
+        std::vector<std::size_t> eytzinger_index;
+    };
+
+}
@@ -0,0 +1,355 @@
+#include "csvreader.h"
+#include "mappedfile.h"
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace preprocess {
+
+static constexpr std::size_t no_line = std::numeric_limits<std::size_t>::max();
+
+// Rows of one chunk of the file
+struct CsvChunk {
+    std::string_view text;
+    std::vector<std::vector<double>> columns;
+    std::size_t lines = 0;              // all lines of the chunk, skipped ones included
+
+    std::size_t first_row_line = no_line;   // local line of the first row
+    std::size_t error_line = no_line;       // local line of the first error
+    std::string error;
+};
+
+static bool _is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static std::string_view _trim(std::string_view s)
+{
+    while (!s.empty() && _is_blank(s.front())) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && _is_blank(s.back())) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// a line without rows: blank or comment
+static bool _is_skipped(std::string_view line)
+{
+    return line.empty() || line.front() == '#';
+}
+
+// header: the first line that is not skipped, if it does not start with a number
+static bool _is_header(std::string_view line)
+{
+    const char c = line.front();
+    return !((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.');
+}
+
+// values of one (trimmed, non-empty) line; false and a message on error
+static bool _parse_row(std::string_view line, char delimiter, std::size_t columns,
+                       double* values, std::string& error)
+{
+    const char* p = line.data();
+    const char* end = p + line.size();
+
+    for (std::size_t c = 0; c < columns; ++c) {
+        while (p < end && _is_blank(*p)) {
+            ++p;
+        }
+        // from_chars does not take a leading '+'
+        if (p < end && *p == '+') {
+            ++p;
+        }
+
+        auto [next, ec] = std::from_chars(p, end, values[c]);
+        if (ec != std::errc() || !std::isfinite(values[c])) {
+            error = "column " + std::to_string(c + 1) + " is not a finite number";
+            return false;
+        }
+        p = next;
+
+        while (p < end && _is_blank(*p)) {
+            ++p;
+        }
+        if (c + 1 < columns) {
+            if (p == end || *p != delimiter) {
+                error = "expected " + std::to_string(columns) + " columns";
+                return false;
+            }
+            ++p;
+        }
+    }
+
+    if (p != end) {
+        error = "more than " + std::to_string(columns) + " columns";
+        return false;
+    }
+    return true;
+}
+
+static void _parse_chunk(CsvChunk& chunk, std::size_t columns, std::size_t ascending_column, char delimiter)
+{
+    // one pass over the newlines for an upper bound on the rows
+    const std::size_t max_rows = static_cast<std::size_t>(
+        std::count(chunk.text.begin(), chunk.text.end(), '\n')) + 1;
+
+    chunk.columns.assign(columns, std::vector<double>());
+    for (auto& column : chunk.columns) {
+        column.reserve(max_rows);
+    }
+
+    std::vector<double> values(columns);
+    std::string_view rest = chunk.text;
+
+    while (!rest.empty()) {
+        const std::size_t eol = rest.find('\n');
+        std::string_view line = _trim(rest.substr(0, eol));
+        rest.remove_prefix(eol == std::string_view::npos ? rest.size() : eol + 1);
+
+        const std::size_t local_line = chunk.lines++;
+        if (_is_skipped(line)) {
+            continue;
+        }
+
+        if (!_parse_row(line, delimiter, columns, values.data(), chunk.error)) {
+            chunk.error_line = local_line;
+            return;
+        }
+
+        if (ascending_column < columns) {
+            const auto& column = chunk.columns[ascending_column];
+            if (!column.empty() && values[ascending_column] < column.back()) {
+                chunk.error = "column " + std::to_string(ascending_column + 1) + " is not ascending";
+                chunk.error_line = local_line;
+                return;
+            }
+        }
+
+        if (chunk.first_row_line == no_line) {
+            chunk.first_row_line = local_line;
+        }
+        for (std::size_t c = 0; c < columns; ++c) {
+            chunk.columns[c].push_back(values[c]);
+        }
+    }
+}
+
+// drop a header line, and the blank or comment lines before it, from text;
+// returns the number of lines dropped
+static std::size_t _drop_header(std::string_view& text)
+{
+    std::string_view rest = text;
+    std::size_t lines = 0;
+    while (!rest.empty()) {
+        const std::size_t eol = rest.find('\n');
+        std::string_view line = _trim(rest.substr(0, eol));
+        rest.remove_prefix(eol == std::string_view::npos ? rest.size() : eol + 1);
+        ++lines;
+
+        if (!_is_skipped(line)) {
+            if (_is_header(line)) {
+                text = rest;
+                return lines;
+            }
+            break;
+        }
+    }
+    return 0;
+}
+
+// end of the chunk starting at first: at least chunk_bytes long, up to the end of a line
+static std::size_t _chunk_end(std::string_view text, std::size_t first, std::size_t chunk_bytes)
+{
+    std::size_t last = std::min(first + chunk_bytes, text.size());
+    if (last < text.size()) {
+        const std::size_t eol = text.find('\n', last - 1);
+        last = (eol == std::string_view::npos) ? text.size() : eol + 1;
+    }
+    return last;
+}
+
+CsvColumns parseCsv(std::string_view text, std::size_t columns, std::size_t ascending_column,
+                    const CsvOptions& options)
+{
+    CsvColumns result;
+    result.columns.assign(columns, std::vector<double>());
+
+    if (columns == 0) {
+        result.error = "no columns requested";
+        return result;
+    }
+
+    const std::size_t header_lines = _drop_header(text);
+
+    // split at line boundaries
+    std::vector<CsvChunk> chunks;
+    const std::size_t chunk_bytes = std::max<std::size_t>(options.chunk_bytes, 1);
+    for (std::size_t first = 0; first < text.size(); ) {
+        const std::size_t last = _chunk_end(text, first, chunk_bytes);
+        CsvChunk chunk;
+        chunk.text = text.substr(first, last - first);
+        chunks.push_back(std::move(chunk));
+        first = last;
+    }
+
+    parallelFor(options.execution, chunks.size(), [&](std::size_t, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            _parse_chunk(chunks[i], columns, ascending_column, options.delimiter);
+        }
+    });
+
+    // first error in file order; the order across chunks is checked here
+    std::size_t line_offset = header_lines;
+    std::size_t rows = 0;
+    const CsvChunk* previous = nullptr;   // last chunk with rows
+
+    for (const CsvChunk& chunk : chunks) {
+        // (a chunk's first row comes before its own error, if any)
+        if (chunk.first_row_line != no_line) {
+            if (ascending_column < columns && previous != nullptr
+                && chunk.columns[ascending_column].front() < previous->columns[ascending_column].back()) {
+                result.error = "line " + std::to_string(line_offset + chunk.first_row_line + 1)
+                             + ": column " + std::to_string(ascending_column + 1) + " is not ascending";
+                return result;
+            }
+            previous = &chunk;
+        }
+
+        if (chunk.error_line != no_line) {
+            result.error = "line " + std::to_string(line_offset + chunk.error_line + 1) + ": " + chunk.error;
+            return result;
+        }
+
+        line_offset += chunk.lines;
+        rows += chunk.columns[0].size();
+    }
+
+    // concatenate the chunks
+    for (std::size_t c = 0; c < columns; ++c) {
+        std::vector<double>& column = result.columns[c];
+        column.reserve(rows);
+        for (const CsvChunk& chunk : chunks) {
+            column.insert(column.end(), chunk.columns[c].begin(), chunk.columns[c].end());
+        }
+    }
+
+    result.rows = rows;
+    result.ok = true;
+    return result;
+}
+
+CsvColumns readCsv(const std::string& path, std::size_t columns, std::size_t ascending_column,
+                   const CsvOptions& options)
+{
+    MappedFile file(path);
+    if (!file.valid()) {
+        CsvColumns result;
+        result.error = "cannot open file";
+        return result;
+    }
+
+    CsvColumns result = parseCsv(file.text(), columns, ascending_column, options);
+    if (!result.ok) {
+        spdlog::error("readCsv: {}: {}", path, result.error);
+    }
+    return result;
+}
+
+CsvStreamResult streamCsv(const std::string& path, std::size_t columns, std::size_t ascending_column,
+                          const CsvConsumer& consumer, const CsvOptions& options)
+{
+    CsvStreamResult result;
+
+    MappedFile file(path);
+    if (!file.valid()) {
+        result.error = "cannot open file";
+        return result;
+    }
+    if (columns == 0) {
+        result.error = "no columns requested";
+        spdlog::error("streamCsv: {}: {}", path, result.error);
+        return result;
+    }
+
+    std::string_view text = file.text();
+    std::size_t line_offset = _drop_header(text);
+
+    // chunks in file order on this thread; only the current one is held in memory
+    const std::size_t chunk_bytes = std::max<std::size_t>(options.chunk_bytes, 1);
+    bool has_previous = false;
+    double previous = 0.0;      // last value of the ascending column so far
+
+    for (std::size_t first = 0; first < text.size(); ) {
+        const std::size_t last = _chunk_end(text, first, chunk_bytes);
+        CsvChunk chunk;
+        chunk.text = text.substr(first, last - first);
+        first = last;
+
+        _parse_chunk(chunk, columns, ascending_column, options.delimiter);
+
+        const std::size_t rows = chunk.columns[0].size();
+        if (chunk.first_row_line != no_line && ascending_column < columns) {
+            if (has_previous && chunk.columns[ascending_column].front() < previous) {
+                result.error = "line " + std::to_string(line_offset + chunk.first_row_line + 1)
+                             + ": column " + std::to_string(ascending_column + 1) + " is not ascending";
+                spdlog::error("streamCsv: {}: {}", path, result.error);
+                return result;
+            }
+            has_previous = true;
+            previous = chunk.columns[ascending_column].back();
+        }
+
+        if (chunk.error_line != no_line) {
+            result.error = "line " + std::to_string(line_offset + chunk.error_line + 1) + ": " + chunk.error;
+            spdlog::error("streamCsv: {}: {}", path, result.error);
+            return result;
+        }
+
+        if (rows > 0) {
+            result.rows += rows;
+            if (!consumer(chunk.columns, rows)) {
+                result.error = "stopped by the consumer";
+                return result;
+            }
+        }
+        line_offset += chunk.lines;
+    }
+
+    result.ok = true;
+    return result;
+}
+
+Points readCurve(const std::string& path, const CsvOptions& options)
+{
+    CsvColumns table = readCsv(path, 2, 0, options);
+    if (!table.ok) {
+        return Points();
+    }
+    if (table.rows < 2) {
+        spdlog::error("readCurve: {}: a curve needs at least 2 points, got {}.", path, table.rows);
+        return Points();
+    }
+    return Points(std::move(table.columns[0]), std::move(table.columns[1]));
+}
+
+TargetTable readTargetTable(const std::string& path, const CsvOptions& options)
+{
+    TargetTable targets;
+
+    CsvColumns table = readCsv(path, 3, no_ascending_column, options);
+    if (!table.ok) {
+        return targets;
+    }
+
+    targets.kappa = std::move(table.columns[0]);
+    targets.eps_0 = std::move(table.columns[1]);
+    targets.moment = std::move(table.columns[2]);
+    return targets;
+}
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include "points/points.h"
+#include "parallel/execution.h"
+
+// Native reader for material curves (epsilon, sigma) and target tables
+// (k, eps_0, M_tar, see k_eps0_M.csv).
+//
+// The file is memory-mapped (MappedFile) and parsed in place with std::from_chars.
+// Large files are split at line boundaries into chunks of at least chunk_bytes,
+// which are parsed in parallel into their own columns and concatenated at the end.
+// Finite values and, for curves, ascending epsilon are checked in the same pass.
+//
+// Format: one row per line, fields separated by the delimiter, surrounding blanks
+// ignored. A first line that does not start with a number is taken as header;
+// blank lines and lines starting with '#' are skipped. On error the first bad line
+// is logged and an empty result is returned.
+
+namespace preprocess {
+
+    struct CsvOptions {
+        char delimiter = ',';
+        std::size_t chunk_bytes = 1 << 20;  // smallest chunk parsed by one thread
+        ExecutionPolicy execution = defaultExecution();     // of the chunks of parseCsv/readCsv
+    };
+
+    // no column has to be ascending
+    inline constexpr std::size_t no_ascending_column = static_cast<std::size_t>(-1);
+
+    // Numeric columns of a table
+    struct CsvColumns {
+        std::vector<std::vector<double>> columns;
+        std::size_t rows = 0;
+        bool ok = false;
+        std::string error;      // first error, with its line number
+    };
+
+    // Parse text with exactly `columns` numbers per row; column ascending_column
+    // (if any) must be non-decreasing. Does not log, the error is in the result.
+    CsvColumns parseCsv(std::string_view text, std::size_t columns,
+                        std::size_t ascending_column = no_ascending_column,
+                        const CsvOptions& options = CsvOptions());
+
+    // Same for a file; errors are logged
+    CsvColumns readCsv(const std::string& path, std::size_t columns,
+                       std::size_t ascending_column = no_ascending_column,
+                       const CsvOptions& options = CsvOptions());
+
+    // Rows of one chunk: columns[c][0 .. rows) for every column. Returning false stops the stream.
+    using CsvConsumer = std::function<bool(const std::vector<std::vector<double>>& columns, std::size_t rows)>;
+
+    struct CsvStreamResult {
+        std::size_t rows = 0;   // rows handed to the consumer
+        bool ok = false;
+        std::string error;      // first error, with its line number
+    };
+
+    // Same checks as readCsv, but the file is parsed chunk by chunk in order on the
+    // calling thread and every chunk is handed to the consumer instead of being
+    // concatenated, so memory is O(chunk_bytes) for files of any size. On error the
+    // chunks before the bad one have already been consumed; errors are logged.
+    CsvStreamResult streamCsv(const std::string& path, std::size_t columns,
+                              std::size_t ascending_column, const CsvConsumer& consumer,
+                              const CsvOptions& options = CsvOptions());
+
+    // Material curve: epsilon, sigma with epsilon ascending and at least 2 points;
+    // empty Points on error
+    Points readCurve(const std::string& path, const CsvOptions& options = CsvOptions());
+
+    struct TargetTable {
+        std::vector<double> kappa;
+        std::vector<double> eps_0;
+        std::vector<double> moment;
+
+        std::size_t size() const {
+            return kappa.size();
+        }
+    };
+
+    // k, eps_0, M_tar; empty on error
+    TargetTable readTargetTable(const std::string& path, const CsvOptions& options = CsvOptions());
+
+}
@@ -0,0 +1,71 @@
+#include "mappedfile.h"
+#include <fstream>
+#include <iterator>
+#include <spdlog/spdlog.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define SPLINE_HAVE_MMAP 1
+#endif
+
+namespace preprocess {
+
+MappedFile::MappedFile(const std::string& path)
+{
+#ifdef SPLINE_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        spdlog::error("MappedFile: cannot open {}.", path);
+        return;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        length = static_cast<std::size_t>(info.st_size);
+        if (length == 0) {
+            // nothing to map, an empty view is enough
+            ::close(fd);
+            is_open = true;
+            return;
+        }
+
+        void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            // the parsers walk the file front to back
+            ::madvise(address, length, MADV_SEQUENTIAL);
+            ::close(fd);
+            bytes = static_cast<const char*>(address);
+            is_open = true;
+            is_mapped = true;
+            return;
+        }
+    }
+    ::close(fd);
+    length = 0;
+#endif
+
+    // fall back to one read into memory
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        spdlog::error("MappedFile: cannot open {}.", path);
+        return;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    bytes = buffer.data();
+    length = buffer.size();
+    is_open = true;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef SPLINE_HAVE_MMAP
+    if (is_mapped) {
+        ::munmap(const_cast<char*>(bytes), length);
+    }
+#endif
+}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Read-only view of a whole file.
+//
+// On POSIX systems the file is memory-mapped, so readers parse the page cache in
+// place and never copy it into strings or streams; elsewhere (or if mapping fails)
+// it is read into a buffer once. An error is logged if the file cannot be opened.
+
+namespace preprocess {
+
+    class MappedFile {
+    public:
+        MappedFile() = default;
+
+        explicit MappedFile(const std::string& path);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool valid() const {
+            return is_open;
+        }
+
+        std::size_t size() const {
+            return length;
+        }
+
+        const char* data() const {
+            return bytes;
+        }
+
+        std::string_view text() const {
+            return std::string_view(bytes, length);
+        }
+
+        // true if the contents are mapped rather than copied
+        bool mapped() const {
+            return is_mapped;
+        }
+
+    private:
+        const char* bytes = nullptr;
+        std::size_t length = 0;
+        bool is_open = false;
+        bool is_mapped = false;
+        std::string buffer;     // contents if the file could not be mapped
+    };
+
+}
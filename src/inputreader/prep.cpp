@@ -1,80 +1,101 @@
 #include "prep.h"
+#include <cmath>
 
 
 namespace preprocess {
 
-// Computes sigma(eps_cut) from the polyline (epsilon[], sigma[])
-std::pair<std::size_t,double> _preprocess_polyline(double eps_cut, const Points& lm)
+// Computes sigma(eps_cut) from the polyline (epsilon[], sigma[]), without logging
+PrepResult<std::pair<std::size_t,double>> _try_preprocess_polyline(double eps_cut, PointsView lm)
 {
-    std::size_t n = lm.size();
-    if (n < 2) {
+    PrepResult<PolylineCut> cut = locateCut(eps_cut, lm);
+    return {{cut.value.idx, cut.value.sigma}, cut.status};
+}
+
+// error line for a failed single cut
+static void _log_failure(PrepStatus status, double eps_cut, double front, double back)
+{
+    if (status == PrepStatus::InvalidCurve) {
         spdlog::error("Interpolation failed: polyline contains fewer than 2 points.");
-        return {0, 0.0};
+    } else {
+        spdlog::error("eps_cut={} is out of range [{}, {}].", eps_cut, front, back);
     }
+}
 
+static void _log_failure(PrepStatus status, double eps_cut, PointsView lm)
+{
+    if (lm.empty()) {
+        _log_failure(status, eps_cut, 0.0, 0.0);
+    } else {
+        _log_failure(status, eps_cut, lm.get_epsilon().front(), lm.get_epsilon().back());
+    }
+}
 
-    const auto& eps = lm.get_epsilon();
-    const auto& sig = lm.get_sigma();
-
+std::pair<std::size_t,double> _preprocess_polyline(double eps_cut, PointsView lm)
+{
+    PrepResult<std::pair<std::size_t,double>> interp = _try_preprocess_polyline(eps_cut, lm);
 
-    // Check valid domain
-    if (eps_cut < eps.front() || eps_cut > eps.back()) {
-        spdlog::error("eps_cut={} is out of range [{}, {}].",
-                eps_cut, eps.front(), eps.back());
-        return {0, 0.0};
+    if (!interp) {
+        _log_failure(interp.status, eps_cut, lm);
     }
 
-    // Locate position using binary search 
-    auto it = std::lower_bound(eps.begin(), eps.end(), eps_cut);
-    std::size_t idx = static_cast<std::size_t>(std::distance(eps.begin(), it));
+    return interp.value;
+}
 
-    // Exact match: return sigma without interpolation
-    if (it != eps.end() && *it == eps_cut) {
-        return {idx, sig[idx]};
-    }
+// Same lookup as _preprocess_polyline, also returns the slope of the segment
+CutPoint _preprocess_polyline_derivative(double eps_cut, PointsView lm)
+{
+    PrepResult<std::pair<std::size_t,double>> interp = _try_preprocess_polyline(eps_cut, lm);
 
-    // Bracketing indices must exist
-    if (idx == 0 || idx >= n) {
-        spdlog::error("Failed to bracket eps_cut={}, idx={}", eps_cut, idx);
-        return {0, 0.0};
-    }
+    const auto& eps = lm.get_epsilon();
+    const auto& sig = lm.get_sigma();
 
-    std::size_t i = idx - 1;
-    std::size_t j = idx;
+    if (!interp) {
+        _log_failure(interp.status, eps_cut, lm);
+        return CutPoint{};
+    }
 
-    double eps0 = eps[i];
-    double eps1 = eps[j];
-    double sig0 = sig[i];
-    double sig1 = sig[j];
+    // segment [j-1, j], the first one for a cut on the first vertex
+    std::size_t j = std::max<std::size_t>(interp.value.first, 1);
 
-    double t = (eps_cut - eps0) / (eps1 - eps0);
-    double result = sig0 + t * (sig1 - sig0);
+    CutPoint cut;
+    cut.idx = interp.value.first;
+    cut.sigma = interp.value.second;
+    cut.dsigma = (sig[j] - sig[j - 1]) / (eps[j] - eps[j - 1]);
 
-    return {idx, result};
+    return cut;
 }
 
 // Preprocessing step equivalent to Python prep()
 // Constructs a closed polygon for shoelace: trim, add intersection point,
 // drop a vertical segment, and add the origin point.
-Points prep(double eps_cut, const Points& lm)
+PrepResult<Points> try_prep(double eps_cut, PointsView lm)
 {
 
     const auto& eps = lm.get_epsilon();
     const auto& sig = lm.get_sigma();
 
-    std::pair<std::size_t,double> interp = _preprocess_polyline(eps_cut, lm);
+    PrepResult<std::pair<std::size_t,double>> lookup = _try_preprocess_polyline(eps_cut, lm);
 
-    if (interp.first == 0u && interp.second == 0.0) {
-        spdlog::error("Preprocessing failed: could not compute intersection point.");
-        return Points();
+    if (!lookup) {
+        return {Points(), lookup.status};
     }
 
-    
-    Points out(interp.first + 3); // +3 for intersection, projection, and origin
+    const std::pair<std::size_t,double>& interp = lookup.value;
+
+    PrepResult<Points> result;
+    Points& out = result.value;
+    out.reserve(interp.first + 3); // +3 for intersection, projection, and origin
 
     // 1) Copy all points with epsilon < eps_cut
 
-    out.insert_range(eps, sig, 0, interp.first);
+    if (lm.contiguous()) {
+        out.insert_range(std::span<const double>(eps.data(), eps.size()),
+                         std::span<const double>(sig.data(), sig.size()), 0, interp.first);
+    } else {
+        for (std::size_t i = 0; i < interp.first; ++i) {
+            out.push_back(eps[i], sig[i]);
+        }
+    }
 
     // 2) Add intersection point [eps_cut, sigma_interp]
     out.push_back(eps_cut, interp.second);
@@ -85,7 +106,211 @@ Points prep(double eps_cut, const Points& lm)
     // 4) Add starting point to close the polygon 
     out.push_back(eps[0], sig[0]);
 
-    return out;
+    return result;
+}
+
+Points prep(double eps_cut, PointsView lm)
+{
+    PrepResult<Points> polygon = try_prep(eps_cut, lm);
+
+    if (!polygon) {
+        _log_failure(polygon.status, eps_cut, lm);
+        spdlog::error("Preprocessing failed: could not compute intersection point.");
+    }
+
+    return std::move(polygon.value);
+}
+
+bool prep(double eps_cut, PointsView lm, PointsBatch& out)
+{
+    PrepResult<std::pair<std::size_t,double>> lookup = _try_preprocess_polyline(eps_cut, lm);
+
+    if (!lookup) {
+        _log_failure(lookup.status, eps_cut, lm);
+        spdlog::error("Preprocessing failed: could not compute intersection point.");
+        out.append(PointsView());
+        return false;
+    }
+
+    const std::pair<std::size_t,double>& interp = lookup.value;
+
+    // same polygon as prep(eps_cut, lm), written straight into the batch
+    out.append(lm.subview(0, interp.first));
+    out.push_back(eps_cut, interp.second);
+    out.push_back(eps_cut, 0.0);
+    out.push_back(lm.get_epsilon()[0], lm.get_sigma()[0]);
+
+    return true;
+}
+
+// lower bounds of all x at once: every query takes the same number of halving steps,
+// and the step taken depends on a comparison result, not on a branch
+static void _lower_bound_batch(const StridedSpan& values, std::span<const double> x, std::span<std::size_t> idx)
+{
+    std::fill(idx.begin(), idx.end(), 0);
+
+    std::size_t len = values.size();
+    while (len > 1) {
+        const std::size_t half = len / 2;
+        for (std::size_t q = 0; q < x.size(); ++q) {
+            idx[q] += (values[idx[q] + half] < x[q]) ? half : 0;
+        }
+        len -= half;
+    }
+
+    for (std::size_t q = 0; q < x.size(); ++q) {
+        idx[q] += (values[idx[q]] < x[q]) ? 1 : 0;
+    }
+}
+
+PrepDiagnostics try_prep(std::span<const double> eps_cut, PointsView lm, PointsBatch& out,
+                         std::vector<PrepStatus>& status, const ExecutionPolicy& policy)
+{
+    const std::size_t m = eps_cut.size();
+    const std::size_t n = lm.size();
+    status.assign(m, PrepStatus::Ok);
+
+    PrepDiagnostics diagnostics;
+
+    if (n < 2) {
+        std::fill(status.begin(), status.end(), PrepStatus::InvalidCurve);
+        for (std::size_t c = 0; c < m; ++c) {
+            out.append(PointsView());
+            diagnostics.record(PrepStatus::InvalidCurve);
+        }
+        return diagnostics;
+    }
+
+    const auto& eps = lm.get_epsilon();
+    const auto& sig = lm.get_sigma();
+
+    // position of every cut: first breakpoint >= eps_cut
+    // (NaN compares false both ways, so is_sorted alone would let it break the merge)
+    const bool sorted = std::is_sorted(eps_cut.begin(), eps_cut.end())
+        && std::none_of(eps_cut.begin(), eps_cut.end(), [](double x) { return std::isnan(x); });
+
+    std::vector<std::size_t> idx(m);
+    parallelFor(policy, m, [&](std::size_t, std::size_t first, std::size_t last) {
+        if (sorted) {
+            // every block searches for its first cut and merges from there
+            std::size_t k = lowerBound(eps, eps_cut[first]);
+            for (std::size_t c = first; c < last; ++c) {
+                while (k < n && eps[k] < eps_cut[c]) {
+                    ++k;
+                }
+                idx[c] = k;
+            }
+        } else {
+            _lower_bound_batch(eps, eps_cut.subspan(first, last - first),
+                               std::span<std::size_t>(idx.data() + first, last - first));
+        }
+    });
+
+    // slice sizes, then the polygons written in place
+    std::vector<std::size_t> sizes(m, 0);
+    for (std::size_t c = 0; c < m; ++c) {
+        if (!(eps_cut[c] >= eps.front() && eps_cut[c] <= eps.back())) {
+            status[c] = PrepStatus::OutOfRange;
+        } else {
+            sizes[c] = idx[c] + 3;
+        }
+        diagnostics.record(status[c]);
+    }
+
+    const std::size_t first_slice = out.size();
+    out.append_slices(sizes);
+
+    std::span<double> out_eps = out.mutable_epsilon();
+    std::span<double> out_sig = out.mutable_sigma();
+    std::span<const std::size_t> offsets = out.offsets().subspan(first_slice);
+
+    parallelFor(policy, m, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (std::size_t c = first; c < last; ++c) {
+            if (status[c] != PrepStatus::Ok) {
+                continue;
+            }
+
+            // intersection point, interpolated like _preprocess_polyline
+            const std::size_t k = idx[c];
+            double sig_cut;
+            if (eps[k] == eps_cut[c]) {
+                sig_cut = sig[k];
+            } else {
+                double t = (eps_cut[c] - eps[k - 1]) / (eps[k] - eps[k - 1]);
+                sig_cut = sig[k - 1] + t * (sig[k] - sig[k - 1]);
+            }
+
+            double* e = out_eps.data() + offsets[c];
+            double* s = out_sig.data() + offsets[c];
+            for (std::size_t j = 0; j < k; ++j) {
+                e[j] = eps[j];
+                s[j] = sig[j];
+            }
+            e[k] = eps_cut[c];      s[k] = sig_cut;
+            e[k + 1] = eps_cut[c];  s[k + 1] = 0.0;
+            e[k + 2] = eps[0];      s[k + 2] = sig[0];
+        }
+    });
+
+    return diagnostics;
+}
+
+std::size_t prep(std::span<const double> eps_cut, PointsView lm, PointsBatch& out,
+                 std::vector<PrepStatus>& status, const ExecutionPolicy& policy)
+{
+    PrepDiagnostics diagnostics = try_prep(eps_cut, lm, out, status, policy);
+    diagnostics.report("prep");
+    return diagnostics.failures();
+}
+
+PrepResult<std::pair<std::size_t,double>> _try_preprocess_polyline(double eps_cut, const CompiledCurve& curve)
+{
+    PrepResult<CutPoint> cut = curve.try_locate(eps_cut);
+    return {{cut.value.idx, cut.value.sigma}, cut.status};
+}
+
+std::pair<std::size_t,double> _preprocess_polyline(double eps_cut, const CompiledCurve& curve)
+{
+    CutPoint cut = curve.locate(eps_cut);
+    return {cut.idx, cut.sigma};
+}
+
+PrepResult<Points> try_prep(double eps_cut, const CompiledCurve& curve)
+{
+
+    const auto& eps = curve.get_epsilon();
+    const auto& sig = curve.get_sigma();
+
+    PrepResult<std::pair<std::size_t,double>> lookup = _try_preprocess_polyline(eps_cut, curve);
+
+    if (!lookup) {
+        return {Points(), lookup.status};
+    }
+
+    const std::pair<std::size_t,double>& interp = lookup.value;
+
+    PrepResult<Points> result;
+    Points& out = result.value;
+    out.reserve(interp.first + 3);
+
+    out.insert_range(eps, sig, 0, interp.first);
+    out.push_back(eps_cut, interp.second);
+    out.push_back(eps_cut, 0.0);
+    out.push_back(eps[0], sig[0]);
+
+    return result;
+}
+
+Points prep(double eps_cut, const CompiledCurve& curve)
+{
+    PrepResult<Points> polygon = try_prep(eps_cut, curve);
+
+    if (!polygon) {
+        _log_failure(polygon.status, eps_cut, curve.epsilon_front(), curve.epsilon_back());
+        spdlog::error("Preprocessing failed: could not compute intersection point.");
+    }
+
+    return std::move(polygon.value);
 }
 
-}
\ No newline at end of file
+}
@@ -1,10 +1,18 @@
 #pragma once
 
 #include <utility>
+#include <vector>
+#include <span>
 #include <stdexcept>
 #include <algorithm>
 #include <spdlog/spdlog.h>
 #include "points/points.h"
+#include "points/pointsview.h"
+#include "points/pointsbatch.h"
+#include "points/polylinecut.h"
+#include "inputreader/compiledcurve.h"
+#include "inputreader/prepstatus.h"
+#include "parallel/execution.h"
 
 // Arguments:
 //   eps_cut : epsilon value at which the original polyline is trimmed
@@ -15,9 +23,49 @@
 //     - the interpolated point [eps_cut, sig_interp],
 //     - the vertical projection [eps_cut, 0],
 //     - and the initial point [x0, y0] to close the polygon.
+//
+// The try_ functions report failures through their PrepStatus and never log (see
+// prepstatus.h). The others log every failure and return an empty polygon, or the
+// {0, 0.0} sentinel, which is also the valid result of a cut on the first vertex
+// when its sigma is 0.
 
 namespace preprocess{
-    std::pair<std::size_t,double> _preprocess_polyline(double eps_cut, const Points& lm);
+    PrepResult<std::pair<std::size_t,double>> _try_preprocess_polyline(double eps_cut, PointsView lm);
+
+    std::pair<std::size_t,double> _preprocess_polyline(double eps_cut, PointsView lm);
+
+    // Intersection point with the slope of its segment (CutPoint, see compiledcurve.h)
+    CutPoint _preprocess_polyline_derivative(double eps_cut, PointsView lm);
     
-    Points prep(double eps_cut, const Points& lm);
+    PrepResult<Points> try_prep(double eps_cut, PointsView lm);
+
+    Points prep(double eps_cut, PointsView lm);
+
+    // Append the polygon of prep(eps_cut, lm) to out as a new slice. On failure an
+    // empty slice is appended, so slice i still belongs to the i-th call, and false
+    // is returned.
+    bool prep(double eps_cut, PointsView lm, PointsBatch& out);
+
+    // Trim lm at every eps_cut[i] and append the polygons to out, one slice per cut.
+    // Ascending cuts are located with a single merge pass over the breakpoints, other
+    // cuts with a branch-free binary search of all cuts in lockstep. status[i] tells
+    // whether cut i succeeded; a failed cut gets an empty slice. Failures are logged
+    // once for the whole batch, and their number is returned.
+    // Cuts are located and written in blocks run with policy (see parallel/execution.h).
+    std::size_t prep(std::span<const double> eps_cut, PointsView lm, PointsBatch& out,
+                     std::vector<PrepStatus>& status, const ExecutionPolicy& policy = defaultExecution());
+
+    // same without logging; the outcomes are counted in the result
+    PrepDiagnostics try_prep(std::span<const double> eps_cut, PointsView lm, PointsBatch& out,
+                             std::vector<PrepStatus>& status, const ExecutionPolicy& policy = defaultExecution());
+
+    // Same for a compiled curve: no re-validation, Eytzinger search and precomputed
+    // slopes (the intersection point may differ from the Points version in the last bit)
+    PrepResult<std::pair<std::size_t,double>> _try_preprocess_polyline(double eps_cut, const CompiledCurve& curve);
+
+    std::pair<std::size_t,double> _preprocess_polyline(double eps_cut, const CompiledCurve& curve);
+
+    PrepResult<Points> try_prep(double eps_cut, const CompiledCurve& curve);
+
+    Points prep(double eps_cut, const CompiledCurve& curve);
 }
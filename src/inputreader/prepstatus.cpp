@@ -0,0 +1,25 @@
+#include "prepstatus.h"
+#include <spdlog/spdlog.h>
+
+namespace preprocess {
+
+const char* statusName(PrepStatus status)
+{
+    switch (status) {
+        case PrepStatus::Ok:           return "ok";
+        case PrepStatus::InvalidCurve: return "polyline contains fewer than 2 points";
+        case PrepStatus::OutOfRange:   return "eps_cut out of range";
+    }
+    return "unknown";
+}
+
+void PrepDiagnostics::report(const char* where) const
+{
+    if (failures() == 0) {
+        return;
+    }
+    spdlog::error("{}: {} of {} cuts failed ({} out of range, {} on an invalid polyline).",
+            where, failures(), total(), out_of_range, invalid_curve);
+}
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+
+// Error reporting for cuts that cannot be made.
+//
+// The try_ functions of prep, CompiledCurve and Shoelace return a PrepResult and
+// never log: a solver probing outside the curve, or a parallel loop over many cuts,
+// would otherwise serialize on the logger and flood the output. Batch routines
+// count the outcomes in one PrepDiagnostics per block of their parallelFor (sized
+// with blockCount), add them up and log a single summary at the end of the batch.
+// The single-cut functions without try_ keep logging every failure.
+
+namespace preprocess {
+
+    // Outcome of trimming at one cut
+    enum class PrepStatus : unsigned char {
+        Ok = 0,
+        InvalidCurve,   // fewer than 2 points
+        OutOfRange,     // eps_cut outside [epsilon.front(), epsilon.back()] (or NaN)
+    };
+
+    const char* statusName(PrepStatus status);
+
+    // A value, or the reason it could not be computed (like C++23 std::expected).
+    // value is default-initialized when status is not Ok.
+    template<class T>
+    struct PrepResult {
+        T value{};
+        PrepStatus status = PrepStatus::Ok;
+
+        bool ok() const {
+            return status == PrepStatus::Ok;
+        }
+
+        explicit operator bool() const {
+            return ok();
+        }
+    };
+
+    // Outcomes counted over a batch
+    struct PrepDiagnostics {
+        std::size_t ok = 0;
+        std::size_t invalid_curve = 0;
+        std::size_t out_of_range = 0;
+
+        void record(PrepStatus status) {
+            switch (status) {
+                case PrepStatus::Ok:           ++ok; break;
+                case PrepStatus::InvalidCurve: ++invalid_curve; break;
+                case PrepStatus::OutOfRange:   ++out_of_range; break;
+            }
+        }
+
+        std::size_t failures() const {
+            return invalid_curve + out_of_range;
+        }
+
+        std::size_t total() const {
+            return ok + failures();
+        }
+
+        PrepDiagnostics& operator+=(const PrepDiagnostics& other) {
+            ok += other.ok;
+            invalid_curve += other.invalid_curve;
+            out_of_range += other.out_of_range;
+            return *this;
+        }
+
+        // one error line if anything failed, nothing otherwise
+        void report(const char* where) const;
+    };
+
+}
@@ -0,0 +1,179 @@
+#include "continuation.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct TracePoint {
+    double kappa   = 0.0;
+    double eps_ca  = 0.0;
+    double tangent = 0.0;   // d eps_ca / d kappa
+};
+
+double tangent(const SectionCal& cal, double eps_ca, double kappa)
+{
+    ResidualGradient g = cal.forceresidualGradient(eps_ca, kappa);
+    double t = -g.d_kappa / g.d_eps_ca;
+    return std::isfinite(t) ? t : 0.0;
+}
+
+// Solve at kappa from the prediction along the tangent of prev
+bool correct(const SectionCal& cal, const TracePoint& prev, double kappa,
+             const ContinuationOptions& options, TracePoint& next, int& iterations)
+{
+    const double guess = prev.eps_ca + prev.tangent * (kappa - prev.kappa);
+
+    SolveResult r = cal.solve(kappa, guess, options.solver);
+    iterations = r.iterations;
+
+    if (!r.converged || r.iterations > options.max_iterations) {
+        return false;
+    }
+
+    next.kappa = kappa;
+    next.eps_ca = r.eps_ca;
+    next.tangent = tangent(cal, r.eps_ca, kappa);
+    return true;
+}
+
+// Cold solve of the first point
+bool start(const SectionCal& cal, double kappa, const ContinuationOptions& options,
+           TracePoint& point, int& iterations)
+{
+    SolveResult r = cal.solve(kappa, std::numeric_limits<double>::quiet_NaN(), options.solver);
+    iterations = r.iterations;
+
+    if (!r.converged) {
+        return false;
+    }
+
+    point.kappa = kappa;
+    point.eps_ca = r.eps_ca;
+    point.tangent = tangent(cal, r.eps_ca, kappa);
+    return true;
+}
+
+void append(MomentCurvatureCurve& curve, const SectionCal& cal, const TracePoint& point, int iterations)
+{
+    SectionState s = cal.eval(point.eps_ca, point.kappa);
+
+    curve.kappa.push_back(point.kappa);
+    curve.eps_ca.push_back(point.eps_ca);
+    curve.moment.push_back(s.m_ca);
+    curve.iterations.push_back(iterations);
+    curve.states.push_back(s);
+}
+
+} // namespace
+
+MomentCurvatureCurve traceMomentCurvature(const SectionCal& cal, double kappa_start, double kappa_end,
+                                          const ContinuationOptions& options)
+{
+    MomentCurvatureCurve curve;
+
+    TracePoint point;
+    int iterations = 0;
+    if (!start(cal, kappa_start, options, point, iterations)) {
+        spdlog::warn("traceMomentCurvature: no equilibrium at kappa_start={}", kappa_start);
+        return curve;
+    }
+    append(curve, cal, point, iterations);
+
+    const double direction = (kappa_end < kappa_start) ? -1.0 : 1.0;
+    double step = std::min(options.step_initial, options.step_max);
+
+    while (curve.size() < options.max_points) {
+        const double remaining = std::abs(kappa_end - point.kappa);
+        if (remaining == 0.0) {
+            curve.completed = true;
+            break;
+        }
+
+        // land exactly on kappa_end with the last step
+        const double kappa = (step >= remaining) ? kappa_end : point.kappa + direction * step;
+
+        TracePoint next;
+        if (correct(cal, point, kappa, options, next, iterations)) {
+            point = next;
+            append(curve, cal, point, iterations);
+
+            if (iterations <= options.target_iterations) {
+                step = std::min(step * options.grow, options.step_max);
+            } else {
+                // accepted, but the corrector struggled: the next step would be harder still
+                step = std::max(step * options.shrink, options.step_min);
+            }
+        } else {
+            step *= options.shrink;
+            if (step < options.step_min) {
+                spdlog::warn("traceMomentCurvature: step below {} at kappa={}, stopping",
+                        options.step_min, point.kappa);
+                break;
+            }
+        }
+    }
+
+    return curve;
+}
+
+MomentCurvatureCurve traceMomentCurvature(const SectionCal& cal, std::span<const double> kappa,
+                                          const ContinuationOptions& options)
+{
+    MomentCurvatureCurve curve;
+    if (kappa.empty()) {
+        curve.completed = true;
+        return curve;
+    }
+
+    curve.kappa.reserve(kappa.size());
+    curve.eps_ca.reserve(kappa.size());
+    curve.moment.reserve(kappa.size());
+    curve.iterations.reserve(kappa.size());
+    curve.states.reserve(kappa.size());
+
+    TracePoint point;
+    int iterations = 0;
+    if (!start(cal, kappa[0], options, point, iterations)) {
+        spdlog::warn("traceMomentCurvature: no equilibrium at kappa={}", kappa[0]);
+        return curve;
+    }
+    append(curve, cal, point, iterations);
+
+    double step = std::abs(kappa.size() > 1 ? kappa[1] - kappa[0] : 0.0);
+
+    for (std::size_t i = 1; i < kappa.size(); ++i) {
+        const double target = kappa[i];
+        int total_iterations = 0;
+
+        // one step to the grid point, or several smaller ones if the corrector struggles
+        step = std::max(step, std::abs(target - point.kappa));
+        while (point.kappa != target) {
+            const double remaining = std::abs(target - point.kappa);
+            const double k = (step >= remaining) ? target
+                           : point.kappa + std::copysign(step, target - point.kappa);
+
+            TracePoint next;
+            bool ok = correct(cal, point, k, options, next, iterations);
+            total_iterations += iterations;
+
+            if (ok) {
+                point = next;
+                if (iterations > options.target_iterations) {
+                    step = std::max(step * options.shrink, options.step_min);
+                }
+            } else {
+                step *= options.shrink;
+                if (step < options.step_min) {
+                    spdlog::warn("traceMomentCurvature: step below {} at kappa={}, stopping",
+                            options.step_min, point.kappa);
+                    return curve;
+                }
+            }
+        }
+
+        append(curve, cal, point, total_iterations);
+    }
+
+    curve.completed = true;
+    return curve;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <span>
+#include "kappamoment/sectioncal.h"
+
+// Continuation tracing of the moment-curvature curve.
+//
+// Each point is solved from a prediction of the previous one: eps_ca is moved
+// along the tangent d eps_ca / d kappa = -(dR/dkappa) / (dR/deps_ca) of the
+// equilibrium R(eps_ca, kappa) = 0. With a good prediction the Newton corrector
+// converges in one or two steps. Where it needs more (e.g. near softening) the
+// step is shrunk, also after a point that was accepted, and where it converges
+// quickly the step grows again.
+
+struct ContinuationOptions {
+    double step_initial = 1e-7;   // first kappa step of the adaptive trace
+    double step_min     = 1e-12;  // give up below this step
+    double step_max     = 1e-6;
+
+    int    target_iterations = 2; // grow the step if the corrector needs at most this many, shrink it if more
+    int    max_iterations    = 6; // reject and shrink the step if it needs more
+    double grow   = 1.5;
+    double shrink = 0.5;
+
+    std::size_t max_points = 1000000;
+
+    SolverOptions solver;
+};
+
+struct MomentCurvatureCurve {
+    std::vector<double>       kappa;
+    std::vector<double>       eps_ca;
+    std::vector<double>       moment;
+    std::vector<int>          iterations;   // corrector iterations per point
+    std::vector<SectionState> states;
+
+    bool completed = false;   // false if the trace stopped before the last kappa
+
+    std::size_t size() const {
+        return kappa.size();
+    }
+};
+
+// Trace from kappa_start to kappa_end with adaptive steps; all accepted points are returned.
+MomentCurvatureCurve traceMomentCurvature(const SectionCal& cal, double kappa_start, double kappa_end,
+                                          const ContinuationOptions& options = ContinuationOptions());
+
+// Trace through a given, monotonic kappa grid. Grid points that the corrector cannot
+// reach directly are approached in smaller substeps, which are not returned.
+MomentCurvatureCurve traceMomentCurvature(const SectionCal& cal, std::span<const double> kappa,
+                                          const ContinuationOptions& options = ContinuationOptions());
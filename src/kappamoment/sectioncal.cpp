@@ -6,43 +6,438 @@ static inline double clamp(double x, double lo, double hi){
     return std::min(std::max(x, lo), hi);
 }
 
-SectionState SectionCal::eval(double eps_ca, double kappa) const {
-    
+// one error line for the failed cuts of all blocks of a batch
+static void _report(std::span<const preprocess::PrepDiagnostics> blocks, const char* where) {
+    preprocess::PrepDiagnostics total;
+    for (const preprocess::PrepDiagnostics& block : blocks) {
+        total += block;
+    }
+    total.report(where);
+}
+
+SectionState SectionCal::eval(double eps_ca, double kappa, unsigned fields) const {
+    preprocess::PrepDiagnostics diagnostics;
+    SectionState s = _eval(eps_ca, kappa, fields, diagnostics);
+    diagnostics.report("SectionCal::eval");
+    return s;
+}
+
+SectionState SectionCal::_eval(double eps_ca, double kappa, unsigned fields,
+                               preprocess::PrepDiagnostics& diagnostics) const {
+
     SectionState s;
 
     const double h_u = cs.h_u_mm();
     const double h_d = cs.h_d_mm();
     const double h   = cs.height_mm;
 
-    s.eps_cc = std::abs(eps_ca - kappa * h_u);
-    s.eps_ft = std::abs(eps_ca + kappa * h_d);
+    // the geometry is a few flops, the integrals below are what is worth skipping
+    const double eps_cc = std::abs(eps_ca - kappa * h_u);
+    const double eps_ft = std::abs(eps_ca + kappa * h_d);
+
+    const double eps_dt = eps_cc + eps_ft;
 
-    const double eps_dt = s.eps_cc + s.eps_ft;
+    const double h_cc = std::abs((eps_cc/eps_dt) * h);
+    const double h_ft = std::abs((eps_ft/eps_dt) * h);
 
-    s.h_cc = std::abs((s.eps_cc/eps_dt) * h);
-    s.h_ft = std::abs((s.eps_ft/eps_dt) * h);
+    const double jac_cc = h_cc/ eps_cc;
+    const double jac_ft = h_ft/eps_ft;
 
-    s.jac_cc = s.h_cc/ s.eps_cc;
-    s.jac_ft = s.h_ft/s.eps_ft;
+    if (fields & SectionField::eps_cc) s.eps_cc = eps_cc;
+    if (fields & SectionField::eps_ft) s.eps_ft = eps_ft;
+    if (fields & SectionField::h_cc)   s.h_cc = h_cc;
+    if (fields & SectionField::h_ft)   s.h_ft = h_ft;
+    if (fields & SectionField::jac_cc) s.jac_cc = jac_cc;
+    if (fields & SectionField::jac_ft) s.jac_ft = jac_ft;
 
-    std::pair<double,double> m_cc = geom::Shoelace::calculateAreaAndMomentum(preprocess::prep(s.eps_cc, cc));
-    std::pair<double,double> m_ft = geom::Shoelace::calculateAreaAndMomentum(preprocess::prep(s.eps_ft, ft));
+    const bool need_m0 = fields & (SectionField::f_cc | SectionField::f_ft);
+    const bool need_m1 = fields & SectionField::m_ca;
 
-    s.f_cc = m_cc.first * s.jac_cc;
-    s.f_ft = m_ft.first * s.jac_ft;
+    if (need_m0 && need_m1) {
+        // both integrals of a curve share the cut, compute them together
+        preprocess::PrepResult<std::pair<double,double>> m_cc = cc_moments.tryAreaAndMomentum(eps_cc);
+        preprocess::PrepResult<std::pair<double,double>> m_ft = ft_moments.tryAreaAndMomentum(eps_ft);
+        diagnostics.record(m_cc.status);
+        diagnostics.record(m_ft.status);
 
-    s.m_ca = m_cc.second * s.jac_cc * s.jac_cc +
-             m_ft.second * s.jac_ft * s.jac_ft;
+        if (fields & SectionField::f_cc) s.f_cc = m_cc.value.first * jac_cc;
+        if (fields & SectionField::f_ft) s.f_ft = m_ft.value.first * jac_ft;
+
+        s.m_ca = m_cc.value.second * jac_cc * jac_cc +
+                 m_ft.value.second * jac_ft * jac_ft;
+    } else if (need_m0) {
+        if (fields & SectionField::f_cc) {
+            preprocess::PrepResult<double> m0_cc = cc_moments.tryArea(eps_cc);
+            diagnostics.record(m0_cc.status);
+            s.f_cc = m0_cc.value * jac_cc;
+        }
+        if (fields & SectionField::f_ft) {
+            preprocess::PrepResult<double> m0_ft = ft_moments.tryArea(eps_ft);
+            diagnostics.record(m0_ft.status);
+            s.f_ft = m0_ft.value * jac_ft;
+        }
+    } else if (need_m1) {
+        preprocess::PrepResult<double> m1_cc = cc_moments.tryMomentum(eps_cc);
+        preprocess::PrepResult<double> m1_ft = ft_moments.tryMomentum(eps_ft);
+        diagnostics.record(m1_cc.status);
+        diagnostics.record(m1_ft.status);
+
+        s.m_ca = m1_cc.value * jac_cc * jac_cc +
+                 m1_ft.value * jac_ft * jac_ft;
+    }
 
     return s;
 }
 
+static bool same_size(std::span<const double> eps_ca, std::span<const double> kappa, const char* name) {
+    if (eps_ca.size() != kappa.size()) {
+        spdlog::error("{}: eps_ca and kappa must be of the same size ({} != {})",
+                name, eps_ca.size(), kappa.size());
+        return false;
+    }
+    return true;
+}
+
+void SectionCal::evalBatch(std::span<const double> eps_ca, std::span<const double> kappa,
+                           SectionStateBatch& out, unsigned fields, const ExecutionPolicy& policy) const {
+    if (!same_size(eps_ca, kappa, "evalBatch")) {
+        out.resize(0);
+        return;
+    }
+
+    const std::size_t size = eps_ca.size();
+    out.resize(size, fields);
+
+    std::vector<preprocess::PrepDiagnostics> diagnostics(blockCount(policy, size));
+
+    parallelFor(policy, size, [&](std::size_t block, std::size_t first, std::size_t last) {
+        for(size_t i = first; i < last; ++i){
+            SectionState s = _eval(eps_ca[i], kappa[i], fields, diagnostics[block]);
+
+            if (fields & SectionField::eps_cc) out.eps_cc[i] = s.eps_cc;
+            if (fields & SectionField::eps_ft) out.eps_ft[i] = s.eps_ft;
+            if (fields & SectionField::h_cc)   out.h_cc[i]   = s.h_cc;
+            if (fields & SectionField::h_ft)   out.h_ft[i]   = s.h_ft;
+            if (fields & SectionField::jac_cc) out.jac_cc[i] = s.jac_cc;
+            if (fields & SectionField::jac_ft) out.jac_ft[i] = s.jac_ft;
+            if (fields & SectionField::f_cc)   out.f_cc[i]   = s.f_cc;
+            if (fields & SectionField::f_ft)   out.f_ft[i]   = s.f_ft;
+            if (fields & SectionField::m_ca)   out.m_ca[i]   = s.m_ca;
+        }
+    });
+
+    _report(diagnostics, "evalBatch");
+}
+
+void SectionCal::forceresidualBatch(std::span<const double> eps_ca, std::span<const double> kappa,
+                                    std::vector<double>& out, const ExecutionPolicy& policy) const {
+    if (!same_size(eps_ca, kappa, "forceresidualBatch")) {
+        out.clear();
+        return;
+    }
+
+    const std::size_t size = eps_ca.size();
+    out.resize(size);
+
+    std::vector<preprocess::PrepDiagnostics> diagnostics(blockCount(policy, size));
+
+    parallelFor(policy, size, [&](std::size_t block, std::size_t first, std::size_t last) {
+        for(size_t i = first; i < last; ++i){
+            SectionState s = _eval(eps_ca[i], kappa[i], SectionField::f_cc | SectionField::f_ft, diagnostics[block]);
+            out[i] = s.f_cc - s.f_ft;
+        }
+    });
+
+    _report(diagnostics, "forceresidualBatch");
+}
+
+void SectionCal::momentBatch(std::span<const double> eps_ca, std::span<const double> kappa,
+                             std::vector<double>& out, const ExecutionPolicy& policy) const {
+    if (!same_size(eps_ca, kappa, "momentBatch")) {
+        out.clear();
+        return;
+    }
+
+    const std::size_t size = eps_ca.size();
+    out.resize(size);
+
+    std::vector<preprocess::PrepDiagnostics> diagnostics(blockCount(policy, size));
+
+    parallelFor(policy, size, [&](std::size_t block, std::size_t first, std::size_t last) {
+        for(size_t i = first; i < last; ++i){
+            out[i] = _eval(eps_ca[i], kappa[i], SectionField::m_ca, diagnostics[block]).m_ca;
+        }
+    });
+
+    _report(diagnostics, "momentBatch");
+}
+
 double SectionCal::forceresidual(double eps_ca, double kappa) const {
-    auto s = eval(eps_ca, kappa);
+    auto s = eval(eps_ca, kappa, SectionField::f_cc | SectionField::f_ft);
     return s.f_cc - s.f_ft;
 }
 
+ResidualGradient SectionCal::forceresidualGradient(double eps_ca, double kappa) const {
+    preprocess::PrepDiagnostics diagnostics;
+    ResidualGradient g = _forceresidualGradient(eps_ca, kappa, diagnostics);
+    diagnostics.report("SectionCal::forceresidualGradient");
+    return g;
+}
+
+ResidualGradient SectionCal::_forceresidualGradient(double eps_ca, double kappa,
+                                                    preprocess::PrepDiagnostics& diagnostics) const {
+
+    const double h_u = cs.h_u_mm();
+    const double h_d = cs.h_d_mm();
+    const double h   = cs.height_mm;
+
+    const double eps_cc = std::abs(eps_ca - kappa * h_u);
+    const double eps_ft = std::abs(eps_ca + kappa * h_d);
+
+    // d eps_cc / d eps_ca and d eps_ft / d eps_ca
+    const double deps_cc = (eps_ca - kappa * h_u) < 0.0 ? -1.0 : 1.0;
+    const double deps_ft = (eps_ca + kappa * h_d) < 0.0 ? -1.0 : 1.0;
+
+    const double eps_dt = eps_cc + eps_ft;
+
+    // jac_cc = jac_ft = h / eps_dt
+    const double jac = h / eps_dt;
+    const double djac_deps_dt = -h / (eps_dt * eps_dt);
+
+    preprocess::PrepResult<geom::AreaMomentumDerivative> cut_cc = cc_moments.tryAreaAndMomentumDerivative(eps_cc);
+    preprocess::PrepResult<geom::AreaMomentumDerivative> cut_ft = ft_moments.tryAreaAndMomentumDerivative(eps_ft);
+    diagnostics.record(cut_cc.status);
+    diagnostics.record(cut_ft.status);
+
+    const geom::AreaMomentumDerivative& m_cc = cut_cc.value;
+    const geom::AreaMomentumDerivative& m_ft = cut_ft.value;
+
+    const double dm = m_cc.area - m_ft.area;
+
+    ResidualGradient g;
+    g.residual = dm * jac;
+
+    // eps_ca moves both cut strains by +-1
+    g.d_eps_ca = dm * djac_deps_dt * (deps_cc + deps_ft)
+               + (m_cc.darea * deps_cc - m_ft.darea * deps_ft) * jac;
+
+    // kappa moves them by -+h_u and +-h_d
+    const double dk_cc = -h_u * deps_cc;
+    const double dk_ft =  h_d * deps_ft;
+    g.d_kappa = dm * djac_deps_dt * (dk_cc + dk_ft)
+              + (m_cc.darea * dk_cc - m_ft.darea * dk_ft) * jac;
+
+    return g;
+}
+
+std::pair<double,double> SectionCal::forceresidualDerivative(double eps_ca, double kappa) const {
+    ResidualGradient g = forceresidualGradient(eps_ca, kappa);
+    return std::make_pair(g.residual, g.d_eps_ca);
+}
+
 double SectionCal::moment(double eps_ca, double kappa) const {
-    auto s = eval(eps_ca, kappa);
+    auto s = eval(eps_ca, kappa, SectionField::m_ca);
     return s.m_ca;
-}
\ No newline at end of file
+}
+
+std::pair<double,double> SectionCal::bracket(double kappa) const {
+
+    const double h_u = cs.h_u_mm();
+    const double h_d = cs.h_d_mm();
+
+    // neutral axis inside the section: eps_ft = 0 on one end, eps_cc = 0 on the other
+    double lo = std::min(-kappa * h_d, kappa * h_u);
+    double hi = std::max(-kappa * h_d, kappa * h_u);
+
+    // there eps_cc = sign * (kappa * h_u - eps_ca) and eps_ft = sign * (eps_ca + kappa * h_d),
+    // and each has to lie in [epsilon_front(), epsilon_back()] of its curve; a curve
+    // starting above 0 keeps the neutral axis off that end of the section
+    const double sign = kappa > 0.0 ? 1.0 : -1.0;
+    auto clamp = [&](double a, double b) {
+        lo = std::max(lo, std::min(a, b));
+        hi = std::min(hi, std::max(a, b));
+    };
+    clamp(kappa * h_u - sign * cc_moments.epsilon_front(), kappa * h_u - sign * cc_moments.epsilon_back());
+    clamp(-kappa * h_d + sign * ft_moments.epsilon_front(), -kappa * h_d + sign * ft_moments.epsilon_back());
+
+    // stay clear of the curve ends, where rounding could push a cut out of range
+    const double margin = 1e-12 * (hi - lo);
+    if (margin > 0.0) {
+        lo += margin;
+        hi -= margin;
+    }
+
+    return std::make_pair(lo, hi);
+}
+
+SolveResult SectionCal::solve(double kappa, double eps_guess, const SolverOptions& options) const {
+    preprocess::PrepDiagnostics diagnostics;
+    SolveResult result = _solve(kappa, eps_guess, options, diagnostics);
+    diagnostics.report("SectionCal::solve");
+    return result;
+}
+
+SolveResult SectionCal::_solve(double kappa, double eps_guess, const SolverOptions& options,
+                               preprocess::PrepDiagnostics& diagnostics) const {
+
+    // residual and d/d(eps_ca), and the residual alone
+    auto residual_derivative = [&](double eps_ca) {
+        ResidualGradient g = _forceresidualGradient(eps_ca, kappa, diagnostics);
+        return std::make_pair(g.residual, g.d_eps_ca);
+    };
+    auto residual = [&](double eps_ca) {
+        SectionState s = _eval(eps_ca, kappa, SectionField::f_cc | SectionField::f_ft, diagnostics);
+        return s.f_cc - s.f_ft;
+    };
+
+    SolveResult result;
+
+    if (kappa == 0.0) {
+        // no curvature, no strain
+        result.converged = true;
+        return result;
+    }
+
+    std::pair<double,double> range = bracket(kappa);
+    if (!(range.first < range.second)) {
+        result.eps_ca = std::isnan(eps_guess) ? 0.0 : eps_guess;
+        return result;
+    }
+
+    // warm start: plain Newton from the guess as long as the residual drops quickly,
+    // which saves the two residual evaluations of the bracket
+    if (!std::isnan(eps_guess) && eps_guess >= range.first && eps_guess <= range.second) {
+        double x = eps_guess;
+        std::pair<double,double> r = residual_derivative(x);
+
+        while (result.iterations < options.max_iter && r.second != 0.0) {
+            result.iterations++;
+
+            const double dx = r.first / r.second;
+            x -= dx;
+
+            if (std::abs(dx) <= options.tol + options.rtol * std::abs(x)) {
+                result.eps_ca = x;
+                result.converged = true;
+                return result;
+            }
+            if (x < range.first || x > range.second) {
+                break;
+            }
+
+            std::pair<double,double> r_new = residual_derivative(x);
+            if (r_new.first == 0.0) {
+                result.eps_ca = x;
+                result.converged = true;
+                return result;
+            }
+            if (std::abs(r_new.first) > 0.5 * std::abs(r.first)) {
+                // not converging fast enough, continue with the safeguarded iteration
+                eps_guess = x;
+                break;
+            }
+            r = r_new;
+        }
+    }
+
+    double f_lo = residual(range.first);
+    double f_hi = residual(range.second);
+
+    if (f_lo == 0.0 || f_hi == 0.0) {
+        result.eps_ca = (f_lo == 0.0) ? range.first : range.second;
+        result.converged = true;
+        return result;
+    }
+    if ((f_lo < 0.0) == (f_hi < 0.0)) {
+        // no sign change: no equilibrium inside the admissible range
+        result.eps_ca = std::isnan(eps_guess) ? 0.5 * (range.first + range.second) : eps_guess;
+        return result;
+    }
+
+    // orient the bracket so that residual(x_neg) < 0 < residual(x_pos)
+    double x_neg = (f_lo < 0.0) ? range.first : range.second;
+    double x_pos = (f_lo < 0.0) ? range.second : range.first;
+
+    double x = std::isnan(eps_guess) ? 0.5 * (range.first + range.second)
+                                     : clamp(eps_guess, range.first, range.second);
+    const int warm_iterations = result.iterations;
+    double dx_old = range.second - range.first;
+    double dx = dx_old;
+
+    std::pair<double,double> r = residual_derivative(x);
+
+    for (int it = warm_iterations + 1; it <= options.max_iter; ++it) {
+        result.iterations = it;
+
+        const double f = r.first;
+        const double df = r.second;
+
+        // Newton if the step stays inside the bracket and the residual shrinks fast enough
+        const bool outside = ((x - x_pos) * df - f) * ((x - x_neg) * df - f) > 0.0;
+        const bool slow = std::abs(2.0 * f) > std::abs(dx_old * df);
+
+        dx_old = dx;
+        if (outside || slow || df == 0.0) {
+            dx = 0.5 * (x_pos - x_neg);
+            x = x_neg + dx;
+        } else {
+            dx = f / df;
+            x -= dx;
+        }
+
+        if (std::abs(dx) <= options.tol + options.rtol * std::abs(x)) {
+            result.converged = true;
+            break;
+        }
+
+        r = residual_derivative(x);
+
+        if (r.first == 0.0) {
+            result.converged = true;
+            break;
+        }
+        if (r.first < 0.0) {
+            x_neg = x;
+        } else {
+            x_pos = x;
+        }
+    }
+
+    result.eps_ca = x;
+    return result;
+}
+
+SolveBatchResult SectionCal::solveBatch(std::span<const double> kappa,
+                                        std::span<const double> eps_guess,
+                                        const SolverOptions& options,
+                                        const ExecutionPolicy& policy) const {
+
+    const std::size_t size = kappa.size();
+    const bool guessed = eps_guess.size() == size;
+
+    if (!eps_guess.empty() && !guessed) {
+        spdlog::warn("solveBatch: {} initial guesses for {} curvatures ignored", eps_guess.size(), size);
+    }
+
+    SolveBatchResult result;
+    result.eps_ca.resize(size);
+    result.iterations.resize(size);
+    result.converged.resize(size);
+
+    std::vector<preprocess::PrepDiagnostics> diagnostics(blockCount(policy, size));
+
+    parallelFor(policy, size, [&](std::size_t block, std::size_t first, std::size_t last) {
+        for(size_t i = first; i < last; ++i){
+            double guess = guessed ? eps_guess[i] : std::numeric_limits<double>::quiet_NaN();
+            SolveResult r = _solve(kappa[i], guess, options, diagnostics[block]);
+
+            result.eps_ca[i] = r.eps_ca;
+            result.iterations[i] = r.iterations;
+            result.converged[i] = r.converged ? 1 : 0;
+        }
+    });
+
+    _report(diagnostics, "solveBatch");
+
+    return result;
+}
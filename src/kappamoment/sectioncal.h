@@ -1,9 +1,14 @@
 #pragma once
 #include <vector>
+#include <span>
+#include <algorithm>
+#include <limits>
 #include "crosssection.h"
 #include "points/points.h"
 #include "inputreader/prep.h"
 #include "geom/shoelace.h"
+#include "geom/prefixmoments.h"
+#include "parallel/execution.h"
 
 // one kappa, max_eps_ca given 
 
@@ -19,18 +24,163 @@ struct SectionState {
     double m_ca   = 0.0;
 };
 
+// Bits selecting the SectionState fields eval has to compute. Fields that are
+// not requested are left at zero, and m0 / m1 are only integrated if a field
+// depending on them is requested.
+struct SectionField {
+    static constexpr unsigned eps_cc = 1u << 0;
+    static constexpr unsigned eps_ft = 1u << 1;
+    static constexpr unsigned h_cc   = 1u << 2;
+    static constexpr unsigned h_ft   = 1u << 3;
+    static constexpr unsigned jac_cc = 1u << 4;
+    static constexpr unsigned jac_ft = 1u << 5;
+    static constexpr unsigned f_cc   = 1u << 6;   // needs m0 of cc
+    static constexpr unsigned f_ft   = 1u << 7;   // needs m0 of ft
+    static constexpr unsigned m_ca   = 1u << 8;   // needs m1 of cc and ft
+
+    static constexpr unsigned all = (1u << 9) - 1;
+};
+
+// SectionState of many points, one contiguous array per field
+struct SectionStateBatch {
+    std::vector<double> eps_cc;
+    std::vector<double> eps_ft;
+    std::vector<double> h_cc;
+    std::vector<double> h_ft;
+    std::vector<double> jac_cc;
+    std::vector<double> jac_ft;
+    std::vector<double> f_cc;
+    std::vector<double> f_ft;
+    std::vector<double> m_ca;
+
+    // number of points, taken from any field that holds them
+    std::size_t size() const {
+        std::size_t n = 0;
+        for (const std::vector<double>* field : {&eps_cc, &eps_ft, &h_cc, &h_ft, &jac_cc, &jac_ft, &f_cc, &f_ft, &m_ca}) {
+            n = std::max(n, field->size());
+        }
+        return n;
+    }
+
+    void resize(std::size_t n) {
+        for (std::vector<double>* field : {&eps_cc, &eps_ft, &h_cc, &h_ft, &jac_cc, &jac_ft, &f_cc, &f_ft, &m_ca}) {
+            field->resize(n);
+        }
+    }
+
+    // resize the requested fields (SectionField bits) to n, clear the others
+    void resize(std::size_t n, unsigned fields) {
+        std::vector<double>* all[] = {&eps_cc, &eps_ft, &h_cc, &h_ft, &jac_cc, &jac_ft, &f_cc, &f_ft, &m_ca};
+        for (unsigned i = 0; i < 9; ++i) {
+            if (fields & (1u << i)) {
+                all[i]->resize(n);
+            } else {
+                all[i]->clear();
+            }
+        }
+    }
+};
+
+// Force residual with its partial derivatives
+struct ResidualGradient {
+    double residual = 0.0;
+    double d_eps_ca = 0.0;
+    double d_kappa  = 0.0;
+};
+
+// Options of the equilibrium solver: stop when |step| <= tol + rtol * |eps_ca|
+struct SolverOptions {
+    double tol      = 1e-15;
+    double rtol     = 1e-12;
+    int    max_iter = 50;
+};
+
+// Result of one equilibrium solve
+struct SolveResult {
+    double eps_ca     = 0.0;
+    int    iterations = 0;     // residual evaluations after the bracket
+    bool   converged  = false;
+};
+
+// Results of a batch of solves, one entry per kappa
+struct SolveBatchResult {
+    std::vector<double>        eps_ca;
+    std::vector<int>           iterations;
+    std::vector<unsigned char> converged;
+};
+
 class SectionCal{
     public : 
-        SectionCal(const CrossSection&cs,const Points& cc,const Points& ft)
-            : cs(cs), cc(cc), ft(ft) {};
+        SectionCal(const CrossSection&cs,PointsView cc,PointsView ft)
+            : cs(cs), cc_moments(cc), ft_moments(ft) {};
+
+        SectionCal(const CrossSection&cs,const preprocess::CompiledCurve& cc,const preprocess::CompiledCurve& ft)
+            : cs(cs), cc_moments(cc), ft_moments(ft) {};
 
         double forceresidual(double eps_ca, double kappa) const;
 
+        // force residual and its derivative d/d(eps_ca), e.g. as fprime for Newton
+        std::pair<double,double> forceresidualDerivative(double eps_ca, double kappa) const;
+
+        // force residual with d/d(eps_ca) and d/d(kappa)
+        ResidualGradient forceresidualGradient(double eps_ca, double kappa) const;
+
         double moment(double eps_ca, double kappa) const;
 
-        SectionState eval(double eps_ca, double kappa) const;
+        // State at (eps_ca, kappa); only the SectionField bits in fields are computed,
+        // the other fields stay zero.
+        SectionState eval(double eps_ca, double kappa, unsigned fields = SectionField::all) const;
+
+        // Batch versions for arrays of (eps_ca[i], kappa[i]), evaluated in parallel with policy.
+        // Outputs are resized once if needed; nothing is allocated per element.
+        // evalBatch only fills (and keeps allocated) the requested fields.
+        void evalBatch(std::span<const double> eps_ca, std::span<const double> kappa,
+                       SectionStateBatch& out, unsigned fields = SectionField::all,
+                       const ExecutionPolicy& policy = defaultExecution()) const;
+
+        void forceresidualBatch(std::span<const double> eps_ca, std::span<const double> kappa,
+                                std::vector<double>& out,
+                                const ExecutionPolicy& policy = defaultExecution()) const;
+
+        void momentBatch(std::span<const double> eps_ca, std::span<const double> kappa,
+                         std::vector<double>& out,
+                         const ExecutionPolicy& policy = defaultExecution()) const;
+
+        // Interval of eps_ca in which the neutral axis lies inside the section and both
+        // cut strains lie inside their material curves. Empty (first > second) if the
+        // curvature exceeds what the curves cover.
+        std::pair<double,double> bracket(double kappa) const;
+
+        // Equilibrium strain eps_ca with forceresidual(eps_ca, kappa) = 0.
+        // Newton steps from eps_guess, safeguarded by bisection on bracket(kappa).
+        // A good guess converges without evaluating the bracket; a NaN guess starts
+        // from the middle of the bracket.
+        SolveResult solve(double kappa,
+                          double eps_guess = std::numeric_limits<double>::quiet_NaN(),
+                          const SolverOptions& options = SolverOptions()) const;
+
+        // Independent solves for all kappa in parallel. eps_guess is either empty or
+        // holds one initial guess per kappa. Iteration counts differ between curvatures,
+        // which the default (work-stealing) policy balances.
+        SolveBatchResult solveBatch(std::span<const double> kappa,
+                                    std::span<const double> eps_guess = {},
+                                    const SolverOptions& options = SolverOptions(),
+                                    const ExecutionPolicy& policy = defaultExecution()) const;
     private:
+        // The functions above, counting the outcome of every cut in diagnostics instead
+        // of logging it, so that the batches report once instead of from their loops
+        SectionState _eval(double eps_ca, double kappa, unsigned fields,
+                           preprocess::PrepDiagnostics& diagnostics) const;
+
+        ResidualGradient _forceresidualGradient(double eps_ca, double kappa,
+                                                preprocess::PrepDiagnostics& diagnostics) const;
+
+        SolveResult _solve(double kappa, double eps_guess, const SolverOptions& options,
+                           preprocess::PrepDiagnostics& diagnostics) const;
+
         const CrossSection& cs;
-        const Points& cc;
-        const Points& ft;
+
+        // precomputed shoelace sums of cc / ft, answer m0 and m1 at any cut in O(log n)
+        geom::PrefixMoments cc_moments;
+        geom::PrefixMoments ft_moments;
 };
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "memory/arena.h"
+#include <new>
+#include <atomic>
+#include <algorithm>
+
+namespace memory {
+
+static std::atomic<std::size_t> global_allocations{0};
+
+static thread_local Arena* current = nullptr;
+
+static void* global_allocate(std::size_t bytes)
+{
+    global_allocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(bytes, std::align_val_t(Arena::alignment));
+}
+
+static void global_deallocate(void* block)
+{
+    ::operator delete(block, std::align_val_t(Arena::alignment));
+}
+
+Arena::Arena(std::size_t chunk_bytes)
+    : chunk_bytes(round_up(std::max<std::size_t>(chunk_bytes, alignment))),
+      owner(std::this_thread::get_id())
+{
+}
+
+Arena::~Arena()
+{
+    for (Chunk& chunk : chunks) {
+        global_deallocate(chunk.data);
+    }
+}
+
+void* Arena::allocate(std::size_t bytes)
+{
+    bytes = round_up(std::max<std::size_t>(bytes, alignment));
+    ++stats.allocations;
+
+    // a block of this size freed earlier
+    const std::size_t size_class = bytes / alignment;
+    if (size_class < free_lists.size() && free_lists[size_class] != nullptr) {
+        void* block = free_lists[size_class];
+        free_lists[size_class] = *static_cast<void**>(block);
+        ++stats.reuses;
+        return block;
+    }
+
+    // bump the current chunk, move on to the next (kept from an earlier run) or a new one
+    while (chunk_index < chunks.size() && chunk_used + bytes > chunks[chunk_index].bytes) {
+        ++chunk_index;
+        chunk_used = 0;
+    }
+    if (chunk_index == chunks.size()) {
+        Chunk chunk;
+        chunk.bytes = std::max(chunk_bytes, bytes);
+        chunk.data = static_cast<std::byte*>(global_allocate(chunk.bytes));
+        chunks.push_back(chunk);
+        chunk_used = 0;
+        ++stats.chunk_allocations;
+    }
+
+    void* block = chunks[chunk_index].data + chunk_used;
+    chunk_used += bytes;
+    return block;
+}
+
+void Arena::deallocate(void* block, std::size_t bytes)
+{
+    // another thread must not touch the free lists; the block comes back with reset()
+    if (block == nullptr || std::this_thread::get_id() != owner.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    bytes = round_up(std::max<std::size_t>(bytes, alignment));
+    const std::size_t size_class = bytes / alignment;
+    if (size_class >= free_lists.size()) {
+        free_lists.resize(size_class + 1, nullptr);
+    }
+
+    *static_cast<void**>(block) = free_lists[size_class];
+    free_lists[size_class] = block;
+}
+
+void Arena::reset()
+{
+    std::fill(free_lists.begin(), free_lists.end(), nullptr);
+    chunk_index = 0;
+    chunk_used = 0;
+    ++stats.resets;
+}
+
+ArenaScope::ArenaScope(Arena& arena)
+    : previous(current)
+{
+    arena.bind(std::this_thread::get_id());
+    current = &arena;
+}
+
+ArenaScope::~ArenaScope()
+{
+    current = previous;
+}
+
+ThreadArenas::ThreadArenas(std::size_t chunk_bytes)
+    : chunk_bytes(chunk_bytes)
+{
+}
+
+Arena& ThreadArenas::local()
+{
+    const std::thread::id thread = std::this_thread::get_id();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& [id, arena] : arenas) {
+        if (id == thread) {
+            return *arena;
+        }
+    }
+    arenas.emplace_back(thread, std::make_unique<Arena>(chunk_bytes));
+    return *arenas.back().second;
+}
+
+void ThreadArenas::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& [id, arena] : arenas) {
+        arena->reset();
+    }
+}
+
+ArenaCounters ThreadArenas::counters() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ArenaCounters total;
+    for (const auto& [id, arena] : arenas) {
+        total += arena->counters();
+    }
+    return total;
+}
+
+Arena* currentArena()
+{
+    return current;
+}
+
+void* allocate(std::size_t bytes, Arena*& owner)
+{
+    owner = current;
+    if (owner != nullptr) {
+        return owner->allocate(bytes);
+    }
+    return global_allocate(bytes);
+}
+
+void deallocate(void* block, std::size_t bytes, Arena* owner)
+{
+    if (owner != nullptr) {
+        owner->deallocate(block, bytes);
+    } else {
+        global_deallocate(block);
+    }
+}
+
+std::size_t globalAllocationCount()
+{
+    return global_allocations.load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <utility>
+#include <cstddef>
+
+// Arena allocation for temporary vertex storage.
+//
+// An Arena hands out 64-byte aligned blocks from large chunks and keeps freed
+// blocks in per-size free lists, so repeating the same allocations (prep of the
+// same curve at many cuts) reuses memory instead of calling the global allocator.
+// reset() releases everything at once and keeps the chunks for the next run or
+// solve; after the first run a steady state makes no global allocations at all.
+//
+// Points draws its heap block from the arena installed on the calling thread by an
+// ArenaScope. Blocks must not outlive the arena, and reset() invalidates them all;
+// a Points moved or copied out of the scope takes its points to the heap (see
+// points/points.h).
+// An arena is used by one thread at a time; blocks freed on another thread are not
+// reused before the next reset().
+//
+// The library's own batch entry points do not install arenas: batch prep writes
+// into a PointsBatch, the cut functions and SectionCal::solveBatch integrate
+// without building polygons (fused trim, PrefixMoments), and the simulation
+// kernels only read the slices they are given, so none of them allocates Points
+// per item. Arenas are for callers that build Points in their own loops, e.g.
+// many preprocess::prep(eps_cut, lm) calls.
+
+namespace memory {
+
+    struct ArenaCounters {
+        std::size_t allocations = 0;        // blocks handed out
+        std::size_t reuses = 0;             // ... of which came from a free list
+        std::size_t chunk_allocations = 0;  // global allocations made by the arena
+        std::size_t resets = 0;
+
+        ArenaCounters& operator+=(const ArenaCounters& other) {
+            allocations += other.allocations;
+            reuses += other.reuses;
+            chunk_allocations += other.chunk_allocations;
+            resets += other.resets;
+            return *this;
+        }
+    };
+
+    class Arena {
+    public:
+        static constexpr std::size_t alignment = 64;
+        static constexpr std::size_t default_chunk_bytes = 256 * 1024;
+
+        explicit Arena(std::size_t chunk_bytes = default_chunk_bytes);
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* allocate(std::size_t bytes);
+
+        void deallocate(void* block, std::size_t bytes);
+
+        // make all blocks available again, keeping the chunks
+        void reset();
+
+        const ArenaCounters& counters() const {
+            return stats;
+        }
+
+        // thread whose frees are recycled (set by ArenaScope); atomic, as frees of
+        // blocks handed to other threads read it there
+        void bind(std::thread::id thread) {
+            owner.store(thread, std::memory_order_release);
+        }
+
+    private:
+        struct Chunk {
+            std::byte* data = nullptr;
+            std::size_t bytes = 0;
+        };
+
+        static std::size_t round_up(std::size_t bytes) {
+            return (bytes + alignment - 1) / alignment * alignment;
+        }
+
+        std::size_t chunk_bytes;
+
+        std::vector<Chunk> chunks;
+        std::size_t chunk_index = 0;    // chunk being bumped
+        std::size_t chunk_used = 0;
+
+        // free_lists[bytes / alignment]: singly linked through the blocks themselves
+        std::vector<void*> free_lists;
+
+        std::atomic<std::thread::id> owner;
+        ArenaCounters stats;
+    };
+
+    // Installs an arena on the calling thread for the lifetime of the scope
+    class ArenaScope {
+    public:
+        explicit ArenaScope(Arena& arena);
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+    private:
+        Arena* previous;
+    };
+
+    // One arena per thread, for parallel runs on any backend (OpenMP threads, the
+    // workers of parallel/threadpool.h, ...):
+    //     parallelFor(policy, n, [&](std::size_t, std::size_t first, std::size_t last) {
+    //         memory::ArenaScope scope(arenas.local()); ...
+    //     });
+    class ThreadArenas {
+    public:
+        explicit ThreadArenas(std::size_t chunk_bytes = Arena::default_chunk_bytes);
+
+        // arena of the calling thread, created on its first call
+        Arena& local();
+
+        // not while another thread is using one of the arenas
+        void reset();
+
+        ArenaCounters counters() const;
+
+    private:
+        std::size_t chunk_bytes;
+
+        mutable std::mutex mutex;
+        std::vector<std::pair<std::thread::id, std::unique_ptr<Arena>>> arenas;
+    };
+
+    // arena installed on the calling thread, nullptr if none
+    Arena* currentArena();
+
+    // Aligned storage for Points: from the current arena if there is one (owner is set
+    // to it), from the global allocator otherwise (owner is nullptr)
+    void* allocate(std::size_t bytes, Arena*& owner);
+
+    void deallocate(void* block, std::size_t bytes, Arena* owner);
+
+    // global allocations made through this module (Points outside an arena and arena chunks)
+    std::size_t globalAllocationCount();
+
+}
@@ -0,0 +1,324 @@
+#include "parallel/execution.h"
+#include "parallel/threadpool.h"
+#include "parallel/workstealing.h"
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+#ifdef SPLINE_HAVE_PSTL
+    #include <execution>
+#endif
+
+bool executionAvailable(ExecutionBackend backend)
+{
+    switch (backend) {
+        case ExecutionBackend::Serial:
+        case ExecutionBackend::ThreadPool:
+        case ExecutionBackend::WorkStealing:
+            return true;
+        case ExecutionBackend::OpenMP:
+#ifdef _OPENMP
+            return true;
+#else
+            return false;
+#endif
+        case ExecutionBackend::Par:
+#ifdef SPLINE_HAVE_PSTL
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+static ExecutionBackend _effective(ExecutionBackend backend)
+{
+    return executionAvailable(backend) ? backend : ExecutionBackend::ThreadPool;
+}
+
+// threads the backend runs the blocks on
+static std::size_t _workers(const ExecutionPolicy& policy)
+{
+    switch (_effective(policy.backend)) {
+        case ExecutionBackend::Serial:
+            return 1;
+        case ExecutionBackend::OpenMP:
+#ifdef _OPENMP
+            if (policy.threads == 0) {
+                return static_cast<std::size_t>(std::max(omp_get_max_threads(), 1));
+            }
+#endif
+            return policy.threads;
+        case ExecutionBackend::ThreadPool:
+        case ExecutionBackend::WorkStealing:
+            return ThreadPool::resolve(policy.threads);
+        case ExecutionBackend::Par:
+            return ThreadPool::resolve(0);
+    }
+    return 1;
+}
+
+// [0, n) split into blocks: equal ones of size block, or the bounds of the guided ones
+struct ExecutionBlocks {
+    std::size_t n = 0;
+    std::size_t block = 1;
+    std::size_t count = 0;
+    std::vector<std::size_t> bounds;    // count + 1 entries for Guided, empty otherwise
+
+    std::size_t first(std::size_t b) const {
+        return bounds.empty() ? b * block : bounds[b];
+    }
+
+    std::size_t last(std::size_t b) const {
+        return bounds.empty() ? std::min(n, (b + 1) * block) : bounds[b + 1];
+    }
+};
+
+static ExecutionBlocks _partition(const ExecutionPolicy& policy, std::size_t n)
+{
+    ExecutionBlocks blocks;
+    blocks.n = n;
+    if (n == 0) {
+        return blocks;
+    }
+
+    const std::size_t workers = _workers(policy);
+
+    // blocks are the smallest unit a work-stealing worker splits off
+    const bool stealing = _effective(policy.backend) == ExecutionBackend::WorkStealing;
+
+    if (policy.schedule == ExecutionSchedule::Guided && !stealing) {
+        const std::size_t smallest = std::max<std::size_t>(policy.chunk_size, 1);
+        blocks.bounds.push_back(0);
+        for (std::size_t first = 0; first < n; ) {
+            const std::size_t left = n - first;
+            const std::size_t size = std::min(left, std::max(smallest, (left + 2 * workers - 1) / (2 * workers)));
+            first += size;
+            blocks.bounds.push_back(first);
+        }
+        blocks.count = blocks.bounds.size() - 1;
+        return blocks;
+    }
+
+    std::size_t block = policy.chunk_size;
+    if (block == 0) {
+        std::size_t parts = 16 * workers;
+        if (!stealing) {
+            parts = policy.schedule == ExecutionSchedule::Static ? workers : 8 * workers;
+        }
+        block = (n + parts - 1) / parts;
+    }
+    blocks.block = std::max<std::size_t>(block, 1);
+    blocks.count = (n + blocks.block - 1) / blocks.block;
+    return blocks;
+}
+
+std::size_t executionThreads(const ExecutionPolicy& policy)
+{
+    return std::max<std::size_t>(_workers(policy), 1);
+}
+
+std::size_t blockCount(const ExecutionPolicy& policy, std::size_t n)
+{
+    return _partition(policy, n).count;
+}
+
+void parallelFor(const ExecutionPolicy& policy, std::size_t n,
+                 const std::function<void(std::size_t block, std::size_t first, std::size_t last)>& body)
+{
+    const ExecutionBlocks blocks = _partition(policy, n);
+    const std::size_t count = blocks.count;
+    if (count == 0) {
+        return;
+    }
+
+    const auto run = [&](std::size_t b) {
+        body(b, blocks.first(b), blocks.last(b));
+    };
+
+    const ExecutionBackend backend = count == 1 ? ExecutionBackend::Serial : _effective(policy.backend);
+
+    switch (backend) {
+        case ExecutionBackend::Serial: {
+            for (std::size_t b = 0; b < count; ++b) {
+                run(b);
+            }
+            return;
+        }
+
+        case ExecutionBackend::OpenMP: {
+#ifdef _OPENMP
+            const int threads = static_cast<int>(_workers(policy));
+            if (policy.schedule == ExecutionSchedule::Static) {
+                #pragma omp parallel for num_threads(threads) schedule(static)
+                for (std::size_t b = 0; b < count; ++b) {
+                    run(b);
+                }
+            } else {
+                #pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+                for (std::size_t b = 0; b < count; ++b) {
+                    run(b);
+                }
+            }
+#endif
+            return;
+        }
+
+        case ExecutionBackend::ThreadPool: {
+            const std::size_t workers = ThreadPool::resolve(policy.threads);
+            std::atomic<std::size_t> next{0};
+
+            ThreadPool::runShared(policy.threads, [&](std::size_t worker) {
+                if (policy.schedule == ExecutionSchedule::Static) {
+                    const std::size_t first = worker * count / workers;
+                    const std::size_t last = (worker + 1) * count / workers;
+                    for (std::size_t b = first; b < last; ++b) {
+                        run(b);
+                    }
+                } else {
+                    for (std::size_t b = next++; b < count; b = next++) {
+                        run(b);
+                    }
+                }
+            });
+            return;
+        }
+
+        case ExecutionBackend::WorkStealing: {
+            workStealingFor(policy.threads, count, 1, [&](std::size_t first, std::size_t last) {
+                for (std::size_t b = first; b < last; ++b) {
+                    run(b);
+                }
+            });
+            return;
+        }
+
+        case ExecutionBackend::Par: {
+#ifdef SPLINE_HAVE_PSTL
+            std::vector<std::size_t> ids(count);
+            std::iota(ids.begin(), ids.end(), std::size_t(0));
+            std::for_each(std::execution::par, ids.begin(), ids.end(), run);
+#endif
+            return;
+        }
+    }
+}
+
+const char* backendName(ExecutionBackend backend)
+{
+    switch (backend) {
+        case ExecutionBackend::Serial:       return "serial";
+        case ExecutionBackend::OpenMP:       return "openmp";
+        case ExecutionBackend::ThreadPool:   return "threadpool";
+        case ExecutionBackend::Par:          return "par";
+        case ExecutionBackend::WorkStealing: return "worksteal";
+    }
+    return "unknown";
+}
+
+const char* scheduleName(ExecutionSchedule schedule)
+{
+    switch (schedule) {
+        case ExecutionSchedule::Static:  return "static";
+        case ExecutionSchedule::Dynamic: return "dynamic";
+        case ExecutionSchedule::Guided:  return "guided";
+    }
+    return "unknown";
+}
+
+bool parseBackend(const std::string& name, ExecutionBackend& backend)
+{
+    for (ExecutionBackend candidate : {ExecutionBackend::Serial, ExecutionBackend::OpenMP,
+                                       ExecutionBackend::ThreadPool, ExecutionBackend::WorkStealing,
+                                       ExecutionBackend::Par}) {
+        if (name == backendName(candidate)) {
+            backend = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseSchedule(const std::string& name, ExecutionSchedule& schedule)
+{
+    for (ExecutionSchedule candidate : {ExecutionSchedule::Static, ExecutionSchedule::Dynamic,
+                                        ExecutionSchedule::Guided}) {
+        if (name == scheduleName(candidate)) {
+            schedule = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// policy at load time: SPLINE_EXECUTION if set and known, else work stealing
+static ExecutionPolicy initial_policy()
+{
+    ExecutionPolicy policy;
+
+    const char* env = std::getenv("SPLINE_EXECUTION");
+    if (env != nullptr && !parseBackend(env, policy.backend)) {
+        spdlog::warn("SPLINE_EXECUTION={} is unknown, using {}", env, backendName(policy.backend));
+    }
+    return policy;
+}
+
+static std::mutex default_mutex;
+
+static ExecutionPolicy& default_policy()
+{
+    static ExecutionPolicy policy = initial_policy();
+    return policy;
+}
+
+ExecutionPolicy defaultExecution()
+{
+    std::lock_guard<std::mutex> lock(default_mutex);
+    return default_policy();
+}
+
+void setDefaultExecution(const ExecutionPolicy& policy)
+{
+    if (!executionAvailable(policy.backend)) {
+        spdlog::warn("setDefaultExecution: {} is not available in this build, {} is used instead",
+                backendName(policy.backend), backendName(_effective(policy.backend)));
+    }
+    std::lock_guard<std::mutex> lock(default_mutex);
+    default_policy() = policy;
+}
+
+// SPLINE_REPRODUCIBLE set to anything but "", "0", "off" or "false"
+static bool initial_reproducible()
+{
+    const char* env = std::getenv("SPLINE_REPRODUCIBLE");
+    if (env == nullptr) {
+        return false;
+    }
+    const std::string value(env);
+    return !(value.empty() || value == "0" || value == "off" || value == "false");
+}
+
+static std::atomic<bool>& reproducible_mode()
+{
+    static std::atomic<bool> on{initial_reproducible()};
+    return on;
+}
+
+bool reproducible()
+{
+    return reproducible_mode().load(std::memory_order_relaxed);
+}
+
+void setReproducible(bool on)
+{
+    reproducible_mode().store(on, std::memory_order_relaxed);
+}
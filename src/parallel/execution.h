@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <functional>
+#include <vector>
+
+// How the batch functions of the simulation layer run their loops.
+//
+// Every batch entry point takes an ExecutionPolicy (by default the process-wide
+// one, see defaultExecution()) and runs its loop through parallelFor, which splits
+// [0, n) into blocks according to the schedule and hands the blocks to a backend:
+//
+//     Serial      all blocks in order on the calling thread
+//     OpenMP      an OpenMP parallel loop over the blocks
+//     ThreadPool  the library's own pool (parallel/threadpool.h)
+//     WorkStealing the same threads with per-worker deques of blocks and stealing
+//                 (parallel/workstealing.h); the default
+//     Par         std::for_each(std::execution::par, ...) over the blocks; not
+//                 par_unseq, as loop bodies may take locks (e.g. ThreadArenas)
+//
+// OpenMP falls back to ThreadPool in builds without OpenMP, Par in builds
+// without a parallel standard library backend (TBB). The default backend can also
+// be chosen with the environment variable SPLINE_EXECUTION
+// (serial, openmp, threadpool, worksteal, par).
+
+enum class ExecutionBackend {
+    Serial = 0,
+    OpenMP,
+    ThreadPool,
+    Par,
+    WorkStealing,
+};
+
+enum class ExecutionSchedule {
+    Static = 0,     // equal blocks, consecutive blocks on the same thread
+    Dynamic,        // equal blocks, handed out on demand
+    Guided,         // blocks shrinking with the work left, handed out on demand
+};
+
+struct ExecutionPolicy {
+    ExecutionBackend backend = ExecutionBackend::WorkStealing;
+    std::size_t threads = 0;        // 0: all the backend has (ignored by Par)
+
+    // block size (smallest block for Guided); 0 picks one: n / threads for Static,
+    // n / (8 * threads) for Dynamic, 1 for Guided and n / (16 * threads) for
+    // WorkStealing, which ignores the schedule
+    std::size_t chunk_size = 0;
+    ExecutionSchedule schedule = ExecutionSchedule::Static;
+};
+
+// policy used by the batch functions when none is given
+ExecutionPolicy defaultExecution();
+
+void setDefaultExecution(const ExecutionPolicy& policy);
+
+// true if backend runs as itself in this build, rather than through its fallback
+bool executionAvailable(ExecutionBackend backend);
+
+const char* backendName(ExecutionBackend backend);
+
+const char* scheduleName(ExecutionSchedule schedule);
+
+// parse "serial", "openmp", "threadpool", "worksteal" or "par"; false for unknown names
+bool parseBackend(const std::string& name, ExecutionBackend& backend);
+
+// parse "static", "dynamic" or "guided"; false for unknown names
+bool parseSchedule(const std::string& name, ExecutionSchedule& schedule);
+
+// threads parallelFor(policy, ...) runs its blocks on
+std::size_t executionThreads(const ExecutionPolicy& policy);
+
+// number of blocks parallelFor(policy, n, ...) splits [0, n) into, e.g. for
+// per-block partial results
+std::size_t blockCount(const ExecutionPolicy& policy, std::size_t n);
+
+// body(block, first, last) for every block of [0, n), possibly concurrently.
+// Blocks are numbered in order of first, whatever order they run in.
+void parallelFor(const ExecutionPolicy& policy, std::size_t n,
+                 const std::function<void(std::size_t block, std::size_t first, std::size_t last)>& body);
+
+// Bitwise-reproducible reductions (opt-in, off by default).
+//
+// Floating-point sums depend on their order. By default the blocks of parallelReduce
+// follow the policy (and so the thread count), and the Shoelace kernels add in the
+// order of their vector width. In reproducible mode parallelReduce always uses equal
+// blocks of reproducible_block_size, and the Shoelace sums use the ordered kernels
+// (geom/simd/kernels.h), which give the same bits on every instruction set. Results
+// are then identical for any backend, thread count, chunk size and ISA level, at
+// the cost of the fixed blocking and a 4-lane sum on AVX-512. Also set with the
+// environment variable SPLINE_REPRODUCIBLE=1.
+inline constexpr std::size_t reproducible_block_size = std::size_t(1) << 14;
+
+bool reproducible();
+
+void setReproducible(bool on);
+
+// combine(...combine(combine(identity, map(first_0, last_0)), map(first_1, last_1))...)
+// over the blocks of [0, n): the blocks are mapped in parallel and combined in block
+// order, so the result does not depend on which thread ran which block
+template<class T, class Map, class Combine>
+T parallelReduce(const ExecutionPolicy& policy, std::size_t n, T identity, Map map, Combine combine)
+{
+    ExecutionPolicy blocks = policy;
+    if (reproducible()) {
+        // equal blocks of a fixed size, whatever the threads, chunk size and schedule
+        blocks.chunk_size = reproducible_block_size;
+        blocks.schedule = ExecutionSchedule::Static;
+    }
+
+    std::vector<T> partial(blockCount(blocks, n), identity);
+
+    parallelFor(blocks, n, [&](std::size_t block, std::size_t first, std::size_t last) {
+        partial[block] = map(first, last);
+    });
+
+    T result = identity;
+    for (const T& value : partial) {
+        result = combine(result, value);
+    }
+    return result;
+}
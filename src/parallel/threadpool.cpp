@@ -0,0 +1,143 @@
+#include "parallel/threadpool.h"
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+
+// true on the threads of a pool while they run a task, and on the caller during run()
+static thread_local bool inside_pool = false;
+
+// leading positive number of an environment variable (OMP_NUM_THREADS may be a
+// list like "8,2", of which the first level counts); 0 if unset or invalid
+static std::size_t _env_threads(const char* name)
+{
+    const char* env = std::getenv(name);
+    if (env == nullptr || *env == '\0') {
+        return 0;
+    }
+    char* end = nullptr;
+    const long value = std::strtol(env, &end, 10);
+    if (end == env || value <= 0 || (*end != '\0' && *end != ',')) {
+        spdlog::warn("{}={} is not a thread count, ignored", name, env);
+        return 0;
+    }
+    return static_cast<std::size_t>(value);
+}
+
+static std::size_t _initial_threads()
+{
+    for (const char* name : {"SPLINE_THREADS", "OMP_NUM_THREADS"}) {
+        if (std::size_t threads = _env_threads(name)) {
+            return threads;
+        }
+    }
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+std::size_t ThreadPool::defaultThreads()
+{
+    static const std::size_t threads = _initial_threads();
+    return threads;
+}
+
+std::size_t ThreadPool::resolve(std::size_t threads)
+{
+    if (threads == 0) {
+        threads = defaultThreads();
+    }
+    return std::max<std::size_t>(threads, 1);
+}
+
+ThreadPool::ThreadPool(std::size_t threads)
+{
+    const std::size_t total = resolve(threads);
+    workers.reserve(total - 1);
+    for (std::size_t w = 1; w < total; ++w) {
+        workers.emplace_back(&ThreadPool::_work, this, w);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::_work(std::size_t worker)
+{
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        start.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+        const std::function<void(std::size_t)>* task = current;
+
+        lock.unlock();
+        inside_pool = true;
+        (*task)(worker);
+        inside_pool = false;
+        lock.lock();
+
+        if (--pending == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run(const std::function<void(std::size_t worker)>& task)
+{
+    // nested: the workers may be the ones waiting for this call
+    if (inside_pool) {
+        for (std::size_t w = 0; w < size(); ++w) {
+            task(w);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock(run_mutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = &task;
+        pending = workers.size();
+        ++generation;
+    }
+    start.notify_all();
+
+    inside_pool = true;
+    task(0);
+    inside_pool = false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return pending == 0; });
+    current = nullptr;
+}
+
+void ThreadPool::runShared(std::size_t threads, const std::function<void(std::size_t worker)>& task)
+{
+    // one per calling thread, so runs from different threads do not wait on each other
+    thread_local std::unique_ptr<ThreadPool> shared;
+
+    if (inside_pool) {
+        const std::size_t total = resolve(threads);
+        for (std::size_t w = 0; w < total; ++w) {
+            task(w);
+        }
+        return;
+    }
+
+    if (shared == nullptr || shared->size() != resolve(threads)) {
+        shared.reset();
+        shared = std::make_unique<ThreadPool>(threads);
+    }
+    shared->run(task);
+}
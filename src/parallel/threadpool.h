@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Fixed set of worker threads for fork-join loops without OpenMP.
+//
+// run(task) calls task(worker) once for every worker index in [0, size()), the
+// calling thread taking index 0, and returns when all calls have finished. The
+// workers sleep between calls, so a pool is created once and reused.
+//
+// Asking for 0 threads gives defaultThreads(): SPLINE_THREADS, else the first
+// level of OMP_NUM_THREADS, else std::thread::hardware_concurrency(), so that a
+// job given fewer cores by its scheduler or its OpenMP settings stays within them.
+
+class ThreadPool {
+public:
+    // threads - 1 workers are started; 0 means defaultThreads()
+    explicit ThreadPool(std::size_t threads = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // workers including the calling thread
+    std::size_t size() const {
+        return workers.size() + 1;
+    }
+
+    // one run at a time; a run started from inside a task of any pool executes
+    // all indices on the calling thread instead of waiting for busy workers
+    void run(const std::function<void(std::size_t worker)>& task);
+
+    // pool of the calling thread with the given number of threads (0:
+    // defaultThreads()), recreated when a different number is asked for. Runs
+    // from one thread reuse its workers; runs from different threads use
+    // different pools and proceed concurrently.
+    static void runShared(std::size_t threads, const std::function<void(std::size_t worker)>& task);
+
+    // threads a pool created with threads would have
+    static std::size_t resolve(std::size_t threads);
+
+    // threads of a pool asked for 0, read from the environment once
+    static std::size_t defaultThreads();
+
+private:
+    void _work(std::size_t worker);
+
+    std::vector<std::thread> workers;
+
+    std::mutex run_mutex;       // serializes run()
+
+    std::mutex mutex;
+    std::condition_variable start;
+    std::condition_variable done;
+    const std::function<void(std::size_t)>* current = nullptr;
+    std::size_t generation = 0;
+    std::size_t pending = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,167 @@
+#include "parallel/workstealing.h"
+#include "parallel/threadpool.h"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace {
+
+    struct Range {
+        std::size_t first;
+        std::size_t last;
+    };
+
+    // ranges of one worker; the owner works at the back, thieves take the front
+    struct alignas(64) RangeDeque {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+
+        void push_back(Range range) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ranges.push_back(range);
+        }
+
+        bool pop_back(Range& range) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ranges.empty()) {
+                return false;
+            }
+            range = ranges.back();
+            ranges.pop_back();
+            return true;
+        }
+
+        bool steal(Range& range) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ranges.empty()) {
+                return false;
+            }
+            range = ranges.front();
+            ranges.pop_front();
+            return true;
+        }
+    };
+
+    struct StealingLoop {
+        std::size_t grain;
+        const std::function<void(std::size_t, std::size_t)>* body;
+        std::vector<RangeDeque> deques;
+        std::atomic<std::size_t> remaining;     // elements not run yet
+        std::atomic<std::size_t> queued;        // ranges in the deques (may lag behind them)
+
+        // idle workers sleep here until a range is queued or the loop ends
+        std::mutex idle_mutex;
+        std::condition_variable idle;
+        std::atomic<std::size_t> sleepers{0};
+
+        StealingLoop(std::size_t workers, std::size_t n, std::size_t grain,
+                     const std::function<void(std::size_t, std::size_t)>& body)
+            : grain(grain), body(&body), deques(workers), remaining(n), queued(0)
+        {
+            for (std::size_t w = 0; w < workers; ++w) {
+                const std::size_t first = w * n / workers;
+                const std::size_t last = (w + 1) * n / workers;
+                if (first < last) {
+                    deques[w].ranges.push_back({first, last});
+                    ++queued;
+                }
+            }
+        }
+
+        bool find(std::size_t worker, Range& range) {
+            if (deques[worker].pop_back(range)) {
+                --queued;
+                return true;
+            }
+            const std::size_t workers = deques.size();
+            for (std::size_t k = 1; k < workers; ++k) {
+                if (deques[(worker + k) % workers].steal(range)) {
+                    --queued;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // wakes sleepers; the lock orders the notification after their last check
+        void wake(bool all) {
+            if (sleepers.load() == 0) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(idle_mutex);
+            }
+            if (all) {
+                idle.notify_all();
+            } else {
+                idle.notify_one();
+            }
+        }
+
+        void push(RangeDeque& own, Range range) {
+            own.push_back(range);
+            ++queued;
+            wake(false);
+        }
+
+        // the rest is being run by others, or about to be pushed by them
+        void sleep() {
+            std::unique_lock<std::mutex> lock(idle_mutex);
+            ++sleepers;
+            idle.wait(lock, [this] { return queued.load() > 0 || remaining.load() == 0; });
+            --sleepers;
+        }
+
+        void work(std::size_t worker) {
+            RangeDeque& own = deques[worker];
+
+            while (remaining.load(std::memory_order_acquire) > 0) {
+                Range range;
+                if (!find(worker, range)) {
+                    sleep();
+                    continue;
+                }
+
+                // split on demand: keep the lower half, offer the upper one
+                while (range.last - range.first > grain) {
+                    const std::size_t mid = range.first + (range.last - range.first) / 2;
+                    push(own, {mid, range.last});
+                    range.last = mid;
+                }
+
+                (*body)(range.first, range.last);
+                const std::size_t size = range.last - range.first;
+                if (remaining.fetch_sub(size) == size) {
+                    wake(true);
+                }
+            }
+        }
+    };
+
+}
+
+void workStealingFor(std::size_t threads, std::size_t n, std::size_t grain,
+                     const std::function<void(std::size_t first, std::size_t last)>& body)
+{
+    if (n == 0) {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+
+    const std::size_t workers = ThreadPool::resolve(threads);
+    if (workers == 1 || n <= grain) {
+        for (std::size_t first = 0; first < n; first += grain) {
+            body(first, std::min(first + grain, n));
+        }
+        return;
+    }
+
+    StealingLoop loop(workers, n, grain, body);
+    ThreadPool::runShared(threads, [&](std::size_t worker) {
+        loop.work(worker);
+    });
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Work-stealing loop over [0, n) for uneven work (polygons whose size depends on
+// the cut, solves whose iteration count depends on the curvature).
+//
+// Every worker starts with a contiguous share of the range in its own deque. A
+// worker takes ranges from the back of its deque and splits them in halves until
+// they are no larger than grain, pushing the upper halves back; so a worker busy
+// with a large range still leaves work that others can take. An idle worker
+// steals from the front of another worker's deque, where the largest ranges are.
+// The tail of the loop is therefore shared out instead of waiting on the thread
+// that drew the expensive part.
+//
+// Workers are those of the shared ThreadPool (parallel/threadpool.h). A worker
+// that finds nothing to take sleeps until another one pushes a range or the loop
+// ends, rather than spinning on the deques.
+
+// body(first, last) for disjoint ranges covering [0, n), each at most grain long
+// (grain 0 is taken as 1), on threads workers (0: ThreadPool::defaultThreads())
+void workStealingFor(std::size_t threads, std::size_t n, std::size_t grain,
+                     const std::function<void(std::size_t first, std::size_t last)>& body);
@@ -1,19 +1,122 @@
 #pragma once
 #include <vector>
+#include <span>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <functional>
 #include <spdlog/spdlog.h>
+#include "memory/arena.h"
+
+// Vertices of a polyline or polygon, stored as two coordinate arrays.
+//
+// Both arrays share one 64-byte aligned block: epsilon in the first capacity()
+// doubles, sigma in the next ones. capacity() is a multiple of 8, so sigma starts
+// on a 64-byte boundary too. Up to inline_capacity points are kept inside the
+// object itself; most trimmed polygons fit, and need no heap allocation at all.
+// Larger blocks come from the thread's memory::Arena while an ArenaScope is active.
+// Copies allocate from the arena installed where they are made (or the global heap),
+// and so do moves of a Points whose arena is not installed any more; only a Points
+// built or assigned inside a scope and kept past it points into the arena, and must
+// not be used after the arena is reset or destroyed.
 
 struct Points {
 
+public:
+    static constexpr std::size_t alignment = 64;
+    static constexpr std::size_t inline_capacity = 8;
+
 private: // To make sure that epsilon and sigma are always of the same size
-        std::vector<double> epsilon;
-        std::vector<double> sigma;
+        alignas(alignment) double inline_block[2 * inline_capacity];
+        double* block = inline_block;
+        std::size_t count = 0;
+        std::size_t cap = inline_capacity;
+        memory::Arena* owner = nullptr;   // arena of the heap block, nullptr for the global heap
+
+        // capacities are whole cache lines of doubles
+        static std::size_t round_capacity(std::size_t n) {
+            constexpr std::size_t per_line = alignment / sizeof(double);
+            return (n + per_line - 1) / per_line * per_line;
+        }
+
+        bool is_heap() const {
+            return block != inline_block;
+        }
+
+        // values lie in this Points' block
+        bool overlaps(std::span<const double> values) const {
+            const std::less<const double*> less;
+            return !values.empty() && less(values.data(), block + 2 * cap) && less(block, values.data() + values.size());
+        }
+
+        void release() {
+            if (is_heap()) {
+                memory::deallocate(block, 2 * cap * sizeof(double), owner);
+            }
+            block = inline_block;
+            cap = inline_capacity;
+            owner = nullptr;
+        }
+
+        // move to a block of at least n points, keeping the current ones
+        void grow(std::size_t n) {
+            const std::size_t new_cap = round_capacity(std::max(n, 2 * cap));
+            memory::Arena* new_owner = nullptr;
+            double* new_block = static_cast<double*>(
+                memory::allocate(2 * new_cap * sizeof(double), new_owner));
+
+            if (count > 0) {
+                std::memcpy(new_block, block, count * sizeof(double));
+                std::memcpy(new_block + new_cap, block + cap, count * sizeof(double));
+            }
+
+            release();
+            block = new_block;
+            cap = new_cap;
+            owner = new_owner;
+        }
+
+        void assign(const double* eps, const double* sig, std::size_t n) {
+            count = 0;
+            reserve(n);
+            if (n > 0) {
+                std::memcpy(block, eps, n * sizeof(double));
+                std::memcpy(block + cap, sig, n * sizeof(double));
+            }
+            count = n;
+        }
+
+        // take over the heap block of other, or copy its inline points. A block from an
+        // arena that is no longer installed (other was built in an ArenaScope that has
+        // ended) is copied instead, so the points do not follow it into a reset().
+        // That copy allocates, and the moves stay noexcept so std::vector relocates
+        // Points by moving: running out of memory there calls std::terminate.
+        void steal(Points& other) noexcept {
+            if (other.is_heap() && other.owner != nullptr && other.owner != memory::currentArena()) {
+                assign(other.block, other.block + other.cap, other.count);
+                other.release();
+            } else if (other.is_heap()) {
+                block = other.block;
+                cap = other.cap;
+                count = other.count;
+                owner = other.owner;
+                other.block = other.inline_block;
+                other.cap = inline_capacity;
+                other.owner = nullptr;
+            } else {
+                std::copy(other.inline_block, other.inline_block + other.count, inline_block);
+                std::copy(other.inline_block + inline_capacity, other.inline_block + inline_capacity + other.count,
+                          inline_block + inline_capacity);
+                count = other.count;
+            }
+            other.count = 0;
+        }
 
 public:
     Points() = default;
 
     Points(std::size_t n) {
-        epsilon.reserve(n);
-        sigma.reserve(n);
+        reserve(n);
     }
 
     Points(std::vector<double> eps, std::vector<double> sig) {
@@ -21,63 +124,112 @@ public:
             spdlog::error("Points constructor error: epsilon and sigma vectors must be of the same size.");
             return;
         }
-        epsilon = std::move(eps);
-        sigma = std::move(sig);
+        assign(eps.data(), sig.data(), eps.size());
+    }
+
+    Points(const Points& other) {
+        assign(other.block, other.block + other.cap, other.count);
+    }
+
+    Points(Points&& other) noexcept {
+        steal(other);
+    }
+
+    Points& operator=(const Points& other) {
+        if (this != &other) {
+            assign(other.block, other.block + other.cap, other.count);
+        }
+        return *this;
+    }
+
+    Points& operator=(Points&& other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
     }
 
     std::size_t size() const {
-        return epsilon.size();
+        return count;
+    }
+
+    std::size_t capacity() const {
+        return cap;
+    }
+
+    void reserve(std::size_t n) {
+        if (n > cap) {
+            grow(n);
+        }
     }
 
     void clear() {
-        epsilon.clear();
-        sigma.clear();
+        count = 0;
     }
 
     void push_back(double eps, double sig) {
-        epsilon.push_back(eps);
-        sigma.push_back(sig);
+        if (count == cap) {
+            grow(count + 1);
+        }
+        block[count] = eps;
+        block[cap + count] = sig;
+        ++count;
     }
 
-    const std::vector<double>& get_epsilon() const {
-        return epsilon;
+    std::span<const double> get_epsilon() const {
+        return std::span<const double>(block, count);
     }
 
-    const std::vector<double>& get_sigma() const {
-        return sigma;
+    std::span<const double> get_sigma() const {
+        return std::span<const double>(block + cap, count);
     }
 
-    // push back a range of points from given vectors
-    void insert_range(const std::vector<double>& eps, const std::vector<double>& sig, std::size_t start, std::size_t end)
+    // push back a range of points from given arrays, which may be this Points' own
+    void insert_range(std::span<const double> eps, std::span<const double> sig, std::size_t start, std::size_t end)
     {
 
         // check for valid range
-        if (eps.size() != sig.size())
+        if (eps.size() != sig.size() || start > end || end > eps.size())
         {
             // invalid range -> return without inserting
             spdlog::warn("insert_range: invalid range ignored");
             return;
         }
-        
-        epsilon.insert(epsilon.end(), eps.begin() + start, eps.begin() + end);
-        sigma.insert(sigma.end(), sig.begin() + start, sig.begin() + end);
+
+        const std::size_t n = end - start;
+
+        // growing frees the block the range would be read from: copy it out first
+        if (count + n > cap && (overlaps(eps) || overlaps(sig))) {
+            std::vector<double> eps_copy(eps.begin() + start, eps.begin() + end);
+            std::vector<double> sig_copy(sig.begin() + start, sig.begin() + end);
+            insert_range(eps_copy, sig_copy, 0, n);
+            return;
+        }
+
+        reserve(count + n);
+        std::copy(eps.begin() + start, eps.begin() + end, block + count);
+        std::copy(sig.begin() + start, sig.begin() + end, block + cap + count);
+        count += n;
     }
 
 
     void change_point(std::size_t index, double eps, double sig) {
-        if (index < epsilon.size()) {
-            epsilon[index] = eps;
-            sigma[index] = sig;
+        if (index < count) {
+            block[index] = eps;
+            block[cap + index] = sig;
         }
     }
 
     void print() const {
         spdlog::info("Points:");
-        for (std::size_t i = 0; i < epsilon.size(); ++i) {
-            spdlog::info("  ({}, {})", epsilon[i], sigma[i]);
+        for (std::size_t i = 0; i < count; ++i) {
+            spdlog::info("  ({}, {})", block[i], block[cap + i]);
         }
     }
 
-    ~Points() = default;
+    ~Points() {
+        release();
+    }
     //delete points not implemented.
 };
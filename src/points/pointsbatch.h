@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstddef>
+#include "points/points.h"
+#include "points/pointsview.h"
+
+// Many polygons (e.g. timeslices) stored back to back, CSR style: the vertices of
+// slice i are epsilon()/sigma()[offsets()[i], offsets()[i + 1]).
+//
+// Unlike std::vector<Points> this is three allocations in total, and walking all
+// slices reads memory front to back. Views returned by operator[] point into the
+// batch and are invalidated by appending.
+class PointsBatch {
+public:
+    PointsBatch() = default;
+
+    // number of slices
+    std::size_t size() const {
+        return offset_data.size() - 1;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // number of points over all slices
+    std::size_t total_points() const {
+        return eps.size();
+    }
+
+    void reserve(std::size_t slices, std::size_t points) {
+        offset_data.reserve(slices + 1);
+        eps.reserve(points);
+        sig.reserve(points);
+    }
+
+    void clear() {
+        eps.clear();
+        sig.clear();
+        offset_data.assign(1, 0);
+    }
+
+    // start a new slice with the points of polygon
+    void append(PointsView polygon) {
+        const StridedSpan e = polygon.get_epsilon();
+        const StridedSpan s = polygon.get_sigma();
+        if (polygon.contiguous()) {
+            eps.insert(eps.end(), e.data(), e.data() + e.size());
+            sig.insert(sig.end(), s.data(), s.data() + s.size());
+        } else {
+            for (std::size_t i = 0; i < polygon.size(); ++i) {
+                eps.push_back(e[i]);
+                sig.push_back(s[i]);
+            }
+        }
+        offset_data.push_back(eps.size());
+    }
+
+    // add a point to the last slice (a new slice if there is none)
+    void push_back(double epsilon, double sigma) {
+        if (offset_data.size() == 1) {
+            offset_data.push_back(0);
+        }
+        eps.push_back(epsilon);
+        sig.push_back(sigma);
+        offset_data.back() = eps.size();
+    }
+
+    // append one slice per entry of sizes, of that many zero points, to be filled
+    // through mutable_epsilon() / mutable_sigma() (by several threads at once, say)
+    void append_slices(std::span<const std::size_t> sizes) {
+        offset_data.reserve(offset_data.size() + sizes.size());
+        std::size_t end = eps.size();
+        for (std::size_t n : sizes) {
+            end += n;
+            offset_data.push_back(end);
+        }
+        eps.resize(end);
+        sig.resize(end);
+    }
+
+    PointsView operator[](std::size_t i) const {
+        const std::size_t first = offset_data[i];
+        const std::size_t n = offset_data[i + 1] - first;
+        return PointsView(std::span<const double>(eps.data() + first, n),
+                          std::span<const double>(sig.data() + first, n));
+    }
+
+    std::span<const double> epsilon() const {
+        return eps;
+    }
+
+    std::span<const double> sigma() const {
+        return sig;
+    }
+
+    std::span<const std::size_t> offsets() const {
+        return offset_data;
+    }
+
+    std::span<double> mutable_epsilon() {
+        return eps;
+    }
+
+    std::span<double> mutable_sigma() {
+        return sig;
+    }
+
+private:
+    std::vector<double> eps;
+    std::vector<double> sig;
+    std::vector<std::size_t> offset_data = {0};
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <spdlog/spdlog.h>
+#include "points/points.h"
+
+// Read-only array of doubles with a fixed distance (in elements) between entries,
+// e.g. one column of an interleaved [eps, sig, eps, sig, ...] buffer.
+class StridedSpan {
+public:
+    StridedSpan() = default;
+
+    StridedSpan(const double* data, std::size_t size, std::ptrdiff_t stride = 1)
+        : ptr(data), count(size), step(stride) {}
+
+    StridedSpan(std::span<const double> values)
+        : ptr(values.data()), count(values.size()), step(1) {}
+
+    StridedSpan(const std::vector<double>& values)
+        : ptr(values.data()), count(values.size()), step(1) {}
+
+    double operator[](std::size_t i) const {
+        return ptr[static_cast<std::ptrdiff_t>(i) * step];
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    double front() const {
+        return ptr[0];
+    }
+
+    double back() const {
+        return (*this)[count - 1];
+    }
+
+    const double* data() const {
+        return ptr;
+    }
+
+    std::ptrdiff_t stride() const {
+        return step;
+    }
+
+    bool contiguous() const {
+        return step == 1 || count <= 1;
+    }
+
+    StridedSpan subspan(std::size_t first, std::size_t n) const {
+        return StridedSpan(ptr + static_cast<std::ptrdiff_t>(first) * step, n, step);
+    }
+
+private:
+    const double* ptr = nullptr;
+    std::size_t count = 0;
+    std::ptrdiff_t step = 1;
+};
+
+// Non-owning view of polyline / polygon vertices (epsilon, sigma).
+//
+// Every routine that only reads vertices takes a PointsView, so data held elsewhere
+// (NumPy buffers, mapped files, slices of a longer curve) is used without a copy.
+// A Points converts to a view implicitly; the view must not outlive the data.
+class PointsView {
+public:
+    PointsView() = default;
+
+    PointsView(const Points& points)
+        : eps(points.get_epsilon()), sig(points.get_sigma()) {}
+
+    PointsView(StridedSpan epsilon, StridedSpan sigma) {
+        if (epsilon.size() != sigma.size()) {
+            spdlog::error("PointsView error: epsilon and sigma must be of the same size.");
+            return;
+        }
+        eps = epsilon;
+        sig = sigma;
+    }
+
+    PointsView(std::span<const double> epsilon, std::span<const double> sigma)
+        : PointsView(StridedSpan(epsilon), StridedSpan(sigma)) {}
+
+    std::size_t size() const {
+        return eps.size();
+    }
+
+    bool empty() const {
+        return eps.empty();
+    }
+
+    StridedSpan get_epsilon() const {
+        return eps;
+    }
+
+    StridedSpan get_sigma() const {
+        return sig;
+    }
+
+    // both coordinates stored without gaps, usable by the SIMD kernels
+    bool contiguous() const {
+        return eps.contiguous() && sig.contiguous();
+    }
+
+    // points [first, first + n)
+    PointsView subview(std::size_t first, std::size_t n) const {
+        return PointsView(eps.subspan(first, n), sig.subspan(first, n));
+    }
+
+    // owning copy
+    Points to_points() const {
+        Points out(size());
+        for (std::size_t i = 0; i < size(); ++i) {
+            out.push_back(eps[i], sig[i]);
+        }
+        return out;
+    }
+
+private:
+    StridedSpan eps;
+    StridedSpan sig;
+};
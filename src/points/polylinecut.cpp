@@ -0,0 +1,35 @@
+#include "polylinecut.h"
+
+preprocess::PrepResult<PolylineCut> locateCut(double eps_cut, PointsView lm)
+{
+    const std::size_t n = lm.size();
+    if (n < 2) {
+        return {PolylineCut{}, preprocess::PrepStatus::InvalidCurve};
+    }
+
+    const auto& eps = lm.get_epsilon();
+    const auto& sig = lm.get_sigma();
+
+    // Check valid domain (written so that NaN fails too)
+    if (!(eps_cut >= eps.front() && eps_cut <= eps.back())) {
+        return {PolylineCut{}, preprocess::PrepStatus::OutOfRange};
+    }
+
+    std::size_t idx = lowerBound(eps, eps_cut);
+
+    // Exact match: sigma without interpolation
+    if (idx < n && eps[idx] == eps_cut) {
+        return {PolylineCut{idx, sig[idx]}, preprocess::PrepStatus::Ok};
+    }
+
+    // Bracketing indices must exist
+    if (idx == 0 || idx >= n) {
+        return {PolylineCut{}, preprocess::PrepStatus::OutOfRange};
+    }
+
+    const std::size_t i = idx - 1;
+    const std::size_t j = idx;
+
+    double t = (eps_cut - eps[i]) / (eps[j] - eps[i]);
+    return {PolylineCut{idx, sig[i] + t * (sig[j] - sig[i])}, preprocess::PrepStatus::Ok};
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include "points/pointsview.h"
+#include "inputreader/prepstatus.h"
+
+// Where a vertical cut at eps_cut meets a polyline (epsilon ascending).
+//
+// preprocess::prep builds the trimmed polygon from it and geom::Shoelace integrates
+// the same polygon without building it, so both locate the cut here and agree on
+// the intersection point to the last bit.
+
+struct PolylineCut {
+    std::size_t idx = 0;    // first vertex with epsilon >= eps_cut
+    double sigma = 0.0;     // sigma at eps_cut, interpolated on segment [idx - 1, idx]
+};
+
+// std::lower_bound over a (possibly strided) ascending array
+inline std::size_t lowerBound(const StridedSpan& values, double x)
+{
+    std::size_t first = 0;
+    std::size_t count = values.size();
+    while (count > 0) {
+        std::size_t half = count / 2;
+        if (values[first + half] < x) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+// The cut of lm at eps_cut, or why there is none; never logs. Out of line, so that
+// every caller interpolates with the same instructions.
+preprocess::PrepResult<PolylineCut> locateCut(double eps_cut, PointsView lm);
@@ -1,14 +1,31 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 
 #include "points/points.h"
 #include "inputreader/prep.h"
+#include "inputreader/csvreader.h"
 #include "geom/shoelace.h"
+#include "geom/prefixmoments.h"
+#include "geom/shoelaceaccumulator.h"
+#include "geom/simd/isa.h"
+#include "simulation/simulation.h"
 #include "kappamoment/crosssection.h"
 #include "kappamoment/sectioncal.h"
+#include "kappamoment/continuation.h"
+#include "storage/columnfile.h"
+#include "storage/resultwriter.h"
+#include "simulation/pipeline.h"
 
 namespace py = pybind11;
 
+// PointsViews into a column file; holds the file so that its mapping outlives them
+// (a list of views cannot, as lists do not take keep_alive)
+struct BatchViews {
+    py::object file;
+    std::vector<PointsView> views;
+};
+
 PYBIND11_MODULE(splinepy, m){
     m.doc() = "Spline / Shoelace bindings";
 
@@ -18,11 +35,116 @@ PYBIND11_MODULE(splinepy, m){
         .def(py::init<std::vector<double>, std::vector<double>>(), py::arg("epsilon_vec"), py::arg("sigma_vec"))
         .def("size", &Points::size)
         .def("add_point", &Points::push_back, py::arg("epsilon"), py::arg("sigma"))
-        .def("get_epsilon", &Points::get_epsilon)
-        .def("get_sigma", &Points::get_sigma);
+        .def("get_epsilon", [](const Points& points) {
+            std::span<const double> eps = points.get_epsilon();
+            return std::vector<double>(eps.begin(), eps.end());
+        })
+        .def("get_sigma", [](const Points& points) {
+            std::span<const double> sig = points.get_sigma();
+            return std::vector<double>(sig.begin(), sig.end());
+        });
+
+    // views of any 1-d float64 buffer (NumPy arrays, memoryviews), strided or contiguous
+    auto column = [](const py::buffer& values, const char* name) {
+        py::buffer_info info = values.request();
+        if (info.ndim != 1 || info.format != py::format_descriptor<double>::format()
+            || info.strides[0] % static_cast<py::ssize_t>(sizeof(double)) != 0) {
+            throw py::value_error(std::string(name) + " must be a 1-d float64 buffer");
+        }
+        return StridedSpan(static_cast<const double*>(info.ptr), static_cast<std::size_t>(info.shape[0]),
+                           info.strides[0] / static_cast<py::ssize_t>(sizeof(double)));
+    };
+
+    py::class_<PointsView>(m, "PointsView")
+        .def(py::init<const Points&>(), py::arg("points"), py::keep_alive<1, 2>())
+        .def(py::init([column](const py::buffer& epsilon, const py::buffer& sigma) {
+            return PointsView(column(epsilon, "epsilon"), column(sigma, "sigma"));
+        }), "Zero-copy view of two float64 arrays", py::arg("epsilon"), py::arg("sigma"),
+            py::keep_alive<1, 2>(), py::keep_alive<1, 3>())
+        .def("size", &PointsView::size)
+        .def("contiguous", &PointsView::contiguous)
+        .def("subview", &PointsView::subview, py::arg("first"), py::arg("n"), py::keep_alive<0, 1>())
+        .def("to_points", &PointsView::to_points);
+
+    py::implicitly_convertible<Points, PointsView>();
+
+    py::class_<PointsBatch>(m, "PointsBatch")
+        .def(py::init<>())
+        .def("size", &PointsBatch::size)
+        .def("total_points", &PointsBatch::total_points)
+        .def("reserve", &PointsBatch::reserve, py::arg("slices"), py::arg("points"))
+        .def("clear", &PointsBatch::clear)
+        .def("append", &PointsBatch::append, py::arg("polygon"))
+        .def("add_point", &PointsBatch::push_back, py::arg("epsilon"), py::arg("sigma"))
+        .def("__len__", &PointsBatch::size)
+        .def("__getitem__", [](const PointsBatch& batch, std::size_t i) {
+            if (i >= batch.size()) {
+                throw py::index_error();
+            }
+            return batch[i].to_points();
+        }, py::arg("i"));
+
+    py::enum_<preprocess::PrepStatus>(m, "PrepStatus")
+        .value("Ok", preprocess::PrepStatus::Ok)
+        .value("InvalidCurve", preprocess::PrepStatus::InvalidCurve)
+        .value("OutOfRange", preprocess::PrepStatus::OutOfRange);
+
+    m.def("preprocess_batch", [](const std::vector<double>& eps_cut, const Points& lm) {
+        PointsBatch batch;
+        std::vector<preprocess::PrepStatus> status;
+        preprocess::prep(eps_cut, lm, batch, status);
+        return py::make_tuple(std::move(batch), std::move(status));
+    }, "Preprocess lm at every eps_cut into one PointsBatch; returns (batch, status per cut)",
+       py::arg("eps_cut"), py::arg("lm"));
+
+    m.def("cal_area_momentum_timeslices", [](const PointsBatch& batch) {
+        py::gil_scoped_release release;
+        return computeAreaAndMomentumTimeslices(batch);
+    }, "Area and momentum of every slice of a PointsBatch", py::arg("batch"));
+
+    py::class_<preprocess::TargetTable>(m, "TargetTable")
+        .def_readonly("kappa", &preprocess::TargetTable::kappa)
+        .def_readonly("eps_0", &preprocess::TargetTable::eps_0)
+        .def_readonly("moment", &preprocess::TargetTable::moment)
+        .def("__len__", &preprocess::TargetTable::size);
+
+    m.def("read_curve", [](const std::string& path, char delimiter) {
+        preprocess::CsvOptions options;
+        options.delimiter = delimiter;
+        py::gil_scoped_release release;
+        return preprocess::readCurve(path, options);
+    }, "Read an epsilon,sigma curve from a CSV file (empty Points on error)",
+       py::arg("path"), py::arg("delimiter") = ',');
+
+    m.def("read_target_table", [](const std::string& path, char delimiter) {
+        preprocess::CsvOptions options;
+        options.delimiter = delimiter;
+        py::gil_scoped_release release;
+        return preprocess::readTargetTable(path, options);
+    }, "Read a k,eps_0,M_tar table such as k_eps0_M.csv (empty on error)",
+       py::arg("path"), py::arg("delimiter") = ',');
 
-    m.def("preprocess", &preprocess::prep, "Preprocess polyline to polygon for Shoelace calculation"
+    py::class_<preprocess::CompiledCurve>(m, "CompiledCurve")
+        .def(py::init<const Points&>(), py::arg("lm"))
+        .def("valid", &preprocess::CompiledCurve::valid)
+        .def("size", &preprocess::CompiledCurve::size)
+        .def("get_epsilon", &preprocess::CompiledCurve::get_epsilon)
+        .def("get_sigma", &preprocess::CompiledCurve::get_sigma)
+        .def("lower_bound", py::overload_cast<double>(&preprocess::CompiledCurve::lower_bound, py::const_),
+             py::arg("eps_cut"))
+        .def("locate", [](const preprocess::CompiledCurve& curve, double eps_cut) {
+            preprocess::CutPoint cut = curve.locate(eps_cut);
+            return py::make_tuple(cut.idx, cut.sigma, cut.dsigma);
+        }, "(idx, sigma, dsigma/deps_cut)", py::arg("eps_cut"));
+
+    m.def("preprocess", py::overload_cast<double, PointsView>(&preprocess::prep), "Preprocess polyline to polygon for Shoelace calculation"
+    , py::arg("eps_cut"), py::arg("lm"));
+    m.def("preprocess", py::overload_cast<double, const preprocess::CompiledCurve&>(&preprocess::prep), "Preprocess compiled curve to polygon for Shoelace calculation"
     , py::arg("eps_cut"), py::arg("lm"));
+    m.def("try_preprocess", [](double eps_cut, PointsView lm) {
+        preprocess::PrepResult<Points> polygon = preprocess::try_prep(eps_cut, lm);
+        return py::make_tuple(std::move(polygon.value), polygon.status);
+    }, "Preprocess without logging; returns (polygon, status)", py::arg("eps_cut"), py::arg("lm"));
 
     m.def("cal_area", &geom::Shoelace::calculateArea, "Calculate area using Shoelace formula"
     , py::arg("points"));
@@ -32,6 +154,104 @@ PYBIND11_MODULE(splinepy, m){
     , py::arg("points"));
     m.def("cal_area_momentum_simd", &geom::Shoelace::calculateAreaAndMomentum_simd, "Calculate area and momentum using Shoelace formula with SIMD"
     , py::arg("points"));
+    m.def("cal_area_momentum_parallel", [](PointsView points, std::size_t chunk_size) {
+        ExecutionPolicy policy = defaultExecution();
+        policy.chunk_size = chunk_size;
+        return geom::Shoelace::calculateAreaAndMomentumParallel(points, policy);
+    }, "Area and momentum of one polygon with its edges split across threads (chunk_size edges per block, 0: default)"
+    , py::arg("points"), py::arg("chunk_size") = 0);
+    m.def("cal_trimmed_area_momentum", py::overload_cast<double, PointsView>(&geom::Shoelace::calculateTrimmedAreaAndMomentum), "Area and momentum of preprocess(eps_cut, lm) without building the polygon"
+    , py::arg("eps_cut"), py::arg("lm"));
+    m.def("cal_trimmed_area_momentum", py::overload_cast<double, const preprocess::CompiledCurve&>(&geom::Shoelace::calculateTrimmedAreaAndMomentum), "Area and momentum of preprocess(eps_cut, lm) without building the polygon"
+    , py::arg("eps_cut"), py::arg("lm"));
+    m.def("try_cal_trimmed_area_momentum", [](double eps_cut, const preprocess::CompiledCurve& curve) {
+        preprocess::PrepResult<std::pair<double,double>> result = geom::Shoelace::tryTrimmedAreaAndMomentum(eps_cut, curve);
+        return py::make_tuple(result.value, result.status);
+    }, "cal_trimmed_area_momentum without logging; returns ((area, momentum), status)", py::arg("eps_cut"), py::arg("lm"));
+
+    py::class_<geom::ShoelaceAccumulator>(m, "ShoelaceAccumulator")
+        .def(py::init<>(), "Shoelace sums of a polygon given in chunks of vertices, in O(1) memory")
+        .def("add", [](geom::ShoelaceAccumulator& accumulator, const std::vector<double>& eps, const std::vector<double>& sig) {
+            if (eps.size() != sig.size()) {
+                throw py::value_error("eps and sig must have the same length");
+            }
+            accumulator.add(std::span<const double>(eps), std::span<const double>(sig));
+        }, "Append vertices in order", py::arg("eps"), py::arg("sig"))
+        .def("add_vertex", py::overload_cast<double, double>(&geom::ShoelaceAccumulator::add), py::arg("eps"), py::arg("sig"))
+        .def("vertices", &geom::ShoelaceAccumulator::vertices)
+        .def("finalize", &geom::ShoelaceAccumulator::finalize, "(area, momentum) of the polygon closed back to its first vertex")
+        .def("reset", &geom::ShoelaceAccumulator::reset);
+    m.def("accumulate_area_momentum", [](const std::string& path, std::size_t chunk_bytes) {
+        preprocess::CsvOptions options;
+        options.chunk_bytes = chunk_bytes;
+        return geom::accumulateAreaAndMomentum(path, options);
+    }, "Area and momentum of the curve of a CSV file as a closed polygon, read chunk by chunk",
+    py::arg("path"), py::arg("chunk_bytes") = preprocess::CsvOptions().chunk_bytes);
+
+    m.def("detect_isa", []() { return std::string(geom::simd::isaName(geom::simd::detectIsa())); },
+    "Best instruction set supported by this CPU");
+    m.def("active_isa", []() { return std::string(geom::simd::isaName(geom::simd::activeIsa())); },
+    "Instruction set used by the Shoelace kernels");
+    m.def("set_isa", [](const std::string& name) {
+        geom::simd::Isa isa;
+        if (!geom::simd::parseIsa(name, isa)) {
+            throw py::value_error("unknown instruction set: " + name);
+        }
+        return geom::simd::setIsa(isa);
+    }, "Force the instruction set of the Shoelace kernels (scalar, sse2, avx2, avx512)"
+    , py::arg("isa"));
+
+    m.def("set_execution", [](const std::string& backend, std::size_t threads, std::size_t chunk_size,
+                              const std::string& schedule) {
+        ExecutionPolicy policy;
+        if (!parseBackend(backend, policy.backend)) {
+            throw py::value_error("unknown execution backend: " + backend);
+        }
+        if (!parseSchedule(schedule, policy.schedule)) {
+            throw py::value_error("unknown schedule: " + schedule);
+        }
+        policy.threads = threads;
+        policy.chunk_size = chunk_size;
+        setDefaultExecution(policy);
+        return executionAvailable(policy.backend);
+    }, "Execution of the batch functions (serial, openmp, threadpool, worksteal, par; static, dynamic, guided)",
+    py::arg("backend"), py::arg("threads") = 0, py::arg("chunk_size") = 0, py::arg("schedule") = "static");
+    m.def("execution", []() {
+        const ExecutionPolicy policy = defaultExecution();
+        return py::make_tuple(backendName(policy.backend), policy.threads, policy.chunk_size,
+                              scheduleName(policy.schedule));
+    }, "Current (backend, threads, chunk_size, schedule) of the batch functions");
+    m.def("set_reproducible", &setReproducible,
+    "Fixed-order reductions that give the same bits for every thread count and instruction set"
+    , py::arg("on"));
+    m.def("reproducible", &reproducible, "True if reductions are bitwise reproducible");
+
+    py::class_<geom::PolygonMatrix>(m, "PolygonMatrix")
+        .def(py::init([](const std::vector<Points>& polygons) {
+            return geom::PolygonMatrix(polygons);
+        }), py::arg("polygons"))
+        .def("size", &geom::PolygonMatrix::size)
+        .def("vertices", &geom::PolygonMatrix::vertices);
+
+    m.def("cal_area_momentum_batch", [](const geom::PolygonMatrix& polygons) {
+        std::vector<double> area(polygons.size());
+        std::vector<double> momentum(polygons.size());
+        geom::Shoelace::calculateAreaAndMomentumBatch(polygons, area, momentum);
+        return std::make_pair(area, momentum);
+    }, "Calculate area and momentum of many polygons, one polygon per SIMD lane"
+    , py::arg("polygons"));
+
+    py::class_<geom::PrefixMoments>(m, "PrefixMoments")
+        .def(py::init<const Points&>(), py::arg("lm"))
+        .def(py::init<const preprocess::CompiledCurve&>(), py::arg("curve"))
+        .def("size", &geom::PrefixMoments::size)
+        .def("cal_area", &geom::PrefixMoments::calculateArea, py::arg("eps_cut"))
+        .def("cal_momentum", &geom::PrefixMoments::calculateMomentum, py::arg("eps_cut"))
+        .def("cal_area_momentum", &geom::PrefixMoments::calculateAreaAndMomentum, py::arg("eps_cut"))
+        .def("cal_area_momentum_derivative", [](const geom::PrefixMoments& table, double eps_cut) {
+            geom::AreaMomentumDerivative d = table.calculateAreaAndMomentumDerivative(eps_cut);
+            return py::make_tuple(d.area, d.momentum, d.darea, d.dmomentum);
+        }, "(m0, m1, dm0/deps_cut, dm1/deps_cut)", py::arg("eps_cut"));
 
     py::class_ <CrossSection>(m, "CrossSection")
         .def(py::init<double, double, double, double>(),
@@ -57,16 +277,243 @@ PYBIND11_MODULE(splinepy, m){
         .def_readwrite("f_ft", &SectionState::f_ft)
         .def_readwrite("m_ca", &SectionState::m_ca);
 
+    py::class_<SectionField>(m, "SectionField")
+        .def_readonly_static("eps_cc", &SectionField::eps_cc)
+        .def_readonly_static("eps_ft", &SectionField::eps_ft)
+        .def_readonly_static("h_cc", &SectionField::h_cc)
+        .def_readonly_static("h_ft", &SectionField::h_ft)
+        .def_readonly_static("jac_cc", &SectionField::jac_cc)
+        .def_readonly_static("jac_ft", &SectionField::jac_ft)
+        .def_readonly_static("f_cc", &SectionField::f_cc)
+        .def_readonly_static("f_ft", &SectionField::f_ft)
+        .def_readonly_static("m_ca", &SectionField::m_ca)
+        .def_readonly_static("all", &SectionField::all);
+
+    py::class_<SectionStateBatch>(m, "SectionStateBatch")
+        .def(py::init<>())
+        .def("size", &SectionStateBatch::size)
+        .def_readwrite("eps_cc", &SectionStateBatch::eps_cc)
+        .def_readwrite("eps_ft", &SectionStateBatch::eps_ft)
+        .def_readwrite("h_cc", &SectionStateBatch::h_cc)
+        .def_readwrite("h_ft", &SectionStateBatch::h_ft)
+        .def_readwrite("jac_cc", &SectionStateBatch::jac_cc)
+        .def_readwrite("jac_ft", &SectionStateBatch::jac_ft)
+        .def_readwrite("f_cc", &SectionStateBatch::f_cc)
+        .def_readwrite("f_ft", &SectionStateBatch::f_ft)
+        .def_readwrite("m_ca", &SectionStateBatch::m_ca);
+
+    py::class_<SolverOptions>(m, "SolverOptions")
+        .def(py::init<>())
+        .def_readwrite("tol", &SolverOptions::tol)
+        .def_readwrite("rtol", &SolverOptions::rtol)
+        .def_readwrite("max_iter", &SolverOptions::max_iter);
+
+    py::class_<SolveResult>(m, "SolveResult")
+        .def(py::init<>())
+        .def_readwrite("eps_ca", &SolveResult::eps_ca)
+        .def_readwrite("iterations", &SolveResult::iterations)
+        .def_readwrite("converged", &SolveResult::converged);
+
+    py::class_<SolveBatchResult>(m, "SolveBatchResult")
+        .def(py::init<>())
+        .def_readwrite("eps_ca", &SolveBatchResult::eps_ca)
+        .def_readwrite("iterations", &SolveBatchResult::iterations)
+        .def_readwrite("converged", &SolveBatchResult::converged);
+
     py::class_<SectionCal>(m, "SectionCal")
         .def(py::init<const CrossSection&, const Points&, const Points&>(),
              py::arg("cs"), py::arg("cc"), py::arg("ft"),
              py::keep_alive<1, 2>(),
              py::keep_alive<1, 3>(),
              py::keep_alive<1, 4>())
+        .def(py::init<const CrossSection&, const preprocess::CompiledCurve&, const preprocess::CompiledCurve&>(),
+             py::arg("cs"), py::arg("cc"), py::arg("ft"),
+             py::keep_alive<1, 2>())
         .def("forceresidual", &SectionCal::forceresidual,
              py::arg("eps_ca"), py::arg("kappa"))
+        .def("forceresidual_derivative", &SectionCal::forceresidualDerivative,
+             "(residual, d residual / d eps_ca)",
+             py::arg("eps_ca"), py::arg("kappa"))
+        .def("forceresidual_prime", [](const SectionCal& cal, double eps_ca, double kappa) {
+                return cal.forceresidualDerivative(eps_ca, kappa).second;
+             }, py::arg("eps_ca"), py::arg("kappa"))
         .def("moment", &SectionCal::moment,
              py::arg("eps_ca"), py::arg("kappa"))
         .def("eval", &SectionCal::eval,
-             py::arg("eps_ca"), py::arg("kappa"));
+             py::arg("eps_ca"), py::arg("kappa"), py::arg("fields") = SectionField::all)
+        .def("eval_batch", [](const SectionCal& cal, const std::vector<double>& eps_ca, const std::vector<double>& kappa,
+                              unsigned fields) {
+                py::gil_scoped_release release;
+                SectionStateBatch out;
+                cal.evalBatch(eps_ca, kappa, out, fields);
+                return out;
+             }, py::arg("eps_ca"), py::arg("kappa"), py::arg("fields") = SectionField::all)
+        .def("forceresidual_batch", [](const SectionCal& cal, const std::vector<double>& eps_ca, const std::vector<double>& kappa) {
+                py::gil_scoped_release release;
+                std::vector<double> out;
+                cal.forceresidualBatch(eps_ca, kappa, out);
+                return out;
+             }, py::arg("eps_ca"), py::arg("kappa"))
+        .def("moment_batch", [](const SectionCal& cal, const std::vector<double>& eps_ca, const std::vector<double>& kappa) {
+                py::gil_scoped_release release;
+                std::vector<double> out;
+                cal.momentBatch(eps_ca, kappa, out);
+                return out;
+             }, py::arg("eps_ca"), py::arg("kappa"))
+        .def("bracket", &SectionCal::bracket, py::arg("kappa"))
+        .def("solve", &SectionCal::solve,
+             py::arg("kappa"),
+             py::arg("eps_guess") = std::numeric_limits<double>::quiet_NaN(),
+             py::arg("options") = SolverOptions())
+        .def("solve_batch", [](const SectionCal& cal, const std::vector<double>& kappa,
+                               const std::vector<double>& eps_guess, const SolverOptions& options) {
+                py::gil_scoped_release release;
+                return cal.solveBatch(kappa, eps_guess, options);
+             },
+             "Solve the equilibrium for all kappa in parallel",
+             py::arg("kappa"),
+             py::arg("eps_guess") = std::vector<double>(),
+             py::arg("options") = SolverOptions());
+
+    py::class_<ContinuationOptions>(m, "ContinuationOptions")
+        .def(py::init<>())
+        .def_readwrite("step_initial", &ContinuationOptions::step_initial)
+        .def_readwrite("step_min", &ContinuationOptions::step_min)
+        .def_readwrite("step_max", &ContinuationOptions::step_max)
+        .def_readwrite("target_iterations", &ContinuationOptions::target_iterations)
+        .def_readwrite("max_iterations", &ContinuationOptions::max_iterations)
+        .def_readwrite("grow", &ContinuationOptions::grow)
+        .def_readwrite("shrink", &ContinuationOptions::shrink)
+        .def_readwrite("max_points", &ContinuationOptions::max_points)
+        .def_readwrite("solver", &ContinuationOptions::solver);
+
+    py::class_<MomentCurvatureCurve>(m, "MomentCurvatureCurve")
+        .def(py::init<>())
+        .def("size", &MomentCurvatureCurve::size)
+        .def_readwrite("kappa", &MomentCurvatureCurve::kappa)
+        .def_readwrite("eps_ca", &MomentCurvatureCurve::eps_ca)
+        .def_readwrite("moment", &MomentCurvatureCurve::moment)
+        .def_readwrite("iterations", &MomentCurvatureCurve::iterations)
+        .def_readwrite("states", &MomentCurvatureCurve::states)
+        .def_readwrite("completed", &MomentCurvatureCurve::completed);
+
+    m.def("trace_moment_curvature", [](const SectionCal& cal, double kappa_start, double kappa_end,
+                                       const ContinuationOptions& options) {
+        py::gil_scoped_release release;
+        return traceMomentCurvature(cal, kappa_start, kappa_end, options);
+    }, "Trace M(kappa) from kappa_start to kappa_end with adaptive continuation steps"
+    , py::arg("cal"), py::arg("kappa_start"), py::arg("kappa_end"), py::arg("options") = ContinuationOptions());
+
+    m.def("trace_moment_curvature_grid", [](const SectionCal& cal, const std::vector<double>& kappa,
+                                            const ContinuationOptions& options) {
+        py::gil_scoped_release release;
+        return traceMomentCurvature(cal, kappa, options);
+    }, "Trace M(kappa) through a given kappa grid with warm-started solves"
+    , py::arg("cal"), py::arg("kappa"), py::arg("options") = ContinuationOptions());
+
+    py::enum_<storage::Compression>(m, "Compression")
+        .value("NONE", storage::Compression::None)
+        .value("DEFLATE", storage::Compression::Deflate);
+
+    // read-only NumPy array over a column, keeping the file alive
+    auto column_array = [](const py::object& owner, const auto* data, std::size_t count) {
+        using T = std::remove_cv_t<std::remove_pointer_t<decltype(data)>>;
+        py::array_t<T> array({static_cast<py::ssize_t>(count)}, {static_cast<py::ssize_t>(sizeof(T))}, data, owner);
+        array.attr("setflags")(py::arg("write") = false);
+        return array;
+    };
+
+    py::class_<storage::ColumnFile>(m, "ColumnFile")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def("valid", &storage::ColumnFile::valid)
+        .def("names", [](const storage::ColumnFile& file) {
+            std::vector<std::string> names;
+            for (const storage::ColumnInfo& column : file.columns()) {
+                names.push_back(column.name);
+            }
+            return names;
+        })
+        .def("__contains__", &storage::ColumnFile::contains)
+        .def("column", [column_array](py::object self, const std::string& name) -> py::object {
+            const storage::ColumnFile& file = self.cast<const storage::ColumnFile&>();
+            for (const storage::ColumnInfo& column : file.columns()) {
+                if (column.name != name) {
+                    continue;
+                }
+                if (column.type == storage::ColumnType::Float64) {
+                    std::span<const double> values = file.doubles(name);
+                    return column_array(self, values.data(), values.size());
+                }
+                std::span<const std::uint64_t> values = file.integers(name);
+                return column_array(self, values.data(), values.size());
+            }
+            throw py::key_error(name);
+        }, "Zero-copy, read-only NumPy array of a column", py::arg("name"));
+
+    m.def("write_curve", &storage::writeCurve, "Write a curve as a binary column file"
+    , py::arg("path"), py::arg("curve"), py::arg("compression") = storage::Compression::None);
+    m.def("write_batch", &storage::writeBatch, "Write a PointsBatch as a binary column file"
+    , py::arg("path"), py::arg("batch"), py::arg("compression") = storage::Compression::None);
+    m.def("write_moments", [](const std::string& path, const std::vector<std::pair<double,double>>& moments,
+                              storage::Compression compression) {
+        return storage::writeMoments(path, moments, compression);
+    }, "Write (m0, m1) pairs as columns m0, m1", py::arg("path"), py::arg("moments"),
+       py::arg("compression") = storage::Compression::None);
+    m.def("write_section_states", &storage::writeSectionStates, "Write the fields of a SectionStateBatch as columns"
+    , py::arg("path"), py::arg("states"), py::arg("compression") = storage::Compression::None);
+    m.def("curve_view", &storage::curveView, "Zero-copy PointsView of a curve file"
+    , py::arg("file"), py::keep_alive<0, 1>());
+    py::class_<BatchViews>(m, "BatchViews")
+        .def("__len__", [](const BatchViews& batch) { return batch.views.size(); })
+        .def("__getitem__", [](const BatchViews& batch, std::size_t i) {
+            if (i >= batch.views.size()) {
+                throw py::index_error("slice index out of range");
+            }
+            return batch.views[i];
+        }, py::arg("i"), py::keep_alive<0, 1>());
+    m.def("batch_views", [](py::object file) {
+        return BatchViews{file, storage::batchViews(file.cast<const storage::ColumnFile&>())};
+    }, "Zero-copy PointsViews of the slices of a batch file", py::arg("file"));
+
+    py::class_<storage::ResultWriter>(m, "ResultWriter")
+        .def(py::init([](const std::string& path, std::vector<std::string> names, std::size_t chunk_rows) {
+            const std::size_t columns = names.size();
+            return std::make_unique<storage::ResultWriter>(storage::openResultSink(path, std::move(names)),
+                                                           columns, chunk_rows);
+        }), "Asynchronous writer of result columns (.csv: text, otherwise column file)",
+            py::arg("path"), py::arg("names"), py::arg("chunk_rows") = storage::ResultWriter::default_chunk_rows)
+        .def("append", [](storage::ResultWriter& writer, const std::vector<std::vector<double>>& columns) {
+            std::vector<std::span<const double>> spans(columns.begin(), columns.end());
+            writer.append(std::span<const std::span<const double>>(spans));
+        }, "Append rows given as one list per column", py::arg("columns"))
+        .def("close", &storage::ResultWriter::close, py::call_guard<py::gil_scoped_release>())
+        .def("rows_appended", &storage::ResultWriter::rows_appended);
+
+    m.def("cal_area_momentum_cuts_to", [](const std::vector<double>& eps_cut, const preprocess::CompiledCurve& curve,
+                                          storage::ResultWriter& out) {
+        py::gil_scoped_release release;
+        computeAreaAndMomentumCuts(eps_cut, curve, out);
+    }, "Stream (m0, m1) of every cut into a ResultWriter", py::arg("eps_cut"), py::arg("curve"), py::arg("out"));
+
+    py::class_<PipelineResult>(m, "PipelineResult")
+        .def_readonly("timesteps", &PipelineResult::timesteps)
+        .def_readonly("chunks", &PipelineResult::chunks)
+        .def_readonly("ok", &PipelineResult::ok)
+        .def_property_readonly("failures", [](const PipelineResult& result) { return result.diagnostics.failures(); });
+
+    m.def("run_pipeline", [](const std::string& path, PointsView lm, double eps_first, double eps_last,
+                             std::size_t count, std::size_t chunk_size, std::size_t queue_depth) {
+        PipelineResult result;
+        std::unique_ptr<storage::ResultSink> sink = storage::openResultSink(path, {"eps", "m0", "m1"});
+        if (sink == nullptr) {
+            return result;
+        }
+        py::gil_scoped_release release;
+        result = runPipeline(linearStrains(eps_first, eps_last, count), lm, *sink,
+                             PipelineOptions{chunk_size, queue_depth});
+        result.ok = sink->close() && result.ok;
+        return result;
+    }, "Stream eps, m0, m1 of count evenly spaced cuts to a file (.csv: text, otherwise column file)",
+        py::arg("path"), py::arg("lm"), py::arg("eps_first"), py::arg("eps_last"), py::arg("count"),
+        py::arg("chunk_size") = PipelineOptions().chunk_size, py::arg("queue_depth") = PipelineOptions().queue_depth);
 }
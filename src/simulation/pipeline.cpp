@@ -0,0 +1,164 @@
+#include "simulation/pipeline.h"
+#include "simulation/boundedqueue.h"
+#include "points/pointsbatch.h"
+#include "inputreader/prep.h"
+#include "geom/shoelace.h"
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+StrainGenerator linearStrains(double first, double last, std::size_t count)
+{
+    const double step = count > 1 ? (last - first) / static_cast<double>(count - 1) : 0.0;
+    std::size_t next = 0;
+
+    return [=](std::span<double> out) mutable {
+        const std::size_t n = std::min(out.size(), count - next);
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = first + step * static_cast<double>(next + i);
+        }
+        next += n;
+        return n;
+    };
+}
+
+StrainGenerator strainsFrom(std::span<const double> eps)
+{
+    std::size_t next = 0;
+
+    return [=](std::span<double> out) mutable {
+        const std::size_t n = std::min(out.size(), eps.size() - next);
+        std::copy_n(eps.begin() + next, n, out.begin());
+        next += n;
+        return n;
+    };
+}
+
+// One chunk of timesteps as it moves through the stages
+struct PipelineChunk {
+    std::vector<std::vector<double>> columns;   // eps, m0, m1 (capacity chunk_size)
+    std::size_t rows = 0;
+
+    PointsBatch slices;
+    std::vector<preprocess::PrepStatus> status;
+    preprocess::PrepDiagnostics diagnostics;
+};
+
+using ChunkQueue = BoundedQueue<std::unique_ptr<PipelineChunk>>;
+
+// strains -> trimmed polygons
+static void _prep_stage(StrainGenerator& strains, PointsView lm, const ExecutionPolicy& policy,
+                        ChunkQueue& free, ChunkQueue& prepared)
+{
+    while (std::optional<std::unique_ptr<PipelineChunk>> next = free.pop()) {
+        PipelineChunk& chunk = **next;
+        std::vector<double>& eps = chunk.columns[0];
+
+        chunk.rows = strains(std::span<double>(eps.data(), eps.size()));
+        if (chunk.rows == 0) {
+            break;
+        }
+
+        chunk.slices.clear();
+        chunk.diagnostics = preprocess::try_prep(std::span<const double>(eps.data(), chunk.rows), lm,
+                                                 chunk.slices, chunk.status, policy);
+
+        if (!prepared.push(std::move(*next))) {
+            break;
+        }
+    }
+    prepared.close();
+}
+
+// trimmed polygons -> m0, m1
+static void _kernel_stage(const ExecutionPolicy& policy, ChunkQueue& prepared, ChunkQueue& computed)
+{
+    while (std::optional<std::unique_ptr<PipelineChunk>> next = prepared.pop()) {
+        PipelineChunk& chunk = **next;
+        std::vector<double>& m0 = chunk.columns[1];
+        std::vector<double>& m1 = chunk.columns[2];
+        const std::size_t rows = chunk.rows;
+
+        parallelFor(policy, rows, [&](std::size_t, std::size_t first, std::size_t last) {
+            for(size_t i = first; i < last; ++i){
+                const std::pair<double,double> am = geom::Shoelace::calculateAreaAndMomentum(chunk.slices[i]);
+                m0[i] = am.first;
+                m1[i] = am.second;
+            }
+        });
+
+        if (!computed.push(std::move(*next))) {
+            break;
+        }
+    }
+    computed.close();
+}
+
+PipelineStages pipelineStages(const ExecutionPolicy& execution)
+{
+    const std::size_t threads = executionThreads(execution);
+
+    PipelineStages stages{execution, execution};
+    if (execution.backend != ExecutionBackend::Serial) {
+        stages.prep.threads = threads - threads / 2;
+        stages.kernel.threads = std::max<std::size_t>(threads / 2, 1);
+    }
+    return stages;
+}
+
+PipelineResult runPipeline(StrainGenerator strains, PointsView lm, storage::ResultSink& sink,
+                           const PipelineOptions& options)
+{
+    const std::size_t chunk_size = std::max<std::size_t>(options.chunk_size, 1);
+    const std::size_t queue_depth = std::max<std::size_t>(options.queue_depth, 1);
+
+    // one chunk in every stage and queue_depth in each of the two queues between them
+    const std::size_t pool_size = queue_depth * 2 + 3;
+
+    ChunkQueue free(pool_size);
+    ChunkQueue prepared(queue_depth);
+    ChunkQueue computed(queue_depth);
+
+    for (std::size_t c = 0; c < pool_size; ++c) {
+        auto chunk = std::make_unique<PipelineChunk>();
+        chunk->columns.assign(3, std::vector<double>(chunk_size));
+        free.push(std::move(chunk));
+    }
+
+    // each stage thread gets its own share of threads, and with the pool backends
+    // its own pool, so prep of one chunk runs while the kernel works on another
+    const PipelineStages stages = pipelineStages(options.execution);
+    std::thread prep_thread(_prep_stage, std::ref(strains), lm, std::cref(stages.prep), std::ref(free), std::ref(prepared));
+    std::thread kernel_thread(_kernel_stage, std::cref(stages.kernel), std::ref(prepared), std::ref(computed));
+
+    // sink stage, on the calling thread
+    PipelineResult result;
+    result.ok = true;
+
+    while (std::optional<std::unique_ptr<PipelineChunk>> next = computed.pop()) {
+        PipelineChunk& chunk = **next;
+
+        // after a failure the remaining chunks are drained, not written
+        if (result.ok) {
+            result.ok = sink.write(chunk.columns, chunk.rows);
+            if (!result.ok) {
+                spdlog::error("runPipeline: sink failed after {} timesteps.", result.timesteps);
+                free.close();
+                continue;
+            }
+
+            result.timesteps += chunk.rows;
+            ++result.chunks;
+            result.diagnostics += chunk.diagnostics;
+            free.push(std::move(*next));
+        }
+    }
+
+    prep_thread.join();
+    kernel_thread.join();
+
+    result.diagnostics.report("runPipeline");
+
+    return result;
+}
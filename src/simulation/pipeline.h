@@ -0,0 +1,64 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include "points/pointsview.h"
+#include "inputreader/prepstatus.h"
+#include "storage/resultwriter.h"
+#include "parallel/execution.h"
+
+// Streaming timeslice pipeline with bounded memory.
+//
+// The functions in simulation.h take every eps value at once and return every
+// result. runPipeline instead pulls the strains chunk by chunk and passes each
+// chunk through three stages running on their own threads:
+//
+//     strains -> prep (PointsBatch) -> moment kernel (m0, m1) -> sink (eps, m0, m1)
+//
+// Stages are connected by bounded queues, and the chunks themselves come from a
+// fixed pool that the sink hands back to the first stage, so memory is
+// O(chunk_size * (queue_depth * 2 + 3)) however long the load history is, and the
+// buffers are reused rather than reallocated. Prep and the kernel are parallel
+// within a chunk and split the threads of options.execution between them (see
+// pipelineStages), so the stages overlap across chunks.
+
+// Fills out with the next strains and returns how many it wrote (at most
+// out.size()); 0 ends the history
+using StrainGenerator = std::function<std::size_t(std::span<double>)>;
+
+// count strains from first to last, spaced evenly (first + step * i)
+StrainGenerator linearStrains(double first, double last, std::size_t count);
+
+// the values of eps in order; eps must outlive the generator. A column of a
+// storage::ColumnFile is read through the mapping, so it need not fit in memory.
+StrainGenerator strainsFrom(std::span<const double> eps);
+
+struct PipelineOptions {
+    std::size_t chunk_size = 1 << 14;   // timesteps per chunk
+    std::size_t queue_depth = 2;        // chunks waiting between two stages
+    ExecutionPolicy execution = defaultExecution();     // of prep and the kernel within a chunk
+};
+
+struct PipelineResult {
+    std::size_t timesteps = 0;          // rows given to the sink
+    std::size_t chunks = 0;
+    preprocess::PrepDiagnostics diagnostics;
+    bool ok = false;                    // false if the sink failed
+};
+
+// policies prep and the kernel run with: the threads of execution shared out,
+// prep getting the larger half since trimming costs more than the kernel
+struct PipelineStages {
+    ExecutionPolicy prep;
+    ExecutionPolicy kernel;
+};
+
+PipelineStages pipelineStages(const ExecutionPolicy& execution);
+
+// Trim lm at every strain of strains, compute area and momentum of the polygons and
+// write the columns eps, m0, m1 to sink, in order. Failed cuts are written as
+// (0, 0) and logged once at the end. The sink is not closed.
+PipelineResult runPipeline(StrainGenerator strains, PointsView lm, storage::ResultSink& sink,
+                           const PipelineOptions& options = PipelineOptions());
@@ -1,55 +1,220 @@
 #include "simulation/simulation.h"
+#include <algorithm>
 
 
-#if OMP 
-    include <omp.h>
-#endif
-
-//#include <omp.h>
+static preprocess::PrepDiagnostics _sum(std::span<const preprocess::PrepDiagnostics> parts)
+{
+    preprocess::PrepDiagnostics total;
+    for (const preprocess::PrepDiagnostics& part : parts) {
+        total += part;
+    }
+    return total;
+}
 
 
-std::vector<double> computeAreaTimeslices(std::span<const Points> slices)
+template <class Slices>
+static std::vector<double> _computeAreaTimeslices(const Slices& slices, const ExecutionPolicy& policy)
 {
     const std::size_t size = slices.size();
     std::vector<double> result(size);
 
-    #if OMP
-        #pragma omp parallel for
-    #endif
-    // Use dynamic scheduling to balance workload across threads
-    for(size_t i = 0; i< size; ++i){
-        result[i] = geom::Shoelace::calculateArea(slices[i]);
-    }
+    parallelFor(policy, size, [&](std::size_t, std::size_t first, std::size_t last) {
+        for(size_t i = first; i < last; ++i){
+            result[i] = geom::Shoelace::calculateArea(slices[i]);
+        }
+    });
 
     return result;
 }
 
-std::vector<double> computeMomentumTimeslices(std::span<const Points> slices)
+template <class Slices>
+static std::vector<double> _computeMomentumTimeslices(const Slices& slices, const ExecutionPolicy& policy)
 {
     const std::size_t size = slices.size();
     std::vector<double> result(size);
 
-    #if OMP
-        #pragma omp parallel for
-    #endif
-    // Use dynamic scheduling to balance workload across threads
-    for(size_t i = 0; i< size; ++i){
-        result[i] = geom::Shoelace::calculateMomentum(slices[i]);
-    }
+    parallelFor(policy, size, [&](std::size_t, std::size_t first, std::size_t last) {
+        for(size_t i = first; i < last; ++i){
+            result[i] = geom::Shoelace::calculateMomentum(slices[i]);
+        }
+    });
 
     return result;
 }
 
-std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslices(std::span<const Points> slices)
+template <class Slices>
+static std::vector<std::pair<double,double>> _computeAreaAndMomentumTimeslices(const Slices& slices,
+                                                                               const ExecutionPolicy& policy)
 {
     const std::size_t size = slices.size();
     std::vector<std::pair<double,double>> result(size);
 
-    #pragma omp parallel for 
-    // Use dynamic scheduling to balance workload across threads
-    for(size_t i = 0; i< size; ++i){
-        result[i] = geom::Shoelace::calculateAreaAndMomentum(slices[i]);
+    parallelFor(policy, size, [&](std::size_t, std::size_t first, std::size_t last) {
+        for(size_t i = first; i < last; ++i){
+            result[i] = geom::Shoelace::calculateAreaAndMomentum(slices[i]);
+        }
+    });
+
+    return result;
+}
+
+// (0, 0) for failed cuts; outcomes are counted per block, so no two threads share counters
+template <class Curve>
+static std::vector<std::pair<double,double>> _computeAreaAndMomentumCuts(std::span<const double> eps_cut,
+                                                                         const Curve& curve,
+                                                                         const ExecutionPolicy& policy)
+{
+    const std::size_t size = eps_cut.size();
+    std::vector<std::pair<double,double>> result(size);
+
+    std::vector<preprocess::PrepDiagnostics> diagnostics(blockCount(policy, size));
+
+    parallelFor(policy, size, [&](std::size_t block, std::size_t first, std::size_t last) {
+        for(size_t i = first; i < last; ++i){
+            preprocess::PrepResult<std::pair<double,double>> cut = geom::Shoelace::tryTrimmedAreaAndMomentum(eps_cut[i], curve);
+            diagnostics[block].record(cut.status);
+            result[i] = cut.value;
+        }
+    });
+
+    _sum(diagnostics).report("computeAreaAndMomentumCuts");
+
+    return result;
+}
+
+std::vector<double> computeAreaTimeslices(std::span<const Points> slices, const ExecutionPolicy& policy)
+{
+    return _computeAreaTimeslices(slices, policy);
+}
+
+std::vector<double> computeAreaTimeslices(std::span<const PointsView> slices, const ExecutionPolicy& policy)
+{
+    return _computeAreaTimeslices(slices, policy);
+}
+
+std::vector<double> computeMomentumTimeslices(std::span<const Points> slices, const ExecutionPolicy& policy)
+{
+    return _computeMomentumTimeslices(slices, policy);
+}
+
+std::vector<double> computeMomentumTimeslices(std::span<const PointsView> slices,
+                                              const ExecutionPolicy& policy)
+{
+    return _computeMomentumTimeslices(slices, policy);
+}
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslices(std::span<const Points> slices,
+                                                                       const ExecutionPolicy& policy)
+{
+    return _computeAreaAndMomentumTimeslices(slices, policy);
+}
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslices(std::span<const PointsView> slices,
+                                                                       const ExecutionPolicy& policy)
+{
+    return _computeAreaAndMomentumTimeslices(slices, policy);
+}
+
+std::vector<double> computeAreaTimeslices(const PointsBatch& slices, const ExecutionPolicy& policy)
+{
+    return _computeAreaTimeslices(slices, policy);
+}
+
+std::vector<double> computeMomentumTimeslices(const PointsBatch& slices, const ExecutionPolicy& policy)
+{
+    return _computeMomentumTimeslices(slices, policy);
+}
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslices(const PointsBatch& slices,
+                                                                       const ExecutionPolicy& policy)
+{
+    return _computeAreaAndMomentumTimeslices(slices, policy);
+}
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslicesBatch(const geom::PolygonMatrix& polygons,
+                                                                            const ExecutionPolicy& policy)
+{
+    const std::size_t size = polygons.size();
+    std::vector<double> area(size);
+    std::vector<double> momentum(size);
+
+    // blocks of whole vector widths, so every thread runs the SIMD path
+    const std::size_t block = 64 * geom::PolygonMatrix::lane_padding;
+    const std::size_t num_blocks = (size + block - 1) / block;
+
+    parallelFor(policy, num_blocks, [&](std::size_t, std::size_t first_block, std::size_t last_block) {
+        const std::size_t first = first_block * block;
+        const std::size_t last = std::min(last_block * block, size);
+        geom::Shoelace::calculateAreaAndMomentumBatch(polygons, first, last, area, momentum);
+    });
+
+    std::vector<std::pair<double,double>> result(size);
+    for(size_t i = 0; i < size; ++i){
+        result[i] = std::make_pair(area[i], momentum[i]);
     }
 
     return result;
-}
\ No newline at end of file
+}
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslicesBatch(std::span<const Points> slices,
+                                                                            const ExecutionPolicy& policy)
+{
+    return computeAreaAndMomentumTimeslicesBatch(geom::PolygonMatrix(slices), policy);
+}
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslicesBatch(std::span<const PointsView> slices,
+                                                                            const ExecutionPolicy& policy)
+{
+    return computeAreaAndMomentumTimeslicesBatch(geom::PolygonMatrix(slices), policy);
+}
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslicesBatch(const PointsBatch& slices,
+                                                                            const ExecutionPolicy& policy)
+{
+    return computeAreaAndMomentumTimeslicesBatch(geom::PolygonMatrix(slices), policy);
+}
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumCuts(std::span<const double> eps_cut, PointsView lm,
+                                                                 const ExecutionPolicy& policy)
+{
+    return _computeAreaAndMomentumCuts(eps_cut, lm, policy);
+}
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumCuts(std::span<const double> eps_cut,
+                                                                 const preprocess::CompiledCurve& curve,
+                                                                 const ExecutionPolicy& policy)
+{
+    return _computeAreaAndMomentumCuts(eps_cut, curve, policy);
+}
+
+void computeAreaAndMomentumCuts(std::span<const double> eps_cut, const preprocess::CompiledCurve& curve,
+                                storage::ResultWriter& out, std::size_t block_size, const ExecutionPolicy& policy)
+{
+    block_size = std::max<std::size_t>(block_size, 1);
+    std::vector<double> m0(std::min(block_size, eps_cut.size()));
+    std::vector<double> m1(m0.size());
+
+    preprocess::PrepDiagnostics total;
+    std::vector<preprocess::PrepDiagnostics> diagnostics;
+
+    for (std::size_t first = 0; first < eps_cut.size(); first += block_size) {
+        const std::size_t n = std::min(block_size, eps_cut.size() - first);
+
+        diagnostics.assign(blockCount(policy, n), preprocess::PrepDiagnostics());
+        parallelFor(policy, n, [&](std::size_t block, std::size_t begin, std::size_t end) {
+            for(size_t i = begin; i < end; ++i){
+                preprocess::PrepResult<std::pair<double,double>> cut =
+                    geom::Shoelace::tryTrimmedAreaAndMomentum(eps_cut[first + i], curve);
+                diagnostics[block].record(cut.status);
+                m0[i] = cut.value.first;
+                m1[i] = cut.value.second;
+            }
+        });
+        total += _sum(diagnostics);
+
+        // copied into the writer's buffer; writing overlaps the next block
+        out.append({std::span<const double>(m0.data(), n), std::span<const double>(m1.data(), n)});
+    }
+
+    total.report("computeAreaAndMomentumCuts");
+}
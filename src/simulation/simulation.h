@@ -3,13 +3,70 @@
 #include <vector>
 #include <span>
 #include "points/points.h"
+#include "points/pointsview.h"
+#include "points/pointsbatch.h"
 #include "geom/shoelace.h"
+#include "geom/polygonmatrix.h"
+#include "inputreader/compiledcurve.h"
+#include "storage/resultwriter.h"
+#include "parallel/execution.h"
 
 
-std::vector<double> computeAreaTimeslices(std::span<const Points> slices);
+// Timeslices are owning Points, views of vertices stored elsewhere, or one PointsBatch.
+// Every function runs its loop with the given execution policy (see execution.h).
 
-std::vector<double> computeMomentumTimeslices(std::span<const Points> slices);
+std::vector<double> computeAreaTimeslices(std::span<const Points> slices,
+                                          const ExecutionPolicy& policy = defaultExecution());
 
-std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslices(std::span<const Points> slices);
+std::vector<double> computeAreaTimeslices(std::span<const PointsView> slices,
+                                          const ExecutionPolicy& policy = defaultExecution());
 
+std::vector<double> computeAreaTimeslices(const PointsBatch& slices,
+                                          const ExecutionPolicy& policy = defaultExecution());
 
+std::vector<double> computeMomentumTimeslices(std::span<const Points> slices,
+                                              const ExecutionPolicy& policy = defaultExecution());
+
+std::vector<double> computeMomentumTimeslices(std::span<const PointsView> slices,
+                                              const ExecutionPolicy& policy = defaultExecution());
+
+std::vector<double> computeMomentumTimeslices(const PointsBatch& slices,
+                                              const ExecutionPolicy& policy = defaultExecution());
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslices(std::span<const Points> slices,
+                                                                       const ExecutionPolicy& policy = defaultExecution());
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslices(std::span<const PointsView> slices,
+                                                                       const ExecutionPolicy& policy = defaultExecution());
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslices(const PointsBatch& slices,
+                                                                       const ExecutionPolicy& policy = defaultExecution());
+
+// Same as computeAreaAndMomentumTimeslices, several timeslices per SIMD lane
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslicesBatch(const geom::PolygonMatrix& polygons,
+                                                                            const ExecutionPolicy& policy = defaultExecution());
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslicesBatch(std::span<const Points> slices,
+                                                                            const ExecutionPolicy& policy = defaultExecution());
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslicesBatch(std::span<const PointsView> slices,
+                                                                            const ExecutionPolicy& policy = defaultExecution());
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumTimeslicesBatch(const PointsBatch& slices,
+                                                                            const ExecutionPolicy& policy = defaultExecution());
+
+// Area and momentum of lm trimmed at every eps_cut[i], without building the trimmed polygons.
+// Failed cuts give (0, 0); they are counted per block and logged once for the whole call.
+std::vector<std::pair<double,double>> computeAreaAndMomentumCuts(std::span<const double> eps_cut, PointsView lm,
+                                                                 const ExecutionPolicy& policy = defaultExecution());
+
+std::vector<std::pair<double,double>> computeAreaAndMomentumCuts(std::span<const double> eps_cut,
+                                                                 const preprocess::CompiledCurve& curve,
+                                                                 const ExecutionPolicy& policy = defaultExecution());
+
+// Same, in blocks of block_size cuts whose m0 and m1 are appended to out (2 columns) as
+// soon as they are computed, so memory stays bounded however many cuts there are.
+// Failed cuts are written as (0, 0) and logged once at the end.
+void computeAreaAndMomentumCuts(std::span<const double> eps_cut, const preprocess::CompiledCurve& curve,
+                                storage::ResultWriter& out, std::size_t block_size = storage::ResultWriter::default_chunk_rows,
+                                const ExecutionPolicy& policy = defaultExecution());
@@ -0,0 +1,495 @@
+#include "columnfile.h"
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <spdlog/spdlog.h>
+
+#ifdef SPLINE_HAVE_ZLIB
+    #include <zlib.h>
+#endif
+
+namespace storage {
+
+static constexpr char file_magic[8] = {'S', 'P', 'L', 'N', 'C', 'O', 'L', '\0'};
+static constexpr std::uint32_t file_version = 1;
+static constexpr std::uint32_t file_byte_order = 0x01020304;
+static constexpr std::uint64_t file_alignment = 64;
+
+static constexpr std::size_t value_bytes = 8;   // both column types
+
+// deflate expands its input at most about 1032 times
+static constexpr std::uint64_t max_deflate_ratio = 1032;
+
+bool compressionAvailable()
+{
+#ifdef SPLINE_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+// bytes of count 8-byte values, regrouped by byte position
+static std::vector<unsigned char> _shuffle(const unsigned char* values, std::size_t count)
+{
+    std::vector<unsigned char> out(count * value_bytes);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t b = 0; b < value_bytes; ++b) {
+            out[b * count + i] = values[i * value_bytes + b];
+        }
+    }
+    return out;
+}
+
+static void _unshuffle(const unsigned char* shuffled, std::size_t count, unsigned char* values)
+{
+    for (std::size_t b = 0; b < value_bytes; ++b) {
+        for (std::size_t i = 0; i < count; ++i) {
+            values[i * value_bytes + b] = shuffled[b * count + i];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ColumnWriter
+
+ColumnWriter::ColumnWriter(const std::string& path)
+    : path(path), file(path, std::ios::binary | std::ios::trunc)
+{
+    if (!file) {
+        spdlog::error("ColumnWriter: cannot open {} for writing.", path);
+        return;
+    }
+
+    // the header is rewritten by close(), once the directory is known
+    FileHeader header{};
+    ok = true;
+    _write(&header, sizeof(header));
+}
+
+ColumnWriter::~ColumnWriter()
+{
+    close();
+}
+
+bool ColumnWriter::_write(const void* data, std::size_t bytes)
+{
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    position += bytes;
+    if (!file) {
+        spdlog::error("ColumnWriter: writing {} failed.", path);
+        ok = false;
+    }
+    return ok;
+}
+
+bool ColumnWriter::_pad()
+{
+    static constexpr char zeros[file_alignment] = {};
+    const std::size_t padding = static_cast<std::size_t>((file_alignment - position % file_alignment) % file_alignment);
+    return padding == 0 || _write(zeros, padding);
+}
+
+bool ColumnWriter::add(std::string_view name, std::span<const double> values, Compression compression)
+{
+    return _add(name, ColumnType::Float64, values.data(), values.size(), compression);
+}
+
+bool ColumnWriter::add(std::string_view name, std::span<const std::uint64_t> values, Compression compression)
+{
+    return _add(name, ColumnType::UInt64, values.data(), values.size(), compression);
+}
+
+bool ColumnWriter::_add(std::string_view name, ColumnType type, const void* values, std::size_t count,
+                        Compression compression)
+{
+    if (!ok || closed) {
+        return false;
+    }
+    if (name.empty() || name.size() > max_name_length) {
+        spdlog::error("ColumnWriter: column name '{}' must have 1 to {} characters.", name, max_name_length);
+        return false;
+    }
+    for (const DirectoryEntry& entry : directory) {
+        if (name == entry.name && entry.type != static_cast<std::uint32_t>(type)) {
+            spdlog::error("ColumnWriter: column '{}' was written with another type.", name);
+            return false;
+        }
+    }
+
+    DirectoryEntry entry{};
+    std::memcpy(entry.name, name.data(), name.size());
+    entry.type = static_cast<std::uint32_t>(type);
+    entry.count = count;
+
+    if (!_pad()) {
+        return false;
+    }
+    entry.offset = position;
+
+    const std::size_t raw_bytes = count * value_bytes;
+    const unsigned char* raw = static_cast<const unsigned char*>(values);
+
+#ifdef SPLINE_HAVE_ZLIB
+    if (compression == Compression::Deflate && count > 0) {
+        std::vector<unsigned char> shuffled = _shuffle(raw, count);
+        uLongf packed_bytes = compressBound(static_cast<uLong>(raw_bytes));
+        std::vector<unsigned char> packed(packed_bytes);
+
+        if (compress2(packed.data(), &packed_bytes, shuffled.data(), static_cast<uLong>(raw_bytes),
+                      Z_DEFAULT_COMPRESSION) == Z_OK && packed_bytes < raw_bytes) {
+            entry.compression = static_cast<std::uint32_t>(Compression::Deflate);
+            entry.bytes = packed_bytes;
+            if (!_write(packed.data(), packed_bytes)) {
+                return false;
+            }
+            directory.push_back(entry);
+            return true;
+        }
+        // incompressible: stored as is
+    }
+#else
+    if (compression == Compression::Deflate) {
+        static bool warned = false;
+        if (!warned) {
+            spdlog::warn("ColumnWriter: built without zlib, columns are stored uncompressed.");
+            warned = true;
+        }
+    }
+#endif
+
+    entry.compression = static_cast<std::uint32_t>(Compression::None);
+    entry.bytes = raw_bytes;
+    if (raw_bytes > 0 && !_write(raw, raw_bytes)) {
+        return false;
+    }
+    directory.push_back(entry);
+    return true;
+}
+
+bool ColumnWriter::close()
+{
+    if (closed) {
+        return ok;
+    }
+    closed = true;
+    if (!ok) {
+        return false;
+    }
+
+    if (!_pad()) {
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, file_magic, sizeof(file_magic));
+    header.version = file_version;
+    header.byte_order = file_byte_order;
+    header.column_count = directory.size();
+    header.directory_offset = position;
+
+    if (!directory.empty() && !_write(directory.data(), directory.size() * sizeof(DirectoryEntry))) {
+        return false;
+    }
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file) {
+        spdlog::error("ColumnWriter: writing {} failed.", path);
+        ok = false;
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// ColumnFile
+
+ColumnFile::ColumnFile(const std::string& path)
+    : file(path)
+{
+    ok = file.valid() && _load(path);
+    if (!ok) {
+        info.clear();
+        data.clear();
+    }
+}
+
+bool ColumnFile::_load(const std::string& path)
+{
+    const char* bytes = file.data();
+    const std::uint64_t size = file.size();
+
+    FileHeader header;
+    if (size < sizeof(header)) {
+        spdlog::error("ColumnFile: {} is not a column file.", path);
+        return false;
+    }
+    std::memcpy(&header, bytes, sizeof(header));
+
+    if (std::memcmp(header.magic, file_magic, sizeof(file_magic)) != 0) {
+        spdlog::error("ColumnFile: {} is not a column file.", path);
+        return false;
+    }
+    if (header.byte_order != file_byte_order || header.version != file_version) {
+        spdlog::error("ColumnFile: {} has version {} or byte order {:#x}, expected {} and {:#x}.",
+                path, header.version, header.byte_order, file_version, file_byte_order);
+        return false;
+    }
+    if (header.directory_offset > size
+        || header.column_count > (size - header.directory_offset) / sizeof(DirectoryEntry)) {
+        spdlog::error("ColumnFile: {} is truncated.", path);
+        return false;
+    }
+
+    std::vector<DirectoryEntry> directory(header.column_count);
+    if (!directory.empty()) {
+        std::memcpy(directory.data(), bytes + header.directory_offset, directory.size() * sizeof(DirectoryEntry));
+    }
+
+    // group the chunks by column, in order of first appearance
+    std::vector<std::vector<const DirectoryEntry*>> chunks;
+    for (DirectoryEntry& entry : directory) {
+        entry.name[max_name_length] = '\0';
+        if (entry.offset > size || entry.bytes > size - entry.offset || entry.offset % file_alignment != 0
+            || (entry.type != static_cast<std::uint32_t>(ColumnType::Float64)
+                && entry.type != static_cast<std::uint32_t>(ColumnType::UInt64))) {
+            spdlog::error("ColumnFile: {}: column '{}' is corrupt.", path, entry.name);
+            return false;
+        }
+
+        // the count sizes the decode buffers, so it must fit the stored bytes first
+        const std::uint64_t max_count = (entry.compression == static_cast<std::uint32_t>(Compression::Deflate)
+                                         ? entry.bytes * max_deflate_ratio : entry.bytes) / value_bytes;
+        if (entry.count > max_count) {
+            spdlog::error("ColumnFile: {}: column '{}' has {} values in {} bytes.",
+                    path, entry.name, entry.count, entry.bytes);
+            return false;
+        }
+
+        auto found = std::find_if(info.begin(), info.end(),
+                                  [&](const ColumnInfo& column) { return column.name == entry.name; });
+        if (found == info.end()) {
+            ColumnInfo column;
+            column.name = entry.name;
+            column.type = static_cast<ColumnType>(entry.type);
+            info.push_back(column);
+            chunks.emplace_back();
+            found = info.end() - 1;
+        }
+        found->count += entry.count;
+        found->chunks += 1;
+        chunks[static_cast<std::size_t>(found - info.begin())].push_back(&entry);
+    }
+
+    data.resize(info.size());
+    for (std::size_t c = 0; c < info.size(); ++c) {
+        ColumnInfo& column = info[c];
+        Column& values = data[c];
+
+        // one plain chunk: read in place
+        const DirectoryEntry& first = *chunks[c].front();
+        if (column.chunks == 1 && first.compression == static_cast<std::uint32_t>(Compression::None)) {
+            if (first.bytes != first.count * value_bytes) {
+                spdlog::error("ColumnFile: {}: column '{}' is corrupt.", path, column.name);
+                return false;
+            }
+            values.data = bytes + first.offset;
+            column.mapped = true;
+            continue;
+        }
+
+        // decode all chunks into one buffer
+        unsigned char* out;
+        if (column.type == ColumnType::Float64) {
+            values.owned_doubles.resize(column.count);
+            out = reinterpret_cast<unsigned char*>(values.owned_doubles.data());
+            values.data = values.owned_doubles.data();
+        } else {
+            values.owned_integers.resize(column.count);
+            out = reinterpret_cast<unsigned char*>(values.owned_integers.data());
+            values.data = values.owned_integers.data();
+        }
+
+        for (const DirectoryEntry* entry : chunks[c]) {
+            const std::size_t raw_bytes = entry->count * value_bytes;
+            const unsigned char* stored = reinterpret_cast<const unsigned char*>(bytes + entry->offset);
+
+            if (entry->compression == static_cast<std::uint32_t>(Compression::None)) {
+                if (entry->bytes != raw_bytes) {
+                    spdlog::error("ColumnFile: {}: column '{}' is corrupt.", path, column.name);
+                    return false;
+                }
+                std::memcpy(out, stored, raw_bytes);
+            } else if (entry->compression == static_cast<std::uint32_t>(Compression::Deflate)) {
+#ifdef SPLINE_HAVE_ZLIB
+                std::vector<unsigned char> shuffled(raw_bytes);
+                uLongf unpacked_bytes = static_cast<uLongf>(raw_bytes);
+                if (uncompress(shuffled.data(), &unpacked_bytes, stored, static_cast<uLong>(entry->bytes)) != Z_OK
+                    || unpacked_bytes != raw_bytes) {
+                    spdlog::error("ColumnFile: {}: column '{}' cannot be decompressed.", path, column.name);
+                    return false;
+                }
+                _unshuffle(shuffled.data(), entry->count, out);
+#else
+                spdlog::error("ColumnFile: {}: column '{}' is compressed, but this build has no zlib.",
+                        path, column.name);
+                return false;
+#endif
+            } else {
+                spdlog::error("ColumnFile: {}: column '{}' has unknown compression {}.",
+                        path, column.name, entry->compression);
+                return false;
+            }
+            out += raw_bytes;
+        }
+    }
+
+    return true;
+}
+
+bool ColumnFile::contains(std::string_view name) const
+{
+    return std::any_of(info.begin(), info.end(), [&](const ColumnInfo& column) { return column.name == name; });
+}
+
+const ColumnFile::Column* ColumnFile::_find(std::string_view name, ColumnType type) const
+{
+    for (std::size_t c = 0; c < info.size(); ++c) {
+        if (info[c].name == name) {
+            if (info[c].type != type) {
+                spdlog::error("ColumnFile: column '{}' has another type.", name);
+                return nullptr;
+            }
+            return &data[c];
+        }
+    }
+    spdlog::error("ColumnFile: no column '{}'.", name);
+    return nullptr;
+}
+
+std::span<const double> ColumnFile::doubles(std::string_view name) const
+{
+    const Column* column = ok ? _find(name, ColumnType::Float64) : nullptr;
+    if (column == nullptr) {
+        return {};
+    }
+    const std::size_t c = static_cast<std::size_t>(column - data.data());
+    return std::span<const double>(static_cast<const double*>(column->data), info[c].count);
+}
+
+std::span<const std::uint64_t> ColumnFile::integers(std::string_view name) const
+{
+    const Column* column = ok ? _find(name, ColumnType::UInt64) : nullptr;
+    if (column == nullptr) {
+        return {};
+    }
+    const std::size_t c = static_cast<std::size_t>(column - data.data());
+    return std::span<const std::uint64_t>(static_cast<const std::uint64_t*>(column->data), info[c].count);
+}
+
+// ---------------------------------------------------------------------------
+// library types
+
+bool writeCurve(const std::string& path, PointsView curve, Compression compression)
+{
+    if (!curve.contiguous()) {
+        return writeCurve(path, curve.to_points(), compression);
+    }
+
+    const StridedSpan eps = curve.get_epsilon();
+    const StridedSpan sig = curve.get_sigma();
+
+    ColumnWriter writer(path);
+    writer.add("epsilon", std::span<const double>(eps.data(), eps.size()), compression);
+    writer.add("sigma", std::span<const double>(sig.data(), sig.size()), compression);
+    return writer.close();
+}
+
+bool writeBatch(const std::string& path, const PointsBatch& batch, Compression compression)
+{
+    ColumnWriter writer(path);
+    writer.add("epsilon", batch.epsilon(), compression);
+    writer.add("sigma", batch.sigma(), compression);
+
+    std::span<const std::size_t> offsets = batch.offsets();
+    if constexpr (std::is_same_v<std::size_t, std::uint64_t>) {
+        writer.add("offsets", offsets, compression);
+    } else {
+        std::vector<std::uint64_t> wide(offsets.begin(), offsets.end());
+        writer.add("offsets", std::span<const std::uint64_t>(wide), compression);
+    }
+    return writer.close();
+}
+
+bool writeMoments(const std::string& path, std::span<const std::pair<double,double>> moments,
+                  Compression compression)
+{
+    std::vector<double> m0(moments.size());
+    std::vector<double> m1(moments.size());
+    for (std::size_t i = 0; i < moments.size(); ++i) {
+        m0[i] = moments[i].first;
+        m1[i] = moments[i].second;
+    }
+
+    ColumnWriter writer(path);
+    writer.add("m0", std::span<const double>(m0), compression);
+    writer.add("m1", std::span<const double>(m1), compression);
+    return writer.close();
+}
+
+bool writeSectionStates(const std::string& path, const SectionStateBatch& states, Compression compression)
+{
+    const std::pair<const char*, const std::vector<double>*> fields[] = {
+        {"eps_cc", &states.eps_cc}, {"eps_ft", &states.eps_ft}, {"h_cc", &states.h_cc},
+        {"h_ft", &states.h_ft}, {"jac_cc", &states.jac_cc}, {"jac_ft", &states.jac_ft},
+        {"f_cc", &states.f_cc}, {"f_ft", &states.f_ft}, {"m_ca", &states.m_ca},
+    };
+
+    ColumnWriter writer(path);
+    for (const auto& [name, values] : fields) {
+        if (!values->empty()) {
+            writer.add(name, std::span<const double>(*values), compression);
+        }
+    }
+    return writer.close();
+}
+
+PointsView curveView(const ColumnFile& file)
+{
+    std::span<const double> eps = file.doubles("epsilon");
+    std::span<const double> sig = file.doubles("sigma");
+
+    if (eps.size() != sig.size()) {
+        spdlog::error("curveView: epsilon has {} values and sigma {}.", eps.size(), sig.size());
+        return PointsView();
+    }
+    return PointsView(eps, sig);
+}
+
+std::vector<PointsView> batchViews(const ColumnFile& file)
+{
+    std::vector<PointsView> slices;
+
+    std::span<const double> eps = file.doubles("epsilon");
+    std::span<const double> sig = file.doubles("sigma");
+    std::span<const std::uint64_t> offsets = file.integers("offsets");
+
+    if (offsets.empty() || eps.size() != sig.size() || offsets.back() != eps.size()) {
+        spdlog::error("batchViews: file does not hold a PointsBatch.");
+        return slices;
+    }
+
+    slices.reserve(offsets.size() - 1);
+    for (std::size_t i = 0; i + 1 < offsets.size(); ++i) {
+        if (offsets[i + 1] < offsets[i]) {
+            spdlog::error("batchViews: offsets are not ascending at slice {}.", i);
+            return {};
+        }
+        slices.push_back(PointsView(eps.subspan(offsets[i], offsets[i + 1] - offsets[i]),
+                                    sig.subspan(offsets[i], offsets[i + 1] - offsets[i])));
+    }
+    return slices;
+}
+
+}
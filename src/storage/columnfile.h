@@ -0,0 +1,177 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <utility>
+#include "points/pointsview.h"
+#include "points/pointsbatch.h"
+#include "inputreader/mappedfile.h"
+#include "kappamoment/sectioncal.h"
+
+// Binary columnar files for curves, timeslice batches and result columns.
+//
+// Layout (native byte order, checked on open):
+//     FileHeader                      64 bytes
+//     column chunks                   each starting on a 64-byte boundary
+//     DirectoryEntry[column_count]    64 bytes each
+//
+// A column is a named array of float64 or uint64 values, written as one or more
+// chunks (consecutive add() calls with the same name), each of which may be
+// compressed. Reading maps the file: a column stored as one uncompressed chunk is
+// a view straight into the mapping, so opening a file of any size costs only the
+// directory. Compressed or chunked columns are decoded into memory on open.
+//
+// Compression (zlib, if built with it) stores the bytes of 8-byte values shuffled
+// (all first bytes, then all second bytes, ...), which groups the exponent and
+// sign bytes of nearby values and compresses doubles much better.
+
+namespace storage {
+
+    enum class ColumnType : std::uint32_t {
+        Float64 = 1,
+        UInt64  = 2,
+    };
+
+    enum class Compression : std::uint32_t {
+        None    = 0,
+        Deflate = 1,    // byte shuffle + zlib; stored uncompressed without zlib
+    };
+
+    // true if Compression::Deflate is available in this build
+    bool compressionAvailable();
+
+    struct FileHeader {
+        char magic[8];                  // "SPLNCOL" and a zero
+        std::uint32_t version;
+        std::uint32_t byte_order;       // 0x01020304 as written
+        std::uint64_t column_count;     // directory entries (chunks)
+        std::uint64_t directory_offset;
+        std::uint8_t reserved[32];
+    };
+    static_assert(sizeof(FileHeader) == 64);
+
+    struct DirectoryEntry {
+        char name[32];                  // zero-terminated
+        std::uint32_t type;             // ColumnType
+        std::uint32_t compression;      // Compression
+        std::uint64_t count;            // values in the chunk
+        std::uint64_t offset;           // from the start of the file, multiple of 64
+        std::uint64_t bytes;            // stored bytes
+    };
+    static_assert(sizeof(DirectoryEntry) == 64);
+
+    inline constexpr std::size_t max_name_length = sizeof(DirectoryEntry::name) - 1;
+
+    // Writes a column file front to back. Columns are added in order; the
+    // directory and header are written by close() (or the destructor).
+    // Errors are logged, and make add() and close() return false.
+    class ColumnWriter {
+    public:
+        explicit ColumnWriter(const std::string& path);
+        ~ColumnWriter();
+
+        ColumnWriter(const ColumnWriter&) = delete;
+        ColumnWriter& operator=(const ColumnWriter&) = delete;
+
+        bool valid() const {
+            return ok;
+        }
+
+        // append values as a chunk of column name
+        bool add(std::string_view name, std::span<const double> values, Compression compression = Compression::None);
+
+        bool add(std::string_view name, std::span<const std::uint64_t> values, Compression compression = Compression::None);
+
+        bool close();
+
+    private:
+        bool _add(std::string_view name, ColumnType type, const void* values, std::size_t count, Compression compression);
+
+        bool _write(const void* data, std::size_t bytes);
+
+        bool _pad();
+
+        std::string path;
+        std::ofstream file;
+        std::uint64_t position = 0;
+        std::vector<DirectoryEntry> directory;
+        bool ok = false;
+        bool closed = false;
+    };
+
+    struct ColumnInfo {
+        std::string name;
+        ColumnType type = ColumnType::Float64;
+        std::size_t count = 0;      // values over all chunks
+        std::size_t chunks = 0;
+        bool mapped = false;        // values are read in place from the file
+    };
+
+    // Read-only column file. Spans and views returned by it point into the mapping
+    // (or decoded buffers) and stay valid as long as the ColumnFile lives.
+    class ColumnFile {
+    public:
+        ColumnFile() = default;
+
+        // an error is logged and valid() is false if the file is not a column file
+        explicit ColumnFile(const std::string& path);
+
+        ColumnFile(const ColumnFile&) = delete;
+        ColumnFile& operator=(const ColumnFile&) = delete;
+
+        bool valid() const {
+            return ok;
+        }
+
+        const std::vector<ColumnInfo>& columns() const {
+            return info;
+        }
+
+        bool contains(std::string_view name) const;
+
+        // values of a column; empty (and an error) if missing or of another type
+        std::span<const double> doubles(std::string_view name) const;
+
+        std::span<const std::uint64_t> integers(std::string_view name) const;
+
+    private:
+        struct Column {
+            const void* data = nullptr;             // count values, mapped or owned
+            std::vector<double> owned_doubles;      // decoded column
+            std::vector<std::uint64_t> owned_integers;
+        };
+
+        bool _load(const std::string& path);
+
+        const Column* _find(std::string_view name, ColumnType type) const;
+
+        preprocess::MappedFile file;
+        std::vector<ColumnInfo> info;
+        std::vector<Column> data;
+        bool ok = false;
+    };
+
+    // Writers for the library types. Curves are stored as epsilon/sigma, batches as
+    // epsilon/sigma/offsets (see PointsBatch), moments as m0/m1 and section states
+    // with one column per non-empty field, named like the field.
+    bool writeCurve(const std::string& path, PointsView curve, Compression compression = Compression::None);
+
+    bool writeBatch(const std::string& path, const PointsBatch& batch, Compression compression = Compression::None);
+
+    bool writeMoments(const std::string& path, std::span<const std::pair<double,double>> moments,
+                      Compression compression = Compression::None);
+
+    bool writeSectionStates(const std::string& path, const SectionStateBatch& states,
+                            Compression compression = Compression::None);
+
+    // Zero-copy views into a file written by writeCurve / writeBatch; empty on error
+    PointsView curveView(const ColumnFile& file);
+
+    std::vector<PointsView> batchViews(const ColumnFile& file);
+
+}
@@ -0,0 +1,260 @@
+#include "resultwriter.h"
+#include <charconv>
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace storage {
+
+// ---------------------------------------------------------------------------
+// CsvSink
+
+CsvSink::CsvSink(const std::string& path, std::vector<std::string> names, char delimiter)
+    : path(path), file(std::fopen(path.c_str(), "wb")), delimiter(delimiter)
+{
+    if (file == nullptr) {
+        spdlog::error("CsvSink: cannot open {} for writing.", path);
+        return;
+    }
+
+    std::string header;
+    for (std::size_t c = 0; c < names.size(); ++c) {
+        if (c > 0) {
+            header += delimiter;
+        }
+        header += names[c];
+    }
+    header += '\n';
+    std::fwrite(header.data(), 1, header.size(), file);
+}
+
+CsvSink::~CsvSink()
+{
+    close();
+}
+
+bool CsvSink::write(std::span<const std::vector<double>> columns, std::size_t rows)
+{
+    if (file == nullptr) {
+        return false;
+    }
+
+    // at most 24 characters per value and a separator
+    text.resize(rows * columns.size() * 25 + 1);
+    char* out = text.data();
+    char* const end = text.data() + text.size();
+
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            out = std::to_chars(out, end, columns[c][r]).ptr;
+            *out++ = (c + 1 < columns.size()) ? delimiter : '\n';
+        }
+    }
+
+    const std::size_t bytes = static_cast<std::size_t>(out - text.data());
+    if (std::fwrite(text.data(), 1, bytes, file) != bytes) {
+        spdlog::error("CsvSink: writing {} failed.", path);
+        return false;
+    }
+    return true;
+}
+
+bool CsvSink::close()
+{
+    if (file == nullptr) {
+        return true;
+    }
+    const bool ok = std::fclose(file) == 0;
+    file = nullptr;
+    if (!ok) {
+        spdlog::error("CsvSink: writing {} failed.", path);
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// ColumnSink
+
+ColumnSink::ColumnSink(const std::string& path, std::vector<std::string> names, Compression compression)
+    : writer(path), names(std::move(names)), compression(compression)
+{
+}
+
+bool ColumnSink::write(std::span<const std::vector<double>> columns, std::size_t rows)
+{
+    bool ok = true;
+    for (std::size_t c = 0; c < columns.size() && c < names.size(); ++c) {
+        ok = writer.add(names[c], std::span<const double>(columns[c].data(), rows), compression) && ok;
+    }
+    return ok;
+}
+
+bool ColumnSink::close()
+{
+    return writer.close();
+}
+
+std::unique_ptr<ResultSink> openResultSink(const std::string& path, std::vector<std::string> names)
+{
+    const bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    if (csv) {
+        auto sink = std::make_unique<CsvSink>(path, std::move(names));
+        if (!sink->valid()) {
+            return nullptr;
+        }
+        return sink;
+    }
+
+    auto sink = std::make_unique<ColumnSink>(path, std::move(names));
+    if (!sink->valid()) {
+        return nullptr;
+    }
+    return sink;
+}
+
+// ---------------------------------------------------------------------------
+// ResultWriter
+
+ResultWriter::ResultWriter(std::unique_ptr<ResultSink> sink, std::size_t columns, std::size_t chunk_rows)
+    : sink(std::move(sink)), chunk_rows(std::max<std::size_t>(chunk_rows, 1)),
+      front(columns), back(columns)
+{
+    for (std::size_t c = 0; c < columns; ++c) {
+        front[c].resize(this->chunk_rows);
+        back[c].resize(this->chunk_rows);
+    }
+
+    if (this->sink == nullptr) {
+        spdlog::error("ResultWriter: no sink, results are dropped.");
+        failed = true;
+    }
+
+    thread = std::thread(&ResultWriter::_run, this);
+}
+
+ResultWriter::~ResultWriter()
+{
+    close();
+}
+
+void ResultWriter::append(std::initializer_list<std::span<const double>> values)
+{
+    append(std::span<const std::span<const double>>(values.begin(), values.size()));
+}
+
+void ResultWriter::append(std::span<const std::span<const double>> values)
+{
+    if (closed) {
+        return;
+    }
+    if (values.size() != front.size()) {
+        spdlog::error("ResultWriter: {} columns appended to a writer of {}.", values.size(), front.size());
+        return;
+    }
+
+    const std::size_t rows = values.empty() ? 0 : values[0].size();
+    for (const std::span<const double>& column : values) {
+        if (column.size() != rows) {
+            spdlog::error("ResultWriter: columns of different length appended.");
+            return;
+        }
+    }
+
+    // copy into the front buffer, handing it over whenever it is full
+    for (std::size_t first = 0; first < rows; ) {
+        const std::size_t n = std::min(rows - first, chunk_rows - front_rows);
+        for (std::size_t c = 0; c < front.size(); ++c) {
+            std::copy_n(values[c].begin() + first, n, front[c].begin() + front_rows);
+        }
+        front_rows += n;
+        first += n;
+
+        if (front_rows == chunk_rows) {
+            _flush();
+        }
+    }
+    appended += rows;
+}
+
+void ResultWriter::append_row(std::initializer_list<double> row)
+{
+    if (closed) {
+        return;
+    }
+    if (row.size() != front.size()) {
+        spdlog::error("ResultWriter: row of {} values appended to a writer of {} columns.", row.size(), front.size());
+        return;
+    }
+
+    std::size_t c = 0;
+    for (double value : row) {
+        front[c++][front_rows] = value;
+    }
+    ++front_rows;
+    ++appended;
+
+    if (front_rows == chunk_rows) {
+        _flush();
+    }
+}
+
+void ResultWriter::_flush()
+{
+    if (front_rows == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    // wait for the previous buffer to be written
+    changed.wait(lock, [this] { return !back_full; });
+
+    std::swap(front, back);
+    back_rows = front_rows;
+    front_rows = 0;
+    back_full = true;
+
+    lock.unlock();
+    changed.notify_all();
+}
+
+void ResultWriter::_run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return back_full || stopping; });
+        if (!back_full) {
+            break;
+        }
+
+        // back is owned by this thread until back_full is reset
+        lock.unlock();
+        const bool ok = !failed && sink->write(back, back_rows);
+        lock.lock();
+
+        failed = failed || !ok;
+        back_full = false;
+        changed.notify_all();
+    }
+}
+
+bool ResultWriter::close()
+{
+    if (closed) {
+        return !failed;
+    }
+    closed = true;
+
+    _flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+
+    if (sink != nullptr && !sink->close()) {
+        failed = true;
+    }
+    return !failed;
+}
+
+}
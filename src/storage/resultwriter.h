@@ -0,0 +1,142 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <span>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <initializer_list>
+#include <cstdio>
+#include <cstddef>
+#include "storage/columnfile.h"
+
+// Streaming output of result columns (e.g. m0, m1 per timestep) for long runs.
+//
+// A ResultSink writes blocks of rows to one backend (CSV or column file). A
+// ResultWriter sits in front of it and double-buffers: the compute side appends
+// rows to the front buffer; a full buffer is swapped with the back buffer, which a
+// background thread hands to the sink. The compute side only waits if the sink
+// falls a whole buffer behind, and memory stays at two buffers however long the
+// run is.
+
+namespace storage {
+
+    // Backend for blocks of rows; columns are in the order given to the sink
+    class ResultSink {
+    public:
+        virtual ~ResultSink() = default;
+
+        // rows [0, rows) of every column
+        virtual bool write(std::span<const std::vector<double>> columns, std::size_t rows) = 0;
+
+        virtual bool close() = 0;
+    };
+
+    // Text rows with a header line; values in shortest round-trip form
+    class CsvSink final : public ResultSink {
+    public:
+        CsvSink(const std::string& path, std::vector<std::string> names, char delimiter = ',');
+        ~CsvSink() override;
+
+        bool valid() const {
+            return file != nullptr;
+        }
+
+        bool write(std::span<const std::vector<double>> columns, std::size_t rows) override;
+
+        bool close() override;
+
+    private:
+        std::string path;
+        std::FILE* file = nullptr;
+        char delimiter;
+        std::string text;   // formatted block, reused
+    };
+
+    // Column file (see columnfile.h) with one chunk per column and block
+    class ColumnSink final : public ResultSink {
+    public:
+        ColumnSink(const std::string& path, std::vector<std::string> names,
+                   Compression compression = Compression::None);
+
+        bool valid() const {
+            return writer.valid();
+        }
+
+        bool write(std::span<const std::vector<double>> columns, std::size_t rows) override;
+
+        bool close() override;
+
+    private:
+        ColumnWriter writer;
+        std::vector<std::string> names;
+        Compression compression;
+    };
+
+    // CsvSink for paths ending in .csv, ColumnSink otherwise; nullptr (and an error) if
+    // the file cannot be created
+    std::unique_ptr<ResultSink> openResultSink(const std::string& path, std::vector<std::string> names);
+
+    // Double-buffered, asynchronous writer in front of a sink. append() is called by
+    // one thread (the one driving the computation); writing happens on another.
+    class ResultWriter {
+    public:
+        static constexpr std::size_t default_chunk_rows = 1 << 16;
+
+        ResultWriter(std::unique_ptr<ResultSink> sink, std::size_t columns,
+                     std::size_t chunk_rows = default_chunk_rows);
+
+        // close()s the writer
+        ~ResultWriter();
+
+        ResultWriter(const ResultWriter&) = delete;
+        ResultWriter& operator=(const ResultWriter&) = delete;
+
+        std::size_t columns() const {
+            return front.size();
+        }
+
+        // rows given as one span per column, all of the same length
+        void append(std::initializer_list<std::span<const double>> values);
+
+        void append(std::span<const std::span<const double>> values);
+
+        // a single row
+        void append_row(std::initializer_list<double> row);
+
+        // write what is left, stop the thread and close the sink;
+        // false if the sink failed at any point
+        bool close();
+
+        std::size_t rows_appended() const {
+            return appended;
+        }
+
+    private:
+        // hand the front buffer to the writer thread
+        void _flush();
+
+        void _run();
+
+        std::unique_ptr<ResultSink> sink;
+        std::size_t chunk_rows;
+
+        std::vector<std::vector<double>> front;     // filled by append()
+        std::vector<std::vector<double>> back;      // being written
+        std::size_t front_rows = 0;
+        std::size_t back_rows = 0;
+        std::size_t appended = 0;
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        bool back_full = false;
+        bool stopping = false;
+        bool failed = false;
+        bool closed = false;
+
+        std::thread thread;
+    };
+
+}
@@ -0,0 +1,136 @@
+#include <vector>
+#include <cmath>
+#include <spdlog/spdlog.h>
+#include <gtest/gtest.h>
+
+#include "inputreader/prep.h"
+#include "geom/shoelace.h"
+#include "geom/prefixmoments.h"
+
+class PrefixMomentsTest : public ::testing::Test {
+protected:
+    Points points1;
+    Points points2;
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+
+        // Define a simple trapezoid
+        points1 = Points(
+            std::vector<double>{0.0, 2.0, 4.0, 6.0, 8.0, 10.0},
+            std::vector<double>{0.0, 2.0, 2.0, 2.0, 2.0, 2.0}
+        );
+
+        // Curve with a softening branch and a start point off the origin
+        points2 = Points(
+            std::vector<double>{0.5, 1.0, 2.5, 3.0, 4.5, 7.0, 7.5},
+            std::vector<double>{1.0, 3.0, 4.0, 2.5, 2.0, 5.0, -1.0}
+        );
+
+        test_logger->info("PrefixMomentsTest setup complete");
+    }
+
+    void TearDown() override {
+        test_logger->info("PrefixMomentsTest teardown complete\n\n");
+    }
+};
+
+TEST_F(PrefixMomentsTest, TrapezoidTest) {
+    test_logger->info("PrefixMoments - trapezoid test");
+
+    geom::PrefixMoments table(points1);
+
+    EXPECT_DOUBLE_EQ(table.calculateArea(4.0), 6.0);
+    EXPECT_DOUBLE_EQ(table.calculateMomentum(4.0), 88.0 / 6.0);
+    EXPECT_DOUBLE_EQ(table.calculateArea(9.0), 16.0);
+    EXPECT_DOUBLE_EQ(table.calculateMomentum(9.0), 478.0 / 6.0);
+
+    test_logger->info("PrefixMoments - trapezoid test passed");
+}
+
+TEST_F(PrefixMomentsTest, MatchesPolygonTest) {
+    test_logger->info("PrefixMoments - comparison with prep + Shoelace");
+
+    geom::PrefixMoments table(points2);
+
+    // cuts between vertices, on vertices and on both ends
+    for (double eps_cut = 0.5; eps_cut <= 7.5; eps_cut += 0.125) {
+        std::pair<double,double> expected =
+            geom::Shoelace::calculateAreaAndMomentum(preprocess::prep(eps_cut, points2));
+        std::pair<double,double> result = table.calculateAreaAndMomentum(eps_cut);
+
+        EXPECT_DOUBLE_EQ(result.first, expected.first) << "area mismatch at eps_cut = " << eps_cut;
+        EXPECT_DOUBLE_EQ(result.second, expected.second) << "momentum mismatch at eps_cut = " << eps_cut;
+    }
+
+    test_logger->info("PrefixMoments - comparison with prep + Shoelace passed");
+}
+
+TEST_F(PrefixMomentsTest, InvalidTest) {
+    test_logger->info("PrefixMoments - invalid cut test");
+
+    geom::PrefixMoments table(points1);
+    geom::PrefixMoments empty_table;
+
+    std::pair<double,double> below = table.calculateAreaAndMomentum(-1.0);
+    std::pair<double,double> above = table.calculateAreaAndMomentum(11.0);
+    std::pair<double,double> empty = empty_table.calculateAreaAndMomentum(1.0);
+
+    EXPECT_DOUBLE_EQ(below.first, 0.0);
+    EXPECT_DOUBLE_EQ(below.second, 0.0);
+    EXPECT_DOUBLE_EQ(above.first, 0.0);
+    EXPECT_DOUBLE_EQ(above.second, 0.0);
+    EXPECT_DOUBLE_EQ(empty.first, 0.0);
+    EXPECT_DOUBLE_EQ(empty.second, 0.0);
+
+    // the try_ functions report the same failures through their status
+    EXPECT_EQ(table.tryAreaAndMomentum(-1.0).status, preprocess::PrepStatus::OutOfRange);
+    EXPECT_EQ(table.tryArea(11.0).status, preprocess::PrepStatus::OutOfRange);
+    EXPECT_EQ(table.tryMomentum(std::nan("")).status, preprocess::PrepStatus::OutOfRange);
+    EXPECT_EQ(table.tryAreaAndMomentumDerivative(11.0).value.darea, 0.0);
+    EXPECT_EQ(empty_table.tryAreaAndMomentum(1.0).status, preprocess::PrepStatus::InvalidCurve);
+
+    preprocess::PrepResult<std::pair<double,double>> inside = table.tryAreaAndMomentum(4.0);
+    ASSERT_TRUE(inside.ok());
+    EXPECT_EQ(inside.value, table.calculateAreaAndMomentum(4.0));
+    EXPECT_EQ(table.tryArea(4.0).value, table.calculateArea(4.0));
+    EXPECT_EQ(table.tryMomentum(4.0).value, table.calculateMomentum(4.0));
+    EXPECT_EQ(table.tryAreaAndMomentumDerivative(4.0).value.dmomentum,
+              table.calculateAreaAndMomentumDerivative(4.0).dmomentum);
+
+    test_logger->info("PrefixMoments - invalid cut test passed");
+}
+
+TEST_F(PrefixMomentsTest, DerivativeTest) {
+    test_logger->info("PrefixMoments - derivative test");
+
+    geom::PrefixMoments table(points2);
+    const double h = 1e-6;
+
+    // cuts inside segments, away from the kinks of the polyline
+    for (double eps_cut : {0.75, 1.7, 2.8, 3.9, 5.3, 7.2}) {
+        geom::AreaMomentumDerivative result = table.calculateAreaAndMomentumDerivative(eps_cut);
+
+        std::pair<double,double> plus = table.calculateAreaAndMomentum(eps_cut + h);
+        std::pair<double,double> minus = table.calculateAreaAndMomentum(eps_cut - h);
+        double darea_fd = (plus.first - minus.first) / (2.0 * h);
+        double dmomentum_fd = (plus.second - minus.second) / (2.0 * h);
+
+        EXPECT_NEAR(result.darea, darea_fd, 1e-6) << "eps_cut = " << eps_cut;
+        EXPECT_NEAR(result.dmomentum, dmomentum_fd, 1e-5) << "eps_cut = " << eps_cut;
+
+        // same values and derivatives from the polygon
+        preprocess::CutPoint cut = preprocess::_preprocess_polyline_derivative(eps_cut, points2);
+        geom::AreaMomentumDerivative polygon =
+            geom::Shoelace::calculateAreaAndMomentumDerivative(preprocess::prep(eps_cut, points2), cut.dsigma);
+
+        EXPECT_DOUBLE_EQ(result.area, polygon.area) << "eps_cut = " << eps_cut;
+        EXPECT_DOUBLE_EQ(result.momentum, polygon.momentum) << "eps_cut = " << eps_cut;
+        EXPECT_NEAR(result.darea, polygon.darea, 1e-12) << "eps_cut = " << eps_cut;
+        EXPECT_NEAR(result.dmomentum, polygon.dmomentum, 1e-11) << "eps_cut = " << eps_cut;
+    }
+
+    test_logger->info("PrefixMoments - derivative test passed");
+}
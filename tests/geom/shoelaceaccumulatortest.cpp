@@ -0,0 +1,121 @@
+#include <cmath>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "inputreader/prep.h"
+#include "geom/shoelace.h"
+#include "geom/shoelaceaccumulator.h"
+
+class ShoelaceAccumulatorTest : public ::testing::Test {
+protected:
+    Points polygon;
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+
+        // trimmed wavy curve, a few thousand vertices
+        const std::size_t n = 3000;
+        std::vector<double> eps(n);
+        std::vector<double> sig(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const double x = static_cast<double>(i) / static_cast<double>(n);
+            eps[i] = 0.01 * x;
+            sig[i] = 180.0 * (1.0 - std::exp(-300.0 * x)) + 5.0 * std::sin(50.0 * x);
+        }
+        polygon = preprocess::prep(0.008, Points(eps, sig));
+
+        test_logger->info("ShoelaceAccumulatorTest setup complete");
+    }
+
+    void TearDown() override {
+        test_logger->info("ShoelaceAccumulatorTest teardown complete\n\n");
+    }
+};
+
+TEST_F(ShoelaceAccumulatorTest, ChunkTest) {
+    test_logger->info("ShoelaceAccumulator - chunked sums match the whole polygon");
+
+    const std::pair<double,double> expected = geom::Shoelace::calculateAreaAndMomentum(polygon);
+    ASSERT_GT(expected.first, 0.0);
+
+    // the edges are summed in polygon order whatever the chunks, so the results are exact
+    for (std::size_t chunk_size : {1, 2, 3, 17, 1000, 100000}) {
+        geom::ShoelaceAccumulator accumulator;
+        for (std::size_t first = 0; first < polygon.size(); first += chunk_size) {
+            accumulator.add(PointsView(polygon).subview(first, std::min(chunk_size, polygon.size() - first)));
+        }
+
+        EXPECT_EQ(accumulator.vertices(), polygon.size());
+        const std::pair<double,double> result = accumulator.finalize();
+        EXPECT_EQ(result.first, expected.first) << "chunk_size = " << chunk_size;
+        EXPECT_EQ(result.second, expected.second) << "chunk_size = " << chunk_size;
+    }
+
+    // single vertices, and too few of them
+    geom::ShoelaceAccumulator accumulator;
+    accumulator.add(0.0, 0.0);
+    accumulator.add(2.0, 2.0);
+    EXPECT_EQ(accumulator.finalize().first, 0.0);
+    accumulator.add(2.0, 0.0);
+    accumulator.add(0.0, 0.0);
+    EXPECT_DOUBLE_EQ(accumulator.finalize().first, 2.0);
+
+    accumulator.reset();
+    EXPECT_EQ(accumulator.vertices(), 0u);
+    EXPECT_EQ(accumulator.finalize().second, 0.0);
+
+    test_logger->info("ShoelaceAccumulator - chunked sums match the whole polygon passed");
+}
+
+TEST_F(ShoelaceAccumulatorTest, GeneratorTest) {
+    test_logger->info("ShoelaceAccumulator - vertices from a generator and a file");
+
+    const std::pair<double,double> expected = geom::Shoelace::calculateAreaAndMomentum(polygon);
+
+    std::size_t next = 0;
+    geom::VertexGenerator vertices = [&](std::span<double> eps, std::span<double> sig) {
+        const std::size_t n = std::min(eps.size(), polygon.size() - next);
+        for (std::size_t i = 0; i < n; ++i) {
+            eps[i] = polygon.get_epsilon()[next + i];
+            sig[i] = polygon.get_sigma()[next + i];
+        }
+        next += n;
+        return n;
+    };
+
+    const std::pair<double,double> generated = geom::accumulateAreaAndMomentum(vertices, 64);
+    EXPECT_EQ(generated.first, expected.first);
+    EXPECT_EQ(generated.second, expected.second);
+
+    // the same curve written to a file and read back in small chunks
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "spline_shoelaceaccumulatortest.csv";
+    {
+        std::ofstream file(path);
+        file.precision(17);
+        file << "eps,sigma\n";
+        // the trimmed polygon is not ascending in eps; write its curve part only
+        for (std::size_t i = 0; i + 2 < polygon.size(); ++i) {
+            file << polygon.get_epsilon()[i] << "," << polygon.get_sigma()[i] << "\n";
+        }
+    }
+    Points curve(std::vector<double>(polygon.get_epsilon().begin(), polygon.get_epsilon().end() - 2),
+                 std::vector<double>(polygon.get_sigma().begin(), polygon.get_sigma().end() - 2));
+
+    preprocess::CsvOptions small;
+    small.chunk_bytes = 256;
+    const std::pair<double,double> from_file = geom::accumulateAreaAndMomentum(path.string(), small);
+    const std::pair<double,double> from_curve = geom::Shoelace::calculateAreaAndMomentum(curve);
+    EXPECT_EQ(from_file.first, from_curve.first);
+    EXPECT_EQ(from_file.second, from_curve.second);
+
+    std::filesystem::remove(path);
+    EXPECT_EQ(geom::accumulateAreaAndMomentum(path.string()).first, 0.0);
+
+    test_logger->info("ShoelaceAccumulator - vertices from a generator and a file passed");
+}
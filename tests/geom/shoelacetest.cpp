@@ -1,4 +1,5 @@
 #include <vector>
+#include <cmath>
 #include <spdlog/spdlog.h>
 #include <gtest/gtest.h>
 
@@ -249,4 +250,148 @@ TEST_F(ShoelaceTest,MomentumInvalidTest1){
     EXPECT_DOUBLE_EQ(momentum_simd2.second, 0.0) << "Momentum calculation SIMD mismatch for invalid polygon";
     
     test_logger->info("Shoelace - Momentum calculation invalid test1 passed");
-}
\ No newline at end of file
+}
+
+TEST_F(ShoelaceTest, BatchKernelTest){
+    test_logger->info("Shoelace - batch kernel over padded polygon matrix");
+
+    // polygons of different sizes, including invalid ones and an odd lane count
+    std::vector<Points> polygons;
+    for (double eps_cut = 0.5; eps_cut <= 10.0; eps_cut += 0.75) {
+        polygons.push_back(preprocess::prep(eps_cut, points1));
+        polygons.push_back(preprocess::prep(eps_cut, points2));
+    }
+    polygons.push_back(Points());
+    polygons.push_back(Points(std::vector<double>{1.0, 3.0, 2.0}, std::vector<double>{1.0, 2.0, 4.0}));
+
+    geom::PolygonMatrix matrix(polygons);
+    ASSERT_EQ(matrix.size(), polygons.size());
+    ASSERT_EQ(matrix.stride() % geom::PolygonMatrix::lane_padding, 0u);
+
+    std::vector<double> area(polygons.size());
+    std::vector<double> momentum(polygons.size());
+    geom::Shoelace::calculateAreaAndMomentumBatch(matrix, area, momentum);
+
+    for (std::size_t p = 0; p < polygons.size(); ++p) {
+        std::pair<double,double> expected = geom::Shoelace::calculateAreaAndMomentum(polygons[p]);
+        EXPECT_DOUBLE_EQ(area[p], expected.first) << "area mismatch for polygon " << p;
+        EXPECT_DOUBLE_EQ(momentum[p], expected.second) << "momentum mismatch for polygon " << p;
+    }
+
+    test_logger->info("Shoelace - batch kernel test passed");
+}
+
+TEST_F(ShoelaceTest, TrimmedTest){
+    test_logger->info("Shoelace - fused trim and integrate test");
+
+    // curve starting off the origin, so a cut on the first vertex is a valid triangle
+    Points points3(
+        std::vector<double>{0.5, 1.0, 2.5, 3.0, 4.5, 7.0, 7.5},
+        std::vector<double>{1.0, 3.0, 4.0, 2.5, 2.0, 5.0, -1.0}
+    );
+
+    for (const Points* lm : {&points1, &points2, &points3}) {
+        const double front = lm->get_epsilon().front();
+        const double back = lm->get_epsilon().back();
+
+        // cuts between vertices, on vertices and on both ends
+        for (double eps_cut = front; eps_cut <= back; eps_cut += 0.125) {
+            std::pair<double,double> expected =
+                geom::Shoelace::calculateAreaAndMomentum(preprocess::prep(eps_cut, *lm));
+            std::pair<double,double> result = geom::Shoelace::calculateTrimmedAreaAndMomentum(eps_cut, *lm);
+
+            EXPECT_EQ(result.first, expected.first) << "area mismatch at eps_cut = " << eps_cut;
+            EXPECT_EQ(result.second, expected.second) << "momentum mismatch at eps_cut = " << eps_cut;
+        }
+    }
+
+    std::pair<double,double> invalid = geom::Shoelace::calculateTrimmedAreaAndMomentum(11.0, points1);
+    EXPECT_DOUBLE_EQ(invalid.first, 0.0);
+    EXPECT_DOUBLE_EQ(invalid.second, 0.0);
+
+    test_logger->info("Shoelace - fused trim and integrate test passed");
+}
+
+// wavy curve of n vertices from the origin, eps increasing
+static Points wavy_curve(std::size_t n) {
+    std::vector<double> eps(n);
+    std::vector<double> sig(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double x = static_cast<double>(i) / static_cast<double>(n);
+        eps[i] = 10.0 * x;
+        sig[i] = 2.0 * x + 0.25 * std::sin(40.0 * x) * x;
+    }
+    return Points(eps, sig);
+}
+
+TEST_F(ShoelaceTest, ParallelTest){
+    test_logger->info("Shoelace - intra-polygon parallel sum test");
+
+    Points polygon = preprocess::prep(9.0, wavy_curve(5000));
+    const std::pair<double,double> expected = geom::Shoelace::calculateAreaAndMomentum(polygon);
+
+    // small blocks put many seams in the polygon, block size 1 puts one on every vertex
+    for (std::size_t chunk_size : {1, 2, 7, 64, 100000}) {
+        ExecutionPolicy serial{ExecutionBackend::Serial, 1, chunk_size};
+        const std::pair<double,double> reference = geom::Shoelace::calculateAreaAndMomentumParallel(polygon, serial);
+
+        EXPECT_NEAR(reference.first, expected.first, 1e-12 * expected.first) << "chunk_size = " << chunk_size;
+        EXPECT_NEAR(reference.second, expected.second, 1e-12 * expected.second) << "chunk_size = " << chunk_size;
+
+        // same blocks, same combine order: bitwise equal whatever runs them
+        for (ExecutionBackend backend : {ExecutionBackend::ThreadPool, ExecutionBackend::WorkStealing, ExecutionBackend::OpenMP}) {
+            for (std::size_t threads : {1, 2, 4}) {
+                for (ExecutionSchedule schedule : {ExecutionSchedule::Static, ExecutionSchedule::Guided}) {
+                    ExecutionPolicy policy{backend, threads, chunk_size, schedule};
+                    const std::pair<double,double> result = geom::Shoelace::calculateAreaAndMomentumParallel(polygon, policy);
+
+                    EXPECT_EQ(result.first, reference.first) << backendName(backend) << ", " << threads << " threads";
+                    EXPECT_EQ(result.second, reference.second) << backendName(backend) << ", " << threads << " threads";
+                }
+            }
+        }
+    }
+
+    // strided views go through the scalar block loop
+    std::vector<double> interleaved;
+    for (std::size_t i = 0; i < polygon.size(); ++i) {
+        interleaved.push_back(polygon.get_epsilon()[i]);
+        interleaved.push_back(polygon.get_sigma()[i]);
+    }
+    PointsView strided(StridedSpan(interleaved.data(), polygon.size(), 2),
+                       StridedSpan(interleaved.data() + 1, polygon.size(), 2));
+    const std::pair<double,double> from_strided =
+        geom::Shoelace::calculateAreaAndMomentumParallel(strided, ExecutionPolicy{ExecutionBackend::ThreadPool, 2, 64});
+    EXPECT_NEAR(from_strided.first, expected.first, 1e-12 * expected.first);
+    EXPECT_NEAR(from_strided.second, expected.second, 1e-12 * expected.second);
+
+    Points triangle = preprocess::prep(2.0, points2);
+    EXPECT_DOUBLE_EQ(geom::Shoelace::calculateAreaAndMomentumParallel(triangle).first, 2.0);
+    EXPECT_DOUBLE_EQ(geom::Shoelace::calculateAreaAndMomentumParallel(Points()).first, 0.0);
+
+    test_logger->info("Shoelace - intra-polygon parallel sum test passed");
+}
+
+TEST_F(ShoelaceTest, ParallelThresholdTest){
+    test_logger->info("Shoelace - automatic parallel sum above the vertex threshold");
+
+    Points lm = wavy_curve(geom::Shoelace::parallel_threshold + 2000);
+    Points polygon = preprocess::prep(9.999, lm);
+    ASSERT_GE(polygon.size(), geom::Shoelace::parallel_threshold);
+
+    const std::pair<double,double> parallel = geom::Shoelace::calculateAreaAndMomentumParallel(polygon);
+    const std::pair<double,double> result = geom::Shoelace::calculateAreaAndMomentum(polygon);
+    const std::pair<double,double> result_simd = geom::Shoelace::calculateAreaAndMomentum_simd(polygon);
+
+    EXPECT_EQ(result.first, parallel.first);
+    EXPECT_EQ(result.second, parallel.second);
+    EXPECT_EQ(result_simd.first, parallel.first);
+    EXPECT_EQ(result_simd.second, parallel.second);
+
+    // the fused trim sums the kept vertices in parallel too, the closing ones on their own
+    const std::pair<double,double> trimmed = geom::Shoelace::calculateTrimmedAreaAndMomentum(9.999, lm);
+    EXPECT_NEAR(trimmed.first, parallel.first, 1e-12 * parallel.first);
+    EXPECT_NEAR(trimmed.second, parallel.second, 1e-12 * parallel.second);
+
+    test_logger->info("Shoelace - automatic parallel sum test passed");
+}
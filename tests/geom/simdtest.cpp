@@ -0,0 +1,136 @@
+#include <vector>
+#include <spdlog/spdlog.h>
+#include <gtest/gtest.h>
+
+#include "inputreader/prep.h"
+#include "geom/shoelace.h"
+#include "geom/simd/isa.h"
+#include "geom/simd/kernels.h"
+
+class SimdTest : public ::testing::Test {
+protected:
+    Points curve;
+    std::vector<Points> polygons;
+
+    geom::simd::Isa initial_isa = geom::simd::activeIsa();
+    bool initial_reproducible = reproducible();
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+
+        // long polyline, so that every kernel runs its vector loop
+        for (std::size_t i = 0; i < 101; ++i) {
+            double eps = 0.1 * static_cast<double>(i);
+            curve.push_back(eps, std::sin(eps) + 0.05 * eps * eps);
+        }
+
+        for (double eps_cut = 0.15; eps_cut < 10.0; eps_cut += 0.35) {
+            polygons.push_back(preprocess::prep(eps_cut, curve));
+        }
+
+        test_logger->info("SimdTest setup complete");
+    }
+
+    void TearDown() override {
+        geom::simd::setIsa(initial_isa);
+        setReproducible(initial_reproducible);
+        test_logger->info("SimdTest teardown complete\n\n");
+    }
+};
+
+TEST_F(SimdTest, IsaNameTest) {
+    test_logger->info("Simd - isa name test");
+
+    for (geom::simd::Isa isa : {geom::simd::Isa::Scalar, geom::simd::Isa::SSE2,
+                                geom::simd::Isa::AVX2, geom::simd::Isa::AVX512}) {
+        geom::simd::Isa parsed;
+        ASSERT_TRUE(geom::simd::parseIsa(geom::simd::isaName(isa), parsed));
+        EXPECT_EQ(parsed, isa);
+    }
+
+    geom::simd::Isa parsed;
+    EXPECT_FALSE(geom::simd::parseIsa("neon", parsed));
+
+    test_logger->info("Simd - isa name test passed");
+}
+
+TEST_F(SimdTest, ForcedIsaTest) {
+    test_logger->info("Simd - all supported levels agree with the scalar reference");
+
+    const int best = static_cast<int>(geom::simd::detectIsa());
+    geom::PolygonMatrix matrix(polygons);
+
+    for (int level = 0; level <= best; ++level) {
+        geom::simd::Isa isa = static_cast<geom::simd::Isa>(level);
+        if (!geom::simd::setIsa(isa)) {
+            continue; // level not built for this target
+        }
+        ASSERT_EQ(geom::simd::activeIsa(), isa);
+        test_logger->info("Simd - checking {}", geom::simd::isaName(isa));
+
+        std::vector<double> area(polygons.size());
+        std::vector<double> momentum(polygons.size());
+        geom::Shoelace::calculateAreaAndMomentumBatch(matrix, area, momentum);
+
+        for (std::size_t p = 0; p < polygons.size(); ++p) {
+            std::pair<double,double> expected = geom::Shoelace::calculateAreaAndMomentum(polygons[p]);
+            std::pair<double,double> result = geom::Shoelace::calculateAreaAndMomentum_simd(polygons[p]);
+
+            EXPECT_NEAR(result.first, expected.first, 1e-12 * expected.first) << geom::simd::isaName(isa);
+            EXPECT_NEAR(result.second, expected.second, 1e-12 * expected.second) << geom::simd::isaName(isa);
+            EXPECT_DOUBLE_EQ(area[p], expected.first) << geom::simd::isaName(isa);
+            EXPECT_DOUBLE_EQ(momentum[p], expected.second) << geom::simd::isaName(isa);
+        }
+    }
+
+    test_logger->info("Simd - forced isa test passed");
+}
+
+TEST_F(SimdTest, OrderedKernelTest) {
+    test_logger->info("Simd - ordered kernels give the same bits on every level");
+
+    const int best = static_cast<int>(geom::simd::detectIsa());
+    const geom::simd::ShoelaceKernels& scalar = *geom::simd::scalar_kernels();
+
+    // reference sums of the scalar level, for every remainder of the vector loops
+    const double* eps = curve.get_epsilon().data();
+    const double* sig = curve.get_sigma().data();
+    std::vector<std::pair<double,double>> expected;
+    for (std::size_t n = 2; n <= curve.size(); ++n) {
+        double area, momentum;
+        scalar.ordered_chain_sums(eps, sig, n, area, momentum);
+        expected.emplace_back(area, momentum);
+    }
+
+    setReproducible(true);
+    ASSERT_TRUE(geom::simd::setIsa(geom::simd::Isa::Scalar));
+    std::vector<std::pair<double,double>> expected_polygons;
+    for (const Points& polygon : polygons) {
+        expected_polygons.push_back(geom::Shoelace::calculateAreaAndMomentum_simd(polygon));
+    }
+
+    for (int level = 0; level <= best; ++level) {
+        geom::simd::Isa isa = static_cast<geom::simd::Isa>(level);
+        if (!geom::simd::setIsa(isa)) {
+            continue; // level not built for this target
+        }
+        test_logger->info("Simd - checking ordered sums of {}", geom::simd::isaName(isa));
+
+        for (std::size_t n = 2; n <= curve.size(); ++n) {
+            double area, momentum;
+            geom::simd::kernels().ordered_chain_sums(eps, sig, n, area, momentum);
+            EXPECT_EQ(area, expected[n - 2].first) << geom::simd::isaName(isa) << ", n = " << n;
+            EXPECT_EQ(momentum, expected[n - 2].second) << geom::simd::isaName(isa) << ", n = " << n;
+        }
+
+        for (std::size_t p = 0; p < polygons.size(); ++p) {
+            std::pair<double,double> result = geom::Shoelace::calculateAreaAndMomentum_simd(polygons[p]);
+            EXPECT_EQ(result.first, expected_polygons[p].first) << geom::simd::isaName(isa);
+            EXPECT_EQ(result.second, expected_polygons[p].second) << geom::simd::isaName(isa);
+        }
+    }
+
+    test_logger->info("Simd - ordered kernel test passed");
+}
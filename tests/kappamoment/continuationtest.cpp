@@ -0,0 +1,92 @@
+#include <vector>
+#include <numeric>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "kappamoment/continuation.h"
+
+class ContinuationTest : public ::testing::Test {
+protected:
+    // material curves and cross section of z_python_spline/spline2.py
+    CrossSection cs{300.0, 160.0, 1.0, 60000.0};
+    Points cc{std::vector<double>{0.0, 0.003, 0.010}, std::vector<double>{0.0, 180.0, 180.0}};
+    Points ft{std::vector<double>{0.0, 0.002, 0.004, 0.008}, std::vector<double>{0.0, 50.0, 50.0, 75.0}};
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+        test_logger->info("ContinuationTest setup complete");
+    }
+
+    void TearDown() override {
+        test_logger->info("ContinuationTest teardown complete\n\n");
+    }
+};
+
+TEST_F(ContinuationTest, GridTraceTest) {
+    test_logger->info("Continuation - trace over a kappa grid");
+
+    SectionCal cal(cs, cc, ft);
+
+    std::vector<double> kappa;
+    for (std::size_t i = 1; i <= 1900; ++i) {
+        kappa.push_back(1.954e-08 * static_cast<double>(i));
+    }
+
+    MomentCurvatureCurve curve = traceMomentCurvature(cal, kappa);
+    ASSERT_TRUE(curve.completed);
+    ASSERT_EQ(curve.size(), kappa.size());
+
+    // same equilibrium as independent cold solves
+    SolveBatchResult cold = cal.solveBatch(kappa);
+    for (std::size_t i = 0; i < kappa.size(); ++i) {
+        EXPECT_NEAR(curve.eps_ca[i], cold.eps_ca[i], 1e-12 + 1e-9 * std::abs(cold.eps_ca[i])) << "kappa = " << kappa[i];
+        EXPECT_DOUBLE_EQ(curve.moment[i], curve.states[i].m_ca);
+    }
+
+    // warm starts: one or two corrector iterations per point on average
+    double mean_iterations = std::accumulate(curve.iterations.begin() + 1, curve.iterations.end(), 0.0)
+                           / static_cast<double>(curve.size() - 1);
+    EXPECT_LE(mean_iterations, 2.0);
+
+    test_logger->info("Continuation - grid trace test passed, {} iterations per point", mean_iterations);
+}
+
+TEST_F(ContinuationTest, AdaptiveTraceTest) {
+    test_logger->info("Continuation - adaptive trace");
+
+    SectionCal cal(cs, cc, ft);
+
+    MomentCurvatureCurve curve = traceMomentCurvature(cal, 1e-7, 3.7e-5);
+    ASSERT_TRUE(curve.completed);
+    EXPECT_DOUBLE_EQ(curve.kappa.back(), 3.7e-5);
+
+    for (std::size_t i = 1; i < curve.size(); ++i) {
+        EXPECT_GT(curve.kappa[i], curve.kappa[i - 1]);
+        EXPECT_NEAR(cal.forceresidual(curve.eps_ca[i], curve.kappa[i]), 0.0, 1e-9 * curve.states[i].f_cc);
+    }
+
+    // a point accepted with more iterations than the target shrinks the next step
+    ContinuationOptions strict;
+    strict.target_iterations = 1;
+    MomentCurvatureCurve slow = traceMomentCurvature(cal, 1e-7, 3.7e-5, strict);
+    ASSERT_TRUE(slow.completed);
+    std::size_t shrunk = 0;
+    for (std::size_t i = 2; i < slow.size(); ++i) {
+        if (slow.iterations[i - 1] > strict.target_iterations) {
+            const double previous_step = slow.kappa[i - 1] - slow.kappa[i - 2];
+            EXPECT_LE(slow.kappa[i] - slow.kappa[i - 1], strict.shrink * previous_step * (1.0 + 1e-9))
+                << "kappa = " << slow.kappa[i];
+            ++shrunk;
+        }
+    }
+    EXPECT_GT(shrunk, 0u);
+
+    // beyond the material curves the trace stops early
+    MomentCurvatureCurve capped = traceMomentCurvature(cal, 1e-7, 1e-4);
+    EXPECT_FALSE(capped.completed);
+    EXPECT_LT(capped.kappa.back(), 1e-4);
+
+    test_logger->info("Continuation - adaptive trace test passed, {} points", curve.size());
+}
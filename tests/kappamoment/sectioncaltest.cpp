@@ -0,0 +1,287 @@
+#include <vector>
+#include <sstream>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/ostream_sink.h>
+
+#include "kappamoment/sectioncal.h"
+
+class SectionCalTest : public ::testing::Test {
+protected:
+    // material curves and cross section of z_python_spline/spline2.py
+    CrossSection cs{300.0, 160.0, 1.0, 60000.0};
+    Points cc{std::vector<double>{0.0, 0.003, 0.010}, std::vector<double>{0.0, 180.0, 180.0}};
+    Points ft{std::vector<double>{0.0, 0.002, 0.004, 0.008}, std::vector<double>{0.0, 50.0, 50.0, 75.0}};
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+        test_logger->info("SectionCalTest setup complete");
+    }
+
+    void TearDown() override {
+        test_logger->info("SectionCalTest teardown complete\n\n");
+    }
+};
+
+TEST_F(SectionCalTest, EvalMatchesPolygonTest) {
+    test_logger->info("SectionCal - eval against prep + Shoelace");
+
+    SectionCal cal(cs, cc, ft);
+
+    const double eps_ca = 6.3e-6;
+    const double kappa = 1.954e-7;
+
+    SectionState s = cal.eval(eps_ca, kappa);
+
+    std::pair<double,double> m_cc = geom::Shoelace::calculateAreaAndMomentum(preprocess::prep(s.eps_cc, cc));
+    std::pair<double,double> m_ft = geom::Shoelace::calculateAreaAndMomentum(preprocess::prep(s.eps_ft, ft));
+
+    EXPECT_DOUBLE_EQ(s.f_cc, m_cc.first * s.jac_cc);
+    EXPECT_DOUBLE_EQ(s.f_ft, m_ft.first * s.jac_ft);
+    EXPECT_DOUBLE_EQ(s.m_ca, m_cc.second * s.jac_cc * s.jac_cc + m_ft.second * s.jac_ft * s.jac_ft);
+    EXPECT_DOUBLE_EQ(cal.forceresidual(eps_ca, kappa), s.f_cc - s.f_ft);
+
+    test_logger->info("SectionCal - eval test passed");
+}
+
+TEST_F(SectionCalTest, ResidualDerivativeTest) {
+    test_logger->info("SectionCal - force residual derivative test");
+
+    SectionCal cal(cs, cc, ft);
+
+    for (double kappa : {1.954e-7, 1.0e-5, 3.9e-5}) {
+        for (double eps_ca : {-2.0e-4, 1.0e-5, 4.0e-4}) {
+            std::pair<double,double> r = cal.forceresidualDerivative(eps_ca, kappa);
+
+            const double h = 1e-10;
+            double dr_fd = (cal.forceresidual(eps_ca + h, kappa) - cal.forceresidual(eps_ca - h, kappa)) / (2.0 * h);
+
+            EXPECT_DOUBLE_EQ(r.first, cal.forceresidual(eps_ca, kappa));
+            EXPECT_NEAR(r.second, dr_fd, 1e-5 * std::abs(dr_fd)) << "kappa = " << kappa << ", eps_ca = " << eps_ca;
+        }
+    }
+
+    test_logger->info("SectionCal - force residual derivative test passed");
+}
+
+TEST_F(SectionCalTest, SolveTest) {
+    test_logger->info("SectionCal - equilibrium solve test");
+
+    SectionCal cal(cs, cc, ft);
+
+    // rows of k_eps0_M.csv (the last rows lie beyond the material curves)
+    for (double kappa : {1.954e-07, 1.951e-05, 3.71204e-05}) {
+        SolveResult r = cal.solve(kappa);
+        std::pair<double,double> range = cal.bracket(kappa);
+
+        ASSERT_TRUE(r.converged) << "kappa = " << kappa;
+        EXPECT_GE(r.eps_ca, range.first);
+        EXPECT_LE(r.eps_ca, range.second);
+        EXPECT_LE(r.iterations, 20);
+
+        // residual is zero up to the force scale of the section
+        SectionState s = cal.eval(r.eps_ca, kappa);
+        EXPECT_NEAR(cal.forceresidual(r.eps_ca, kappa), 0.0, 1e-9 * s.f_cc) << "kappa = " << kappa;
+    }
+
+    test_logger->info("SectionCal - equilibrium solve test passed");
+}
+
+TEST_F(SectionCalTest, BracketFrontTest) {
+    test_logger->info("SectionCal - bracket of curves starting above zero strain");
+
+    Points cc_shifted{std::vector<double>{0.001, 0.003, 0.010}, std::vector<double>{0.0, 180.0, 180.0}};
+    Points ft_shifted{std::vector<double>{0.0005, 0.002, 0.004, 0.008}, std::vector<double>{0.0, 50.0, 50.0, 75.0}};
+    SectionCal cal(cs, cc_shifted, ft_shifted);
+
+    // both cut strains stay inside their curves over the whole bracket
+    for (double kappa : {1.0e-5, -1.0e-5, 2.0e-5}) {
+        std::pair<double,double> range = cal.bracket(kappa);
+        ASSERT_LT(range.first, range.second) << "kappa = " << kappa;
+
+        for (double t : {0.0, 0.5, 1.0}) {
+            const double eps_ca = range.first + t * (range.second - range.first);
+            SectionState s = cal.eval(eps_ca, kappa, SectionField::eps_cc | SectionField::eps_ft);
+            EXPECT_GE(s.eps_cc, 0.001 * (1.0 - 1e-9)) << "kappa = " << kappa << ", t = " << t;
+            EXPECT_LE(s.eps_cc, 0.010 * (1.0 + 1e-9)) << "kappa = " << kappa << ", t = " << t;
+            EXPECT_GE(s.eps_ft, 0.0005 * (1.0 - 1e-9)) << "kappa = " << kappa << ", t = " << t;
+            EXPECT_LE(s.eps_ft, 0.008 * (1.0 + 1e-9)) << "kappa = " << kappa << ", t = " << t;
+        }
+    }
+
+    test_logger->info("SectionCal - bracket of curves starting above zero strain passed");
+}
+
+TEST_F(SectionCalTest, SolveBatchTest) {
+    test_logger->info("SectionCal - batch solve test");
+
+    SectionCal cal(cs, cc, ft);
+
+    std::vector<double> kappa;
+    for (std::size_t i = 1; i <= 190; ++i) {
+        kappa.push_back(1.954e-07 * static_cast<double>(i));
+    }
+    // beyond the material curves: no equilibrium
+    kappa.push_back(1e-4);
+
+    SolveBatchResult batch = cal.solveBatch(kappa);
+    ASSERT_EQ(batch.eps_ca.size(), kappa.size());
+
+    for (std::size_t i = 0; i + 1 < kappa.size(); ++i) {
+        SolveResult single = cal.solve(kappa[i]);
+        EXPECT_TRUE(batch.converged[i]) << "kappa = " << kappa[i];
+        EXPECT_DOUBLE_EQ(batch.eps_ca[i], single.eps_ca);
+        EXPECT_EQ(batch.iterations[i], single.iterations);
+    }
+    EXPECT_FALSE(batch.converged.back());
+
+    // warm start from the solution converges right away
+    SolveBatchResult warm = cal.solveBatch(kappa, batch.eps_ca);
+    for (std::size_t i = 0; i + 1 < kappa.size(); ++i) {
+        EXPECT_TRUE(warm.converged[i]);
+        EXPECT_LE(warm.iterations[i], 2);
+    }
+
+    test_logger->info("SectionCal - batch solve test passed");
+}
+
+TEST_F(SectionCalTest, EvalBatchTest) {
+    test_logger->info("SectionCal - batch evaluation test");
+
+    SectionCal cal(cs, cc, ft);
+
+    std::vector<double> eps_ca;
+    std::vector<double> kappa;
+    for (std::size_t i = 1; i <= 500; ++i) {
+        kappa.push_back(7.0e-8 * static_cast<double>(i));
+        eps_ca.push_back(2.0e-6 * static_cast<double>(i % 37) - 3.0e-5);
+    }
+
+    SectionStateBatch states;
+    std::vector<double> residual;
+    std::vector<double> moment;
+    cal.evalBatch(eps_ca, kappa, states);
+    cal.forceresidualBatch(eps_ca, kappa, residual);
+    cal.momentBatch(eps_ca, kappa, moment);
+
+    ASSERT_EQ(states.size(), kappa.size());
+    ASSERT_EQ(residual.size(), kappa.size());
+    ASSERT_EQ(moment.size(), kappa.size());
+
+    for (std::size_t i = 0; i < kappa.size(); ++i) {
+        SectionState s = cal.eval(eps_ca[i], kappa[i]);
+        EXPECT_DOUBLE_EQ(states.eps_cc[i], s.eps_cc);
+        EXPECT_DOUBLE_EQ(states.eps_ft[i], s.eps_ft);
+        EXPECT_DOUBLE_EQ(states.h_cc[i], s.h_cc);
+        EXPECT_DOUBLE_EQ(states.h_ft[i], s.h_ft);
+        EXPECT_DOUBLE_EQ(states.jac_cc[i], s.jac_cc);
+        EXPECT_DOUBLE_EQ(states.jac_ft[i], s.jac_ft);
+        EXPECT_DOUBLE_EQ(states.f_cc[i], s.f_cc);
+        EXPECT_DOUBLE_EQ(states.f_ft[i], s.f_ft);
+        EXPECT_DOUBLE_EQ(states.m_ca[i], s.m_ca);
+        EXPECT_DOUBLE_EQ(residual[i], s.f_cc - s.f_ft);
+        EXPECT_DOUBLE_EQ(moment[i], s.m_ca);
+    }
+
+    // mismatched inputs give empty outputs
+    std::vector<double> short_kappa(kappa.begin(), kappa.begin() + 10);
+    cal.evalBatch(eps_ca, short_kappa, states);
+    EXPECT_EQ(states.size(), 0u);
+
+    test_logger->info("SectionCal - batch evaluation test passed");
+}
+
+TEST_F(SectionCalTest, BatchDiagnosticsTest) {
+    test_logger->info("SectionCal - failed cuts of a batch are reported once");
+
+    SectionCal cal(cs, cc, ft);
+
+    // every other point strains both materials beyond their curves
+    std::vector<double> eps_ca;
+    std::vector<double> kappa;
+    for (std::size_t i = 0; i < 200; ++i) {
+        kappa.push_back(1.0e-6);
+        eps_ca.push_back(i % 2 == 0 ? 1.0e-5 : -0.05);
+    }
+
+    // capture what the batches log
+    std::ostringstream log;
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(log);
+    auto capture = std::make_shared<spdlog::logger>("capture", sink);
+    auto previous = spdlog::default_logger();
+    spdlog::set_default_logger(capture);
+
+    SectionStateBatch states;
+    std::vector<double> residual;
+    cal.evalBatch(eps_ca, kappa, states, SectionField::all, ExecutionPolicy{ExecutionBackend::ThreadPool, 4, 16});
+    cal.forceresidualBatch(eps_ca, kappa, residual, ExecutionPolicy{ExecutionBackend::WorkStealing, 4, 16});
+
+    spdlog::set_default_logger(previous);
+
+    std::size_t lines = 0;
+    for (char c : log.str()) {
+        lines += (c == '\n');
+    }
+    EXPECT_EQ(lines, 2u) << log.str();
+    EXPECT_NE(log.str().find("evalBatch: 200 of 400 cuts failed (200 out of range"), std::string::npos) << log.str();
+
+    // failed cuts integrate to zero, as for the single-point functions
+    for (std::size_t i = 0; i < eps_ca.size(); ++i) {
+        SectionState s = cal.eval(eps_ca[i], kappa[i]);
+        EXPECT_EQ(states.f_cc[i], s.f_cc);
+        EXPECT_EQ(residual[i], s.f_cc - s.f_ft);
+    }
+
+    test_logger->info("SectionCal - failed cuts of a batch are reported once passed");
+}
+
+TEST_F(SectionCalTest, FieldMaskTest) {
+    test_logger->info("SectionCal - field-selective evaluation test");
+
+    SectionCal cal(cs, cc, ft);
+
+    const double eps_ca = 6.3e-6;
+    const double kappa = 1.954e-7;
+    SectionState full = cal.eval(eps_ca, kappa);
+
+    // requested fields are bitwise the same as in a full evaluation, the others stay zero
+    SectionState force = cal.eval(eps_ca, kappa, SectionField::f_cc | SectionField::f_ft);
+    EXPECT_EQ(force.f_cc, full.f_cc);
+    EXPECT_EQ(force.f_ft, full.f_ft);
+    EXPECT_EQ(force.m_ca, 0.0);
+    EXPECT_EQ(force.eps_cc, 0.0);
+    EXPECT_EQ(force.jac_ft, 0.0);
+
+    SectionState moment = cal.eval(eps_ca, kappa, SectionField::m_ca);
+    EXPECT_EQ(moment.m_ca, full.m_ca);
+    EXPECT_EQ(moment.f_cc, 0.0);
+    EXPECT_EQ(moment.f_ft, 0.0);
+
+    SectionState geometry = cal.eval(eps_ca, kappa, SectionField::eps_cc | SectionField::h_ft | SectionField::jac_cc);
+    EXPECT_EQ(geometry.eps_cc, full.eps_cc);
+    EXPECT_EQ(geometry.h_ft, full.h_ft);
+    EXPECT_EQ(geometry.jac_cc, full.jac_cc);
+    EXPECT_EQ(geometry.f_cc, 0.0);
+    EXPECT_EQ(geometry.m_ca, 0.0);
+
+    EXPECT_EQ(cal.forceresidual(eps_ca, kappa), full.f_cc - full.f_ft);
+    EXPECT_EQ(cal.moment(eps_ca, kappa), full.m_ca);
+
+    // a masked batch only allocates the requested fields
+    std::vector<double> eps_batch(100, eps_ca);
+    std::vector<double> kappa_batch(100, kappa);
+    SectionStateBatch states;
+    cal.evalBatch(eps_batch, kappa_batch, states, SectionField::m_ca);
+
+    EXPECT_EQ(states.size(), 100u);
+    EXPECT_EQ(states.m_ca.size(), 100u);
+    EXPECT_TRUE(states.f_cc.empty());
+    EXPECT_TRUE(states.eps_cc.empty());
+    for (double m : states.m_ca) {
+        EXPECT_EQ(m, full.m_ca);
+    }
+
+    test_logger->info("SectionCal - field-selective evaluation test passed");
+}
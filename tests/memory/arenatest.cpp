@@ -0,0 +1,206 @@
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "memory/arena.h"
+#include "points/points.h"
+#include "inputreader/prep.h"
+#include "geom/shoelace.h"
+#include "parallel/execution.h"
+
+class ArenaTest : public ::testing::Test {
+protected:
+    Points lm;   // more points than fit inline
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+
+        std::vector<double> eps;
+        std::vector<double> sig;
+        for (std::size_t i = 0; i < 50; ++i) {
+            eps.push_back(0.1 * static_cast<double>(i));
+            sig.push_back(static_cast<double>(i % 7));
+        }
+        lm = Points(eps, sig);
+
+        test_logger->info("ArenaTest setup complete");
+    }
+
+    void TearDown() override {
+        test_logger->info("ArenaTest teardown complete\n\n");
+    }
+};
+
+TEST_F(ArenaTest, AllocateTest) {
+    test_logger->info("Arena - allocate / reuse / reset test");
+
+    memory::Arena arena(4096);
+
+    void* a = arena.allocate(100);
+    void* b = arena.allocate(1000);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a) % memory::Arena::alignment, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % memory::Arena::alignment, 0u);
+    EXPECT_NE(a, b);
+
+    // a freed block is handed out again for the same size class
+    arena.deallocate(a, 100);
+    EXPECT_EQ(arena.allocate(128), a);
+    EXPECT_EQ(arena.counters().reuses, 1u);
+
+    // blocks larger than a chunk get a chunk of their own
+    void* large = arena.allocate(10000);
+    EXPECT_NE(large, nullptr);
+    EXPECT_EQ(arena.counters().chunk_allocations, 2u);
+
+    // after a reset the same requests are served from the kept chunks
+    arena.reset();
+    EXPECT_EQ(arena.allocate(100), a);
+    arena.allocate(1000);
+    arena.allocate(10000);
+    EXPECT_EQ(arena.counters().chunk_allocations, 2u);
+
+    test_logger->info("Arena - allocate / reuse / reset test passed");
+}
+
+TEST_F(ArenaTest, SteadyStateTest) {
+    test_logger->info("Arena - prep runs without global allocations");
+
+    memory::ThreadArenas arenas;
+
+    std::vector<double> areas(2000);
+
+    auto run = [&]() {
+        #pragma omp parallel
+        {
+            memory::ArenaScope scope(arenas.local());
+
+            #pragma omp for
+            for (int i = 0; i < 2000; ++i) {
+                const double eps_cut = 0.1 + 4.8 * static_cast<double>(i) / 1999.0;
+                Points polygon = preprocess::prep(eps_cut, lm);
+                areas[i] = geom::Shoelace::calculateArea(polygon);
+            }
+        }
+        arenas.reset();
+
+        // summed in index order, so every run gives the same bits
+        double total = 0.0;
+        for (double area : areas) {
+            total += area;
+        }
+        return total;
+    };
+
+    const double first = run();
+    const std::size_t after_first = memory::globalAllocationCount();
+
+    // later runs reuse the chunks of the first one
+    for (int r = 0; r < 3; ++r) {
+        EXPECT_EQ(run(), first);
+    }
+    EXPECT_EQ(memory::globalAllocationCount(), after_first);
+
+    memory::ArenaCounters counters = arenas.counters();
+    EXPECT_GT(counters.allocations, counters.reuses);
+    EXPECT_GT(counters.reuses, 0u);
+
+    // outside a scope Points uses the global heap
+    EXPECT_EQ(memory::currentArena(), nullptr);
+    Points polygon = preprocess::prep(4.0, lm);
+    EXPECT_EQ(memory::globalAllocationCount(), after_first + 1);
+
+    test_logger->info("Arena - prep runs without global allocations passed");
+}
+
+TEST_F(ArenaTest, WorkerTest) {
+    test_logger->info("Arena - one arena per worker of the thread pools");
+
+    memory::ThreadArenas arenas;
+
+    for (ExecutionBackend backend : {ExecutionBackend::ThreadPool, ExecutionBackend::WorkStealing,
+                                     ExecutionBackend::OpenMP}) {
+        const ExecutionPolicy policy{backend, 4, 1};
+        const std::size_t n = 64;
+
+        std::mutex mutex;
+        std::map<std::thread::id, memory::Arena*> arena_of;
+        std::vector<double> areas(n);
+
+        parallelFor(policy, n, [&](std::size_t, std::size_t first, std::size_t last) {
+            memory::Arena& arena = arenas.local();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto [it, inserted] = arena_of.emplace(std::this_thread::get_id(), &arena);
+                EXPECT_EQ(it->second, &arena) << "thread changed arena";
+            }
+
+            memory::ArenaScope scope(arena);
+            for (std::size_t i = first; i < last; ++i) {
+                Points polygon = preprocess::prep(0.1 + 4.8 * static_cast<double>(i) / static_cast<double>(n), lm);
+                areas[i] = geom::Shoelace::calculateArea(polygon);
+            }
+        });
+
+        // no arena is shared between threads
+        std::vector<memory::Arena*> distinct;
+        for (const auto& [thread, arena] : arena_of) {
+            distinct.push_back(arena);
+        }
+        std::sort(distinct.begin(), distinct.end());
+        EXPECT_EQ(std::unique(distinct.begin(), distinct.end()), distinct.end()) << backendName(backend);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            Points polygon = preprocess::prep(0.1 + 4.8 * static_cast<double>(i) / static_cast<double>(n), lm);
+            EXPECT_EQ(areas[i], geom::Shoelace::calculateArea(polygon)) << backendName(backend);
+        }
+        arenas.reset();
+    }
+
+    test_logger->info("Arena - one arena per worker passed");
+}
+
+TEST_F(ArenaTest, EscapeTest) {
+    test_logger->info("Arena - Points moved or copied out of a scope leave the arena");
+
+    memory::Arena arena(4096);
+    const Points expected = preprocess::prep(4.0, lm);
+    ASSERT_GT(expected.size(), Points::inline_capacity);
+
+    std::optional<Points> built;
+    {
+        memory::ArenaScope scope(arena);
+        built.emplace(preprocess::prep(4.0, lm));
+
+        // moves inside the scope keep the arena block
+        Points moved(std::move(*built));
+        built.emplace(std::move(moved));
+    }
+
+    const std::size_t before = memory::globalAllocationCount();
+    Points moved_out(std::move(*built));
+    Points copied_out(moved_out);
+    EXPECT_EQ(memory::globalAllocationCount(), before + 2);
+
+    // overwrite everything the arena handed out
+    arena.reset();
+    std::memset(arena.allocate(4096), 0xff, 4096);
+
+    for (const Points* points : {&moved_out, &copied_out}) {
+        ASSERT_EQ(points->size(), expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(points->get_epsilon()[i], expected.get_epsilon()[i]);
+            EXPECT_EQ(points->get_sigma()[i], expected.get_sigma()[i]);
+        }
+    }
+
+    test_logger->info("Arena - escape test passed");
+}
@@ -0,0 +1,246 @@
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "parallel/execution.h"
+#include "parallel/threadpool.h"
+#include "simulation/simulation.h"
+#include "inputreader/prep.h"
+#include "geom/shoelace.h"
+#include "geom/simd/isa.h"
+
+class ExecutionTest : public ::testing::Test {
+protected:
+
+    Points curve;
+    std::vector<double> cuts;
+    std::vector<ExecutionPolicy> policies;
+
+    geom::simd::Isa initial_isa = geom::simd::activeIsa();
+    bool initial_reproducible = reproducible();
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+
+        curve = Points(
+            std::vector<double>{0.0, 1.0, 2.0, 3.0, 4.5, 6.0, 7.5, 9.0, 10.0, 12.0},
+            std::vector<double>{0.0, 3.0, 4.0, 2.5, 2.0, 5.0, 1.0, 0.5, 1.5, 2.0}
+        );
+        for (std::size_t i = 0; i < 2000; ++i) {
+            cuts.push_back(-0.5 + 13.0 * static_cast<double>(i) / 1999.0);   // some outside the curve
+        }
+
+        for (ExecutionBackend backend : {ExecutionBackend::Serial, ExecutionBackend::OpenMP,
+                                         ExecutionBackend::ThreadPool, ExecutionBackend::Par,
+                                         ExecutionBackend::WorkStealing}) {
+            for (ExecutionSchedule schedule : {ExecutionSchedule::Static, ExecutionSchedule::Dynamic,
+                                               ExecutionSchedule::Guided}) {
+                for (std::size_t chunk_size : {0u, 1u, 37u}) {
+                    policies.push_back(ExecutionPolicy{backend, 3, chunk_size, schedule});
+                }
+            }
+        }
+
+        test_logger->info("ExecutionTest setup complete");
+    }
+
+    void TearDown() override {
+        geom::simd::setIsa(initial_isa);
+        setReproducible(initial_reproducible);
+        test_logger->info("ExecutionTest teardown complete\n\n");
+    }
+};
+
+TEST_F(ExecutionTest, ParallelForTest) {
+    test_logger->info("Execution - every index once, blocks in order");
+
+    for (std::size_t n : {0u, 1u, 5u, 1000u}) {
+        for (const ExecutionPolicy& policy : policies) {
+            std::vector<std::atomic<int>> visits(n);
+            std::vector<std::pair<std::size_t,std::size_t>> ranges(blockCount(policy, n));
+
+            parallelFor(policy, n, [&](std::size_t block, std::size_t first, std::size_t last) {
+                ranges[block] = {first, last};
+                for (std::size_t i = first; i < last; ++i) {
+                    ++visits[i];
+                }
+            });
+
+            for (std::size_t i = 0; i < n; ++i) {
+                EXPECT_EQ(visits[i], 1) << backendName(policy.backend) << " " << scheduleName(policy.schedule);
+            }
+            std::size_t next = 0;
+            for (const auto& [first, last] : ranges) {
+                EXPECT_EQ(first, next);
+                EXPECT_LT(first, last);
+                next = last;
+            }
+            EXPECT_EQ(next, n);
+        }
+    }
+
+    test_logger->info("Execution - every index once, blocks in order passed");
+}
+
+TEST_F(ExecutionTest, SimulationTest) {
+    test_logger->info("Execution - same results with every policy");
+
+    const ExecutionPolicy serial{ExecutionBackend::Serial};
+
+    PointsBatch batch;
+    std::vector<preprocess::PrepStatus> status;
+    preprocess::prep(cuts, curve, batch, status, serial);
+    std::vector<double> area = computeAreaTimeslices(batch, serial);
+    std::vector<std::pair<double,double>> am = computeAreaAndMomentumTimeslices(batch, serial);
+    std::vector<std::pair<double,double>> am_batch = computeAreaAndMomentumTimeslicesBatch(batch, serial);
+    std::vector<std::pair<double,double>> am_cuts = computeAreaAndMomentumCuts(cuts, curve, serial);
+
+    // every result depends on its own timeslice only, so the partition does not matter
+    for (const ExecutionPolicy& policy : policies) {
+        PointsBatch parallel_batch;
+        std::vector<preprocess::PrepStatus> parallel_status;
+        preprocess::prep(cuts, curve, parallel_batch, parallel_status, policy);
+        ASSERT_EQ(parallel_status, status);
+        ASSERT_TRUE(std::ranges::equal(parallel_batch.offsets(), batch.offsets()));
+        ASSERT_TRUE(std::ranges::equal(parallel_batch.epsilon(), batch.epsilon()));
+        ASSERT_TRUE(std::ranges::equal(parallel_batch.sigma(), batch.sigma()));
+
+        EXPECT_EQ(computeAreaTimeslices(batch, policy), area);
+        EXPECT_EQ(computeAreaAndMomentumTimeslices(batch, policy), am);
+        EXPECT_EQ(computeAreaAndMomentumTimeslicesBatch(batch, policy), am_batch);
+        EXPECT_EQ(computeAreaAndMomentumCuts(cuts, curve, policy), am_cuts);
+    }
+
+    test_logger->info("Execution - same results with every policy passed");
+}
+
+TEST_F(ExecutionTest, DefaultTest) {
+    test_logger->info("Execution - runtime default and names");
+
+    const ExecutionPolicy previous = defaultExecution();
+
+    setDefaultExecution(ExecutionPolicy{ExecutionBackend::ThreadPool, 2, 0, ExecutionSchedule::Dynamic});
+    EXPECT_EQ(defaultExecution().backend, ExecutionBackend::ThreadPool);
+    EXPECT_EQ(defaultExecution().threads, 2u);
+    EXPECT_EQ(computeAreaAndMomentumCuts(cuts, curve),
+              computeAreaAndMomentumCuts(cuts, curve, ExecutionPolicy{ExecutionBackend::Serial}));
+
+    setDefaultExecution(previous);
+
+    for (ExecutionBackend backend : {ExecutionBackend::Serial, ExecutionBackend::OpenMP,
+                                     ExecutionBackend::ThreadPool, ExecutionBackend::Par,
+                                     ExecutionBackend::WorkStealing}) {
+        ExecutionBackend parsed;
+        ASSERT_TRUE(parseBackend(backendName(backend), parsed));
+        EXPECT_EQ(parsed, backend);
+    }
+    ExecutionSchedule schedule;
+    EXPECT_TRUE(parseSchedule("guided", schedule));
+    EXPECT_EQ(schedule, ExecutionSchedule::Guided);
+    ExecutionBackend backend;
+    EXPECT_FALSE(parseBackend("cuda", backend));
+
+    test_logger->info("Execution - runtime default and names passed");
+}
+
+TEST_F(ExecutionTest, ThreadPoolTest) {
+    test_logger->info("ThreadPool - every worker once, nested runs");
+
+    ThreadPool pool(4);
+    ASSERT_EQ(pool.size(), 4u);
+
+    for (int repeat = 0; repeat < 100; ++repeat) {
+        std::vector<std::atomic<int>> calls(pool.size());
+        std::atomic<int> nested{0};
+
+        pool.run([&](std::size_t worker) {
+            ++calls[worker];
+            // a nested run executes on the calling worker instead of deadlocking
+            pool.run([&](std::size_t) { ++nested; });
+        });
+
+        for (std::size_t w = 0; w < pool.size(); ++w) {
+            EXPECT_EQ(calls[w], 1);
+        }
+        EXPECT_EQ(nested, 16);
+    }
+
+    test_logger->info("ThreadPool - every worker once, nested runs passed");
+}
+
+TEST_F(ExecutionTest, ReproducibleTest) {
+    test_logger->info("Execution - reproducible mode gives the same bits for every policy and isa");
+
+    setReproducible(true);
+
+    // an alternating series, whose rounding depends on the order of the sum
+    const std::size_t n = 3 * reproducible_block_size + 123;
+    auto series = [](std::size_t first, std::size_t last) {
+        double sum = 0.0;
+        for (std::size_t i = first; i < last; ++i) {
+            sum += ((i % 2) ? -1.0 : 1.0) / static_cast<double>(i + 1);
+        }
+        return sum;
+    };
+    auto add = [](double a, double b) { return a + b; };
+
+    const double expected = parallelReduce(ExecutionPolicy{ExecutionBackend::Serial}, n, 0.0, series, add);
+    for (ExecutionPolicy policy : policies) {
+        for (std::size_t threads : {1u, 2u, 4u}) {
+            policy.threads = threads;
+            EXPECT_EQ(parallelReduce(policy, n, 0.0, series, add), expected)
+                << backendName(policy.backend) << " " << scheduleName(policy.schedule) << " "
+                << policy.chunk_size << " " << threads;
+        }
+    }
+
+    // one large polygon over several blocks, on every instruction set
+    std::vector<double> eps(n);
+    std::vector<double> sig(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        eps[i] = 0.01 * static_cast<double>(i) / static_cast<double>(n);
+        sig[i] = 180.0 * std::tanh(400.0 * eps[i]) + std::sin(0.01 * static_cast<double>(i));
+    }
+    Points polygon = preprocess::prep(0.0099, Points(eps, sig));
+
+    // the same polygon as an interleaved (strided) view
+    std::vector<double> interleaved(2 * polygon.size());
+    for (std::size_t i = 0; i < polygon.size(); ++i) {
+        interleaved[2 * i] = polygon.get_epsilon()[i];
+        interleaved[2 * i + 1] = polygon.get_sigma()[i];
+    }
+    const PointsView strided(StridedSpan(interleaved.data(), polygon.size(), 2),
+                             StridedSpan(interleaved.data() + 1, polygon.size(), 2));
+
+    ASSERT_TRUE(geom::simd::setIsa(geom::simd::Isa::Scalar));
+    const std::pair<double,double> reference =
+        geom::Shoelace::calculateAreaAndMomentumParallel(polygon, ExecutionPolicy{ExecutionBackend::Serial});
+
+    const int best = static_cast<int>(geom::simd::detectIsa());
+    for (int level = 0; level <= best; ++level) {
+        const geom::simd::Isa isa = static_cast<geom::simd::Isa>(level);
+        if (!geom::simd::setIsa(isa)) {
+            continue;
+        }
+        for (std::size_t threads : {1u, 3u}) {
+            for (std::size_t chunk_size : {0u, 1000u}) {
+                const ExecutionPolicy policy{ExecutionBackend::WorkStealing, threads, chunk_size};
+                const std::pair<double,double> result = geom::Shoelace::calculateAreaAndMomentumParallel(polygon, policy);
+
+                EXPECT_EQ(result.first, reference.first) << geom::simd::isaName(isa) << " " << threads << " " << chunk_size;
+                EXPECT_EQ(result.second, reference.second) << geom::simd::isaName(isa) << " " << threads << " " << chunk_size;
+
+                const std::pair<double,double> strided_result = geom::Shoelace::calculateAreaAndMomentumParallel(strided, policy);
+                EXPECT_EQ(strided_result.first, reference.first) << "strided " << geom::simd::isaName(isa) << " " << threads;
+                EXPECT_EQ(strided_result.second, reference.second) << "strided " << geom::simd::isaName(isa) << " " << threads;
+            }
+        }
+    }
+
+    test_logger->info("Execution - reproducible test passed");
+}
@@ -0,0 +1,143 @@
+#include <vector>
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "parallel/workstealing.h"
+#include "parallel/execution.h"
+#include "parallel/threadpool.h"
+
+class WorkStealingTest : public ::testing::Test {
+protected:
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+        test_logger->info("WorkStealingTest setup complete");
+    }
+
+    void TearDown() override {
+        test_logger->info("WorkStealingTest teardown complete\n\n");
+    }
+};
+
+// work growing steeply with the index, like polygons cut at growing strains
+static double _uneven(std::size_t i)
+{
+    double x = 0.0;
+    const std::size_t steps = (i % 97 == 0) ? 2000 : 10;
+    for (std::size_t k = 0; k < steps; ++k) {
+        x += std::sqrt(static_cast<double>(i + k));
+    }
+    return x;
+}
+
+TEST_F(WorkStealingTest, CoverTest) {
+    test_logger->info("WorkStealing - every index once, ranges within the grain");
+
+    for (std::size_t threads : {1u, 2u, 4u, 7u}) {
+        for (std::size_t grain : {0u, 1u, 3u, 64u}) {
+            for (std::size_t n : {0u, 1u, 10u, 5000u}) {
+                std::vector<double> expected(n);
+                for (std::size_t i = 0; i < n; ++i) {
+                    expected[i] = _uneven(i);
+                }
+
+                std::vector<std::atomic<int>> visits(n);
+                std::vector<double> values(n);
+                std::atomic<bool> too_long{false};
+
+                workStealingFor(threads, n, grain, [&](std::size_t first, std::size_t last) {
+                    if (last - first > std::max<std::size_t>(grain, 1) || first >= last) {
+                        too_long = true;
+                    }
+                    for (std::size_t i = first; i < last; ++i) {
+                        ++visits[i];
+                        values[i] = _uneven(i);
+                    }
+                });
+
+                EXPECT_FALSE(too_long);
+                for (std::size_t i = 0; i < n; ++i) {
+                    ASSERT_EQ(visits[i], 1) << threads << " threads, grain " << grain << ", n " << n;
+                    ASSERT_EQ(values[i], expected[i]);
+                }
+            }
+        }
+    }
+
+    test_logger->info("WorkStealing - every index once, ranges within the grain passed");
+}
+
+TEST_F(WorkStealingTest, NestedTest) {
+    test_logger->info("WorkStealing - loops started from inside a loop");
+
+    std::atomic<std::size_t> total{0};
+    workStealingFor(4, 16, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            workStealingFor(4, 100, 7, [&](std::size_t a, std::size_t b) {
+                total += b - a;
+            });
+        }
+    });
+    EXPECT_EQ(total, 1600u);
+
+    test_logger->info("WorkStealing - loops started from inside a loop passed");
+}
+
+TEST_F(WorkStealingTest, ReduceTest) {
+    test_logger->info("WorkStealing - parallelReduce");
+
+    const ExecutionPolicy policy{ExecutionBackend::WorkStealing, 4, 13};
+    const std::size_t n = 100000;
+
+    const auto map = [](std::size_t first, std::size_t last) {
+        double sum = 0.0;
+        for (std::size_t i = first; i < last; ++i) {
+            sum += 1.0 / static_cast<double>(i + 1);
+        }
+        return sum;
+    };
+    const auto plus = [](double a, double b) { return a + b; };
+
+    // partials are combined in block order, so repeated runs agree to the bit
+    const double first = parallelReduce(policy, n, 0.0, map, plus);
+    for (int repeat = 0; repeat < 20; ++repeat) {
+        EXPECT_EQ(parallelReduce(policy, n, 0.0, map, plus), first);
+    }
+    EXPECT_NEAR(first, map(0, n), 1e-9);
+
+    const std::size_t count = parallelReduce(policy, n, std::size_t(0),
+        [](std::size_t a, std::size_t b) { return b - a; },
+        [](std::size_t a, std::size_t b) { return a + b; });
+    EXPECT_EQ(count, n);
+    EXPECT_EQ(parallelReduce(policy, 0, 5.0, map, plus), 5.0);
+
+    test_logger->info("WorkStealing - parallelReduce passed");
+}
+
+TEST_F(WorkStealingTest, IdleTest) {
+    test_logger->info("WorkStealing - idle workers sleep instead of spinning");
+
+    // one long range and nothing left to steal: the other workers have to wait for it
+    const std::clock_t cpu_start = std::clock();
+    workStealingFor(4, 4, 1, [&](std::size_t first, std::size_t) {
+        if (first == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        }
+    });
+    const double cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    // spinning workers would burn about the whole wait on every free core
+    EXPECT_LT(cpu_seconds, 0.1);
+
+    EXPECT_EQ(ThreadPool::resolve(0), ThreadPool::defaultThreads());
+    EXPECT_GE(ThreadPool::defaultThreads(), 1u);
+
+    test_logger->info("WorkStealing - idle workers sleep instead of spinning passed");
+}
@@ -0,0 +1,88 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "points/pointsbatch.h"
+#include "inputreader/prep.h"
+#include "simulation/simulation.h"
+
+class PointsBatchTest : public ::testing::Test {
+protected:
+    Points cc{std::vector<double>{0.0, 0.003, 0.010}, std::vector<double>{0.0, 180.0, 180.0}};
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+        test_logger->info("PointsBatchTest setup complete");
+    }
+
+    void TearDown() override {
+        test_logger->info("PointsBatchTest teardown complete\n\n");
+    }
+};
+
+TEST_F(PointsBatchTest, AppendTest) {
+    test_logger->info("PointsBatch - append test");
+
+    PointsBatch batch;
+    EXPECT_EQ(batch.size(), 0u);
+
+    // points are added to the last slice
+    batch.append(cc);
+    batch.push_back(1.0, 2.0);
+    batch.append(PointsView());
+    batch.append(PointsView());
+    batch.push_back(3.0, 4.0);
+    batch.push_back(5.0, 6.0);
+
+    ASSERT_EQ(batch.size(), 3u);
+    EXPECT_EQ(batch.total_points(), 6u);
+    EXPECT_EQ(batch[0].size(), 4u);
+    EXPECT_EQ(batch[0].get_sigma()[1], 180.0);
+    EXPECT_EQ(batch[0].get_epsilon()[3], 1.0);
+    EXPECT_TRUE(batch[1].empty());
+    EXPECT_EQ(batch[2].size(), 2u);
+    EXPECT_EQ(batch[2].get_sigma()[1], 6.0);
+
+    std::span<const std::size_t> offsets = batch.offsets();
+    EXPECT_EQ(std::vector<std::size_t>(offsets.begin(), offsets.end()), (std::vector<std::size_t>{0, 4, 4, 6}));
+
+    batch.clear();
+    EXPECT_EQ(batch.size(), 0u);
+    EXPECT_EQ(batch.total_points(), 0u);
+
+    test_logger->info("PointsBatch - append test passed");
+}
+
+TEST_F(PointsBatchTest, TimeslicesTest) {
+    test_logger->info("PointsBatch - timeslices against vector<Points>");
+
+    std::vector<Points> timeslices;
+    PointsBatch batch;
+    for (std::size_t t = 0; t < 500; ++t) {
+        const double eps_cut = 0.010 * static_cast<double>(t) / 499.0;
+        timeslices.push_back(preprocess::prep(eps_cut, cc));
+        preprocess::prep(eps_cut, cc, batch);
+    }
+
+    // an invalid cut still takes its slot
+    EXPECT_FALSE(preprocess::prep(1.0, cc, batch));
+    timeslices.push_back(Points());
+
+    ASSERT_EQ(batch.size(), timeslices.size());
+    for (std::size_t t = 0; t < timeslices.size(); ++t) {
+        ASSERT_EQ(batch[t].size(), timeslices[t].size());
+        for (std::size_t i = 0; i < batch[t].size(); ++i) {
+            EXPECT_EQ(batch[t].get_epsilon()[i], timeslices[t].get_epsilon()[i]);
+            EXPECT_EQ(batch[t].get_sigma()[i], timeslices[t].get_sigma()[i]);
+        }
+    }
+
+    EXPECT_EQ(computeAreaTimeslices(batch), computeAreaTimeslices(timeslices));
+    EXPECT_EQ(computeMomentumTimeslices(batch), computeMomentumTimeslices(timeslices));
+    EXPECT_EQ(computeAreaAndMomentumTimeslices(batch), computeAreaAndMomentumTimeslices(timeslices));
+    EXPECT_EQ(computeAreaAndMomentumTimeslicesBatch(batch), computeAreaAndMomentumTimeslicesBatch(timeslices));
+
+    test_logger->info("PointsBatch - timeslices test passed");
+}
@@ -1,5 +1,6 @@
 
 #include <vector>
+#include <cstdint>
 #include <gtest/gtest.h>
 #include <spdlog/spdlog.h>
 
@@ -51,8 +52,8 @@ TEST_F(PointsTest, Pushback_Test1) {
         points1.push_back(static_cast<double>(i), static_cast<double>(i) * 2.0);
     }
 
-    const std::vector<double>& eps = points1.get_epsilon();
-    const std::vector<double>& sig = points1.get_sigma();
+    std::span<const double> eps = points1.get_epsilon();
+    std::span<const double> sig = points1.get_sigma();
 
     for(size_t i = 0 ; i < 10 ; ++ i){
         EXPECT_DOUBLE_EQ(eps[i], static_cast<double>(i));
@@ -76,8 +77,8 @@ TEST_F(PointsTest, Pushback_Test2) {
         points2.push_back(static_cast<double>(i), static_cast<double>(i) * 2.0);
     }
 
-    const std::vector<double>& eps = points2.get_epsilon();
-    const std::vector<double>& sig = points2.get_sigma();
+    std::span<const double> eps = points2.get_epsilon();
+    std::span<const double> sig = points2.get_sigma();
 
 
     for(size_t i = 0 ; i < 10 ; ++ i){
@@ -103,8 +104,8 @@ TEST_F(PointsTest, Pushback_Test3){
         points3.push_back(static_cast<double>(i), static_cast<double>(i) * 2.0);
     }
 
-    const std::vector<double>& eps = points3.get_epsilon();
-    const std::vector<double>& sig = points3.get_sigma();
+    std::span<const double> eps = points3.get_epsilon();
+    std::span<const double> sig = points3.get_sigma();
 
     EXPECT_DOUBLE_EQ(eps[0], 1.0);
     EXPECT_DOUBLE_EQ(eps[1], 2.0);
@@ -162,8 +163,8 @@ TEST_F(PointsTest, Insert_Test1){
 
     points2.insert_range(eps_src, sig_src, 0, eps_src.size());
 
-    const std::vector<double>& eps = points2.get_epsilon();
-    const std::vector<double>& sig = points2.get_sigma();
+    std::span<const double> eps = points2.get_epsilon();
+    std::span<const double> sig = points2.get_sigma();
 
     // check values
     EXPECT_DOUBLE_EQ(eps[0], 0.0);
@@ -196,8 +197,8 @@ TEST_F(PointsTest, Insert_Test2){
 
     points3.insert_range(eps_src, sig_src, 0, eps_src.size());
 
-    const std::vector<double>& eps = points3.get_epsilon();
-    const std::vector<double>& sig = points3.get_sigma();
+    std::span<const double> eps = points3.get_epsilon();
+    std::span<const double> sig = points3.get_sigma();
 
     // check original values
     EXPECT_DOUBLE_EQ(eps[0], 1.0);
@@ -256,14 +257,44 @@ TEST_F(PointsTest, InsertWrongVectorTest2){
     test_logger->info("Points - insert_range() wrong vector size test2 passed");
 }
 
+TEST_F(PointsTest, InsertSelfTest){
+    test_logger->info("Points - insert_range() from the Points itself");
+
+    // large enough for the block to be returned to the system when it is freed, so
+    // reading it after growing would fault instead of passing by chance
+    const std::size_t n = 10000;
+    Points points;
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back(static_cast<double>(i), -static_cast<double>(i));
+    }
+    points.reserve(n);
+    ASSERT_LT(points.capacity(), 2 * n);
+
+    points.insert_range(points.get_epsilon(), points.get_sigma(), 0, n);
+    ASSERT_EQ(points.size(), 2 * n);
+    for (std::size_t i = 0; i < 2 * n; ++i) {
+        EXPECT_EQ(points.get_epsilon()[i], static_cast<double>(i % n));
+        EXPECT_EQ(points.get_sigma()[i], -static_cast<double>(i % n));
+    }
+
+    // a part of itself without growing, and a range out of bounds
+    points.insert_range(points.get_epsilon(), points.get_sigma(), 1, 3);
+    EXPECT_EQ(points.size(), 2 * n + 2);
+    EXPECT_EQ(points.get_epsilon()[2 * n + 1], 2.0);
+    points.insert_range(points.get_epsilon(), points.get_sigma(), 5, 3 * n);
+    EXPECT_EQ(points.size(), 2 * n + 2);
+
+    test_logger->info("Points - insert_range() from the Points itself passed");
+}
+
 
 TEST_F(PointsTest, ChangePointTest) {
     test_logger->info("Points - change_point() test");
 
     points3.change_point(1, 9.9, 8.8);
 
-    const std::vector<double>& eps = points3.get_epsilon();
-    const std::vector<double>& sig = points3.get_sigma();
+    std::span<const double> eps = points3.get_epsilon();
+    std::span<const double> sig = points3.get_sigma();
 
     EXPECT_DOUBLE_EQ(eps[1], 9.9);
     EXPECT_DOUBLE_EQ(sig[1], 8.8);
@@ -276,8 +307,8 @@ TEST_F(PointsTest, ChangeWrongPointTest1){
 
     points2.change_point(5, 7.7, 6.6); // index 5 is out of bounds
 
-    const std::vector<double>& eps = points2.get_epsilon();
-    const std::vector<double>& sig = points2.get_sigma();
+    std::span<const double> eps = points2.get_epsilon();
+    std::span<const double> sig = points2.get_sigma();
 
     EXPECT_EQ(points2.size(), 0u) << "wrong index test1 failed";
 
@@ -288,8 +319,8 @@ TEST_F(PointsTest, ChangeWrongPointTest2){
     test_logger->info("Points - change_point() wrong index test2");
     points3.change_point(10, 7.7, 6.6); // index 10 is out of bounds
 
-    const std::vector<double>& eps = points3.get_epsilon();
-    const std::vector<double>& sig = points3.get_sigma();
+    std::span<const double> eps = points3.get_epsilon();
+    std::span<const double> sig = points3.get_sigma();
 
     // original values should remain unchanged
     EXPECT_DOUBLE_EQ(eps[0], 1.0);
@@ -302,4 +333,47 @@ TEST_F(PointsTest, ChangeWrongPointTest2){
     EXPECT_DOUBLE_EQ(sig[2], 2.5);
 
     test_logger->info("Points - change_point() wrong index test2 passed");
-}
\ No newline at end of file
+}
+
+TEST_F(PointsTest, StorageTest){
+    test_logger->info("Points - aligned inline / heap storage test");
+
+    auto aligned = [](std::span<const double> values) {
+        return reinterpret_cast<std::uintptr_t>(values.data()) % Points::alignment == 0;
+    };
+
+    // small polygons stay inline, larger ones move to the heap; both stay aligned
+    Points points;
+    for (std::size_t i = 0; i < 100; ++i) {
+        points.push_back(static_cast<double>(i), static_cast<double>(i) * 2.0);
+
+        ASSERT_TRUE(aligned(points.get_epsilon())) << "size = " << points.size();
+        ASSERT_TRUE(aligned(points.get_sigma())) << "size = " << points.size();
+        ASSERT_GE(points.capacity(), points.size());
+        ASSERT_EQ(points.capacity() % (Points::alignment / sizeof(double)), 0u);
+    }
+    EXPECT_EQ(points3.capacity(), Points::inline_capacity);
+
+    // copies and moves of inline and heap storage keep the values
+    for (const Points* source : {&points3, &points}) {
+        Points copy(*source);
+        Points assigned;
+        assigned = *source;
+        Points moved_from(*source);
+        Points moved(std::move(moved_from));
+        Points move_assigned;
+        move_assigned = std::move(moved);
+
+        for (const Points* target : {&copy, &assigned, &move_assigned}) {
+            ASSERT_EQ(target->size(), source->size());
+            for (std::size_t i = 0; i < source->size(); ++i) {
+                EXPECT_EQ(target->get_epsilon()[i], source->get_epsilon()[i]);
+                EXPECT_EQ(target->get_sigma()[i], source->get_sigma()[i]);
+            }
+            EXPECT_TRUE(aligned(target->get_sigma()));
+        }
+        EXPECT_EQ(moved_from.size(), 0u);
+    }
+
+    test_logger->info("Points - aligned inline / heap storage test passed");
+}
@@ -0,0 +1,117 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "points/pointsview.h"
+#include "inputreader/prep.h"
+#include "geom/shoelace.h"
+#include "simulation/simulation.h"
+
+class PointsViewTest : public ::testing::Test {
+protected:
+    Points lm;
+    std::vector<double> interleaved;   // eps0, sig0, eps1, sig1, ...
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+
+        lm = Points(
+            std::vector<double>{0.5, 1.0, 2.5, 3.0, 4.5, 7.0, 7.5, 8.0, 9.5, 10.0},
+            std::vector<double>{1.0, 3.0, 4.0, 2.5, 2.0, 5.0, -1.0, 0.5, 1.5, 2.0}
+        );
+        for (std::size_t i = 0; i < lm.size(); ++i) {
+            interleaved.push_back(lm.get_epsilon()[i]);
+            interleaved.push_back(lm.get_sigma()[i]);
+        }
+
+        test_logger->info("PointsViewTest setup complete");
+    }
+
+    void TearDown() override {
+        test_logger->info("PointsViewTest teardown complete\n\n");
+    }
+
+    PointsView strided() const {
+        return PointsView(StridedSpan(interleaved.data(), lm.size(), 2),
+                          StridedSpan(interleaved.data() + 1, lm.size(), 2));
+    }
+};
+
+TEST_F(PointsViewTest, AccessTest) {
+    test_logger->info("PointsView - element access test");
+
+    PointsView contiguous = lm;
+    PointsView view = strided();
+
+    ASSERT_EQ(view.size(), lm.size());
+    EXPECT_TRUE(contiguous.contiguous());
+    EXPECT_FALSE(view.contiguous());
+
+    for (std::size_t i = 0; i < lm.size(); ++i) {
+        EXPECT_EQ(view.get_epsilon()[i], lm.get_epsilon()[i]);
+        EXPECT_EQ(view.get_sigma()[i], lm.get_sigma()[i]);
+    }
+
+    PointsView slice = view.subview(2, 3);
+    ASSERT_EQ(slice.size(), 3u);
+    EXPECT_EQ(slice.get_epsilon()[0], 2.5);
+    EXPECT_EQ(slice.get_sigma()[2], 2.0);
+
+    Points copy = slice.to_points();
+    ASSERT_EQ(copy.size(), 3u);
+    EXPECT_EQ(copy.get_epsilon()[1], 3.0);
+
+    // mismatched columns give an empty view
+    PointsView invalid(StridedSpan(interleaved.data(), 3), StridedSpan(interleaved.data(), 2));
+    EXPECT_TRUE(invalid.empty());
+
+    test_logger->info("PointsView - element access test passed");
+}
+
+TEST_F(PointsViewTest, RoutinesTest) {
+    test_logger->info("PointsView - geometry and preprocessing on views");
+
+    PointsView view = strided();
+
+    for (double eps_cut = 0.5; eps_cut <= 10.0; eps_cut += 0.25) {
+        Points expected = preprocess::prep(eps_cut, lm);
+        Points polygon = preprocess::prep(eps_cut, view);
+
+        ASSERT_EQ(polygon.size(), expected.size()) << "eps_cut = " << eps_cut;
+        for (std::size_t i = 0; i < polygon.size(); ++i) {
+            EXPECT_EQ(polygon.get_epsilon()[i], expected.get_epsilon()[i]);
+            EXPECT_EQ(polygon.get_sigma()[i], expected.get_sigma()[i]);
+        }
+
+        EXPECT_EQ(geom::Shoelace::calculateTrimmedAreaAndMomentum(eps_cut, view),
+                  geom::Shoelace::calculateTrimmedAreaAndMomentum(eps_cut, lm));
+    }
+
+    // the whole curve as a polygon, strided and contiguous
+    EXPECT_EQ(geom::Shoelace::calculateArea(view), geom::Shoelace::calculateArea(lm));
+    EXPECT_EQ(geom::Shoelace::calculateMomentum(view), geom::Shoelace::calculateMomentum(lm));
+    EXPECT_EQ(geom::Shoelace::calculateAreaAndMomentum(view), geom::Shoelace::calculateAreaAndMomentum(lm));
+    EXPECT_EQ(geom::Shoelace::calculateAreaAndMomentum_simd(view), geom::Shoelace::calculateAreaAndMomentum(lm));
+
+    // timeslices as views into one buffer
+    std::vector<PointsView> slices;
+    std::vector<Points> owned;
+    for (std::size_t n = 3; n <= lm.size(); ++n) {
+        slices.push_back(view.subview(0, n));
+        owned.push_back(slices.back().to_points());
+    }
+
+    std::vector<std::pair<double,double>> from_views = computeAreaAndMomentumTimeslices(slices);
+    std::vector<std::pair<double,double>> from_points = computeAreaAndMomentumTimeslices(owned);
+    std::vector<std::pair<double,double>> batch = computeAreaAndMomentumTimeslicesBatch(slices);
+    ASSERT_EQ(from_views.size(), from_points.size());
+    for (std::size_t i = 0; i < from_views.size(); ++i) {
+        EXPECT_EQ(from_views[i], from_points[i]);
+        EXPECT_DOUBLE_EQ(batch[i].first, from_points[i].first);
+        EXPECT_DOUBLE_EQ(batch[i].second, from_points[i].second);
+    }
+
+    test_logger->info("PointsView - geometry and preprocessing on views passed");
+}
@@ -0,0 +1,104 @@
+#include <vector>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "inputreader/prep.h"
+#include "inputreader/compiledcurve.h"
+
+class CompiledCurveTest : public ::testing::Test {
+protected:
+
+    Points lm1;
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+        lm1 = Points(
+            std::vector<double>{0.5, 1.0, 2.5, 3.0, 4.5, 7.0, 7.5},
+            std::vector<double>{1.0, 3.0, 4.0, 2.5, 2.0, 5.0, -1.0}
+        );
+        test_logger->info("CompiledCurveTest setup complete");
+    }
+
+    void TearDown() override {
+        test_logger->info("CompiledCurveTest teardown complete\n\n");
+    }
+
+};
+
+TEST_F(CompiledCurveTest, LowerBoundTest) {
+    test_logger->info("CompiledCurve - Eytzinger search against std::lower_bound");
+
+    // every tree shape up to a few levels, queries on, between and outside the breakpoints
+    for (std::size_t n = 2; n <= 40; ++n) {
+        std::vector<double> eps(n);
+        std::vector<double> sig(n, 1.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            eps[i] = static_cast<double>(i);
+        }
+        preprocess::CompiledCurve curve(Points(eps, sig));
+        ASSERT_TRUE(curve.valid());
+
+        std::size_t hint = 0;
+        for (double x = -1.0; x <= static_cast<double>(n); x += 0.25) {
+            std::size_t expected = static_cast<std::size_t>(
+                std::lower_bound(eps.begin(), eps.end(), x) - eps.begin());
+
+            EXPECT_EQ(curve.lower_bound(x), expected) << "n = " << n << ", x = " << x;
+            EXPECT_EQ(curve.lower_bound(x, hint), expected) << "n = " << n << ", x = " << x;
+        }
+
+        // a stale hint falls back to the search
+        hint = n - 1;
+        EXPECT_EQ(curve.lower_bound(0.5, hint), 1u);
+        EXPECT_EQ(hint, 1u);
+    }
+
+    test_logger->info("CompiledCurve - Eytzinger search test passed");
+}
+
+TEST_F(CompiledCurveTest, LocateTest) {
+    test_logger->info("CompiledCurve - locate against _preprocess_polyline_derivative");
+
+    preprocess::CompiledCurve curve(lm1);
+    ASSERT_TRUE(curve.valid());
+
+    for (double eps_cut = 0.5; eps_cut <= 7.5; eps_cut += 0.125) {
+        preprocess::CutPoint expected = preprocess::_preprocess_polyline_derivative(eps_cut, lm1);
+        preprocess::CutPoint result = curve.locate(eps_cut);
+
+        EXPECT_EQ(result.idx, expected.idx) << "eps_cut = " << eps_cut;
+        EXPECT_DOUBLE_EQ(result.sigma, expected.sigma) << "eps_cut = " << eps_cut;
+        EXPECT_DOUBLE_EQ(result.dsigma, expected.dsigma) << "eps_cut = " << eps_cut;
+
+        Points polygon = preprocess::prep(eps_cut, curve);
+        Points reference = preprocess::prep(eps_cut, lm1);
+        ASSERT_EQ(polygon.size(), reference.size());
+        for (std::size_t i = 0; i < polygon.size(); ++i) {
+            EXPECT_DOUBLE_EQ(polygon.get_sigma()[i], reference.get_sigma()[i]);
+        }
+    }
+
+    test_logger->info("CompiledCurve - locate test passed");
+}
+
+TEST_F(CompiledCurveTest, InvalidTest) {
+    test_logger->info("CompiledCurve - invalid curve test");
+
+    preprocess::CompiledCurve too_short(Points(std::vector<double>{1.0}, std::vector<double>{1.0}));
+    preprocess::CompiledCurve unsorted(Points(std::vector<double>{0.0, 2.0, 1.0}, std::vector<double>{0.0, 1.0, 2.0}));
+    preprocess::CompiledCurve curve(lm1);
+
+    EXPECT_FALSE(too_short.valid());
+    EXPECT_FALSE(unsorted.valid());
+
+    preprocess::CutPoint outside = curve.locate(8.0);
+    EXPECT_EQ(outside.idx, 0u);
+    EXPECT_DOUBLE_EQ(outside.sigma, 0.0);
+    EXPECT_EQ(preprocess::prep(0.1, curve).size(), 0u);
+    EXPECT_EQ(unsorted.locate(1.0).idx, 0u);
+
+    test_logger->info("CompiledCurve - invalid curve test passed");
+}
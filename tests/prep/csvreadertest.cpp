@@ -0,0 +1,197 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "inputreader/csvreader.h"
+#include "inputreader/mappedfile.h"
+
+class CsvReaderTest : public ::testing::Test {
+protected:
+
+    std::filesystem::path directory;
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+        directory = std::filesystem::temp_directory_path() / "spline_csvreadertest";
+        std::filesystem::create_directories(directory);
+        test_logger->info("CsvReaderTest setup complete");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+        test_logger->info("CsvReaderTest teardown complete\n\n");
+    }
+
+    std::string write(const std::string& name, const std::string& contents) const {
+        std::filesystem::path path = directory / name;
+        std::ofstream(path, std::ios::binary) << contents;
+        return path.string();
+    }
+};
+
+TEST_F(CsvReaderTest, ParseTest) {
+    test_logger->info("CsvReader - parse text with header, blanks and comments");
+
+    std::string text =
+        "k,eps_0,M_tar\n"
+        "1.954e-07,6.3e-06,16200.0\n"
+        "\n"
+        "# comment\n"
+        " 3.907e-07 , 1.26e-05 ,32500.0\r\n"
+        "+5.861e-07,-1.89e-05,48700\n";
+
+    preprocess::CsvColumns table = preprocess::parseCsv(text, 3);
+    ASSERT_TRUE(table.ok) << table.error;
+    ASSERT_EQ(table.rows, 3u);
+    EXPECT_EQ(table.columns[0][0], 1.954e-07);
+    EXPECT_EQ(table.columns[1][1], 1.26e-05);
+    EXPECT_EQ(table.columns[0][2], 5.861e-07);
+    EXPECT_EQ(table.columns[1][2], -1.89e-05);
+    EXPECT_EQ(table.columns[2][2], 48700.0);
+
+    // errors name the line of the file
+    preprocess::CsvColumns missing = preprocess::parseCsv("a,b\n1,2\n3\n", 2);
+    EXPECT_FALSE(missing.ok);
+    EXPECT_EQ(missing.error.rfind("line 3:", 0), 0u) << missing.error;
+
+    preprocess::CsvColumns extra = preprocess::parseCsv("1,2,3\n", 2);
+    EXPECT_FALSE(extra.ok);
+
+    preprocess::CsvColumns not_finite = preprocess::parseCsv("1,2\n2,nan\n", 2);
+    EXPECT_FALSE(not_finite.ok);
+    EXPECT_EQ(not_finite.error.rfind("line 2:", 0), 0u) << not_finite.error;
+
+    preprocess::CsvColumns descending = preprocess::parseCsv("0,0\n2,1\n1,1\n", 2, 0);
+    EXPECT_FALSE(descending.ok);
+    EXPECT_EQ(descending.error.rfind("line 3:", 0), 0u) << descending.error;
+
+    preprocess::CsvColumns semicolon = preprocess::parseCsv("0;1\n2;3\n", 2, 0, {';'});
+    ASSERT_TRUE(semicolon.ok) << semicolon.error;
+    EXPECT_EQ(semicolon.columns[1][1], 3.0);
+
+    test_logger->info("CsvReader - parse text with header, blanks and comments passed");
+}
+
+TEST_F(CsvReaderTest, ChunkTest) {
+    test_logger->info("CsvReader - chunked parsing matches a single chunk");
+
+    std::string text = "eps,sigma\n";
+    for (int i = 0; i < 2000; ++i) {
+        text += std::to_string(i * 1e-5) + "," + std::to_string(180.0 * (i % 7)) + "\n";
+        if (i % 97 == 0) {
+            text += "\n";
+        }
+    }
+
+    preprocess::CsvOptions whole;
+    whole.chunk_bytes = text.size();
+    preprocess::CsvOptions small;
+    small.chunk_bytes = 64;
+
+    preprocess::CsvColumns expected = preprocess::parseCsv(text, 2, 0, whole);
+    preprocess::CsvColumns chunked = preprocess::parseCsv(text, 2, 0, small);
+    ASSERT_TRUE(expected.ok) << expected.error;
+    ASSERT_TRUE(chunked.ok) << chunked.error;
+    EXPECT_EQ(expected.rows, 2000u);
+    EXPECT_EQ(chunked.columns, expected.columns);
+
+    // the chunks run through the given execution policy
+    for (ExecutionBackend backend : {ExecutionBackend::Serial, ExecutionBackend::WorkStealing}) {
+        preprocess::CsvOptions policy = small;
+        policy.execution = ExecutionPolicy{backend, 4};
+        preprocess::CsvColumns parsed = preprocess::parseCsv(text, 2, 0, policy);
+        ASSERT_TRUE(parsed.ok) << parsed.error;
+        EXPECT_EQ(parsed.columns, expected.columns) << backendName(backend);
+    }
+
+    // a descending step right at a chunk boundary is still found, on the right line
+    std::string broken = "0,0\n1,0\n2,0\n1.5,0\n3,0\n";
+    preprocess::CsvOptions one_line;
+    one_line.chunk_bytes = 4;
+    preprocess::CsvColumns result = preprocess::parseCsv(broken, 2, 0, one_line);
+    EXPECT_FALSE(result.ok);
+    EXPECT_EQ(result.error.rfind("line 4:", 0), 0u) << result.error;
+
+    test_logger->info("CsvReader - chunked parsing matches a single chunk passed");
+}
+
+TEST_F(CsvReaderTest, FileTest) {
+    test_logger->info("CsvReader - read curve and target table files");
+
+    std::string curve_path = write("curve.csv", "eps,sigma\n0.0,0.0\n0.003,180.0\n0.01,180.0\n");
+    Points curve = preprocess::readCurve(curve_path);
+    ASSERT_EQ(curve.size(), 3u);
+    EXPECT_EQ(curve.get_epsilon()[1], 0.003);
+    EXPECT_EQ(curve.get_sigma()[2], 180.0);
+
+    std::string table_path = write("k_eps0_M.csv", "k,eps_0,M_tar\n1.954e-07,6.3e-06,16200.0\n3.907e-07,1.26e-05,32500.0\n");
+    preprocess::TargetTable table = preprocess::readTargetTable(table_path);
+    ASSERT_EQ(table.size(), 2u);
+    EXPECT_EQ(table.kappa[1], 3.907e-07);
+    EXPECT_EQ(table.eps_0[0], 6.3e-06);
+    EXPECT_EQ(table.moment[1], 32500.0);
+
+    preprocess::MappedFile file(table_path);
+    ASSERT_TRUE(file.valid());
+    EXPECT_EQ(file.text().substr(0, 5), "k,eps");
+
+    // invalid curves and missing files give empty results
+    EXPECT_EQ(preprocess::readCurve(write("descending.csv", "1,0\n0,1\n")).size(), 0u);
+    EXPECT_EQ(preprocess::readCurve(write("single.csv", "0,0\n")).size(), 0u);
+    EXPECT_EQ(preprocess::readCurve((directory / "missing.csv").string()).size(), 0u);
+    EXPECT_EQ(preprocess::readTargetTable((directory / "missing.csv").string()).size(), 0u);
+
+    test_logger->info("CsvReader - read curve and target table files passed");
+}
+
+TEST_F(CsvReaderTest, StreamTest) {
+    test_logger->info("CsvReader - stream a file chunk by chunk");
+
+    std::string text = "eps,sigma\n";
+    for (int i = 0; i < 2000; ++i) {
+        text += std::to_string(i * 1e-5) + "," + std::to_string(180.0 * (i % 7)) + "\n";
+    }
+    std::string path = write("stream.csv", text);
+
+    preprocess::CsvOptions small;
+    small.chunk_bytes = 64;
+
+    std::vector<std::vector<double>> streamed(2);
+    std::size_t chunks = 0;
+    preprocess::CsvStreamResult result = preprocess::streamCsv(path, 2, 0,
+        [&](const std::vector<std::vector<double>>& columns, std::size_t rows) {
+            for (std::size_t c = 0; c < 2; ++c) {
+                streamed[c].insert(streamed[c].end(), columns[c].begin(), columns[c].begin() + rows);
+            }
+            ++chunks;
+            return true;
+        }, small);
+
+    ASSERT_TRUE(result.ok) << result.error;
+    EXPECT_EQ(result.rows, 2000u);
+    EXPECT_GT(chunks, 1u);
+    EXPECT_EQ(streamed, preprocess::readCsv(path, 2, 0).columns);
+
+    // a consumer can stop the stream
+    std::size_t calls = 0;
+    preprocess::CsvStreamResult stopped = preprocess::streamCsv(path, 2, 0,
+        [&](const std::vector<std::vector<double>>&, std::size_t) { return ++calls < 3; }, small);
+    EXPECT_FALSE(stopped.ok);
+    EXPECT_EQ(calls, 3u);
+
+    // a descending step across chunks is found on the right line
+    preprocess::CsvOptions one_line;
+    one_line.chunk_bytes = 4;
+    preprocess::CsvStreamResult broken = preprocess::streamCsv(write("broken.csv", "0,0\n1,0\n2,0\n1.5,0\n3,0\n"), 2, 0,
+        [](const std::vector<std::vector<double>>&, std::size_t) { return true; }, one_line);
+    EXPECT_FALSE(broken.ok);
+    EXPECT_EQ(broken.rows, 3u);
+    EXPECT_EQ(broken.error.rfind("line 4:", 0), 0u) << broken.error;
+
+    test_logger->info("CsvReader - stream a file chunk by chunk passed");
+}
@@ -1,8 +1,14 @@
 #include <vector>
+#include <cmath>
 #include <gtest/gtest.h>
 #include <spdlog/spdlog.h>
 
+#include <sstream>
+#include <spdlog/sinks/ostream_sink.h>
+
 #include "inputreader/prep.h"
+#include "geom/shoelace.h"
+#include "simulation/simulation.h"
 
 class PrepTest : public ::testing::Test {
 protected:
@@ -120,6 +126,27 @@ TEST_F(PrepTest, PrePolyExcatMatchTest){
     test_logger->info("Prep - _preprocess_polyline function exact match test passed");
 }
 
+TEST_F(PrepTest, PrePolyDerivativeTest){
+    test_logger->info("Prep - _preprocess_polyline_derivative function test");
+
+    preprocess::CutPoint cut = preprocess::_preprocess_polyline_derivative(1.2, lm1);
+    EXPECT_EQ(cut.idx, 3u);
+    EXPECT_DOUBLE_EQ(cut.sigma, 0.8);
+    EXPECT_DOUBLE_EQ(cut.dsigma, -1.0);
+
+    // exact match: slope of the segment on the left
+    preprocess::CutPoint vertex = preprocess::_preprocess_polyline_derivative(2.0, lm2);
+    EXPECT_EQ(vertex.idx, 2u);
+    EXPECT_DOUBLE_EQ(vertex.sigma, -2.0);
+    EXPECT_DOUBLE_EQ(vertex.dsigma, 1.0);
+
+    preprocess::CutPoint invalid = preprocess::_preprocess_polyline_derivative(5.0, lm2);
+    EXPECT_EQ(invalid.idx, 0u);
+    EXPECT_DOUBLE_EQ(invalid.dsigma, 0.0);
+
+    test_logger->info("Prep - _preprocess_polyline_derivative function test passed");
+}
+
 TEST_F(PrepTest, PreTest1){
     test_logger->info("Prep - prep function test1");
 
@@ -197,4 +224,161 @@ TEST_F(PrepTest, PreInvalidTest2){
     EXPECT_EQ(prepped.size(), 0u)<< "expected size 0, got: " << prepped.size();
 
     test_logger->info("Prep - prep function unvalid test2 passed");
-}
\ No newline at end of file
+}
+TEST_F(PrepTest, PreBatchTest){
+    test_logger->info("Prep - batch prep over an array of cuts");
+
+    // ascending (merge pass) and shuffled (lockstep search) cuts
+    std::vector<double> sorted_cuts = {0.2, 0.5, 0.75, 1.0, 1.2, 1.5, 1.9, 2.0};
+    std::vector<double> shuffled_cuts = {1.9, 0.2, 2.0, 1.0, 0.75, 1.5, 0.5, 1.2};
+
+    for (const std::vector<double>& cuts : {sorted_cuts, shuffled_cuts}) {
+        PointsBatch batch;
+        std::vector<preprocess::PrepStatus> status;
+
+        std::size_t failures = preprocess::prep(cuts, lm1, batch, status);
+
+        EXPECT_EQ(failures, 0u);
+        ASSERT_EQ(batch.size(), cuts.size());
+        ASSERT_EQ(status.size(), cuts.size());
+
+        for (std::size_t c = 0; c < cuts.size(); ++c) {
+            EXPECT_EQ(status[c], preprocess::PrepStatus::Ok);
+
+            Points expected = preprocess::prep(cuts[c], lm1);
+            PointsView polygon = batch[c];
+            ASSERT_EQ(polygon.size(), expected.size()) << "eps_cut = " << cuts[c];
+            for (std::size_t i = 0; i < polygon.size(); ++i) {
+                EXPECT_EQ(polygon.get_epsilon()[i], expected.get_epsilon()[i]);
+                EXPECT_EQ(polygon.get_sigma()[i], expected.get_sigma()[i]);
+            }
+        }
+    }
+
+    test_logger->info("Prep - batch prep over an array of cuts passed");
+}
+
+TEST_F(PrepTest, PreBatchInvalidTest){
+    test_logger->info("Prep - batch prep with failing cuts");
+
+    std::vector<double> cuts = {-1.0, 2.5, 5.0, std::nan(""), 4.0};
+
+    PointsBatch batch;
+    std::vector<preprocess::PrepStatus> status;
+
+    std::size_t failures = preprocess::prep(cuts, lm2, batch, status);
+
+    EXPECT_EQ(failures, 3u);
+    ASSERT_EQ(batch.size(), cuts.size());
+    EXPECT_EQ(status[0], preprocess::PrepStatus::OutOfRange);
+    EXPECT_EQ(status[1], preprocess::PrepStatus::Ok);
+    EXPECT_EQ(status[2], preprocess::PrepStatus::OutOfRange);
+    EXPECT_EQ(status[3], preprocess::PrepStatus::OutOfRange);
+    EXPECT_EQ(status[4], preprocess::PrepStatus::Ok);
+
+    // failed cuts leave empty slices, the others their polygon
+    EXPECT_EQ(batch[0].size(), 0u);
+    EXPECT_EQ(batch[1].size(), preprocess::prep(2.5, lm2).size());
+    EXPECT_EQ(batch[3].size(), 0u);
+    EXPECT_EQ(batch[4].size(), preprocess::prep(4.0, lm2).size());
+
+    // a curve with fewer than 2 points fails every cut
+    Points single(std::vector<double>{0.0}, std::vector<double>{1.0});
+    failures = preprocess::prep(cuts, single, batch, status);
+    EXPECT_EQ(failures, cuts.size());
+    EXPECT_EQ(status[1], preprocess::PrepStatus::InvalidCurve);
+    EXPECT_EQ(batch.size(), 2 * cuts.size());
+
+    test_logger->info("Prep - batch prep with failing cuts passed");
+}
+
+TEST_F(PrepTest, TryPrepTest){
+    test_logger->info("Prep - non-logging try_prep");
+
+    preprocess::PrepResult<Points> ok = preprocess::try_prep(1.2, lm1);
+    ASSERT_TRUE(ok.ok());
+    Points reference = preprocess::prep(1.2, lm1);
+    ASSERT_EQ(ok.value.size(), reference.size());
+    for (std::size_t i = 0; i < reference.size(); ++i) {
+        EXPECT_EQ(ok.value.get_epsilon()[i], reference.get_epsilon()[i]);
+        EXPECT_EQ(ok.value.get_sigma()[i], reference.get_sigma()[i]);
+    }
+
+    preprocess::PrepResult<Points> out_of_range = preprocess::try_prep(5.0, lm2);
+    EXPECT_EQ(out_of_range.status, preprocess::PrepStatus::OutOfRange);
+    EXPECT_EQ(out_of_range.value.size(), 0u);
+
+    preprocess::PrepResult<Points> nan_cut = preprocess::try_prep(std::nan(""), lm2);
+    EXPECT_EQ(nan_cut.status, preprocess::PrepStatus::OutOfRange);
+
+    Points single(std::vector<double>{0.0}, std::vector<double>{1.0});
+    EXPECT_EQ(preprocess::try_prep(0.0, single).status, preprocess::PrepStatus::InvalidCurve);
+
+    // a cut on a first vertex with sigma = 0 looks like the {0, 0.0} sentinel, but is valid
+    Points origin(std::vector<double>{0.0, 1.0, 2.0}, std::vector<double>{0.0, 1.0, 1.5});
+    preprocess::PrepResult<std::pair<std::size_t,double>> lookup = preprocess::_try_preprocess_polyline(0.0, origin);
+    EXPECT_TRUE(lookup.ok());
+    EXPECT_EQ(lookup.value.first, 0u);
+    EXPECT_EQ(lookup.value.second, 0.0);
+    EXPECT_EQ(preprocess::try_prep(0.0, origin).value.size(), 3u);
+
+    preprocess::PrepResult<std::pair<double,double>> trimmed = geom::Shoelace::tryTrimmedAreaAndMomentum(11.0, lm2);
+    EXPECT_EQ(trimmed.status, preprocess::PrepStatus::OutOfRange);
+    EXPECT_EQ(trimmed.value, std::make_pair(0.0, 0.0));
+
+    test_logger->info("Prep - non-logging try_prep passed");
+}
+
+TEST_F(PrepTest, DiagnosticsTest){
+    test_logger->info("Prep - failures of a batch are logged once");
+
+    std::vector<double> cuts;
+    for (int i = 0; i < 200; ++i) {
+        cuts.push_back(-1.0 + 0.05 * i);    // [-1, 9): half of them outside lm2
+    }
+
+    // capture what the batch logs
+    std::ostringstream log;
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(log);
+    auto capture = std::make_shared<spdlog::logger>("capture", sink);
+    auto previous = spdlog::default_logger();
+    spdlog::set_default_logger(capture);
+
+    std::vector<std::pair<double,double>> result = computeAreaAndMomentumCuts(cuts, lm2);
+
+    spdlog::set_default_logger(previous);
+
+    std::size_t lines = 0;
+    for (char c : log.str()) {
+        lines += (c == '\n');
+    }
+    EXPECT_EQ(lines, 1u) << log.str();
+
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i < cuts.size(); ++i) {
+        if (cuts[i] < 0.0 || cuts[i] > 4.0) {
+            EXPECT_EQ(result[i], std::make_pair(0.0, 0.0));
+            ++failed;
+        } else {
+            EXPECT_EQ(result[i], geom::Shoelace::calculateTrimmedAreaAndMomentum(cuts[i], lm2));
+        }
+    }
+
+    // per-block counters add up to the whole batch
+    const ExecutionPolicy policy{ExecutionBackend::WorkStealing, 4};
+    std::vector<preprocess::PrepDiagnostics> blocks(blockCount(policy, cuts.size()));
+    parallelFor(policy, cuts.size(), [&](std::size_t block, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            blocks[block].record(preprocess::try_prep(cuts[i], lm2).status);
+        }
+    });
+    preprocess::PrepDiagnostics total;
+    for (const preprocess::PrepDiagnostics& counted : blocks) {
+        total += counted;
+    }
+    EXPECT_EQ(total.total(), cuts.size());
+    EXPECT_EQ(total.out_of_range, failed);
+    EXPECT_EQ(total.invalid_curve, 0u);
+
+    test_logger->info("Prep - failures of a batch are logged once passed");
+}
@@ -0,0 +1,158 @@
+#include <vector>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "simulation/pipeline.h"
+#include "simulation/simulation.h"
+#include "inputreader/prep.h"
+
+// Keeps every block it is given
+class MemorySink final : public storage::ResultSink {
+public:
+    std::vector<std::vector<double>> columns = std::vector<std::vector<double>>(3);
+    std::size_t blocks = 0;
+    std::size_t fail_after = static_cast<std::size_t>(-1);     // blocks written before failing
+
+    bool write(std::span<const std::vector<double>> block, std::size_t rows) override {
+        if (blocks == fail_after) {
+            return false;
+        }
+        ++blocks;
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            columns[c].insert(columns[c].end(), block[c].begin(), block[c].begin() + rows);
+        }
+        return true;
+    }
+
+    bool close() override {
+        return true;
+    }
+};
+
+class PipelineTest : public ::testing::Test {
+protected:
+
+    Points curve;
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+
+        curve = Points(
+            std::vector<double>{0.0, 1.0, 2.0, 3.0, 4.5, 6.0, 7.5, 9.0, 10.0, 12.0},
+            std::vector<double>{0.0, 3.0, 4.0, 2.5, 2.0, 5.0, 1.0, 0.5, 1.5, 2.0}
+        );
+
+        test_logger->info("PipelineTest setup complete");
+    }
+
+    void TearDown() override {
+        test_logger->info("PipelineTest teardown complete\n\n");
+    }
+};
+
+TEST_F(PipelineTest, MatchTest) {
+    test_logger->info("Pipeline - same results as the in-memory functions");
+
+    const std::size_t count = 1001;
+    std::vector<double> eps(count);
+    StrainGenerator reference = linearStrains(0.0, 12.0, count);
+    ASSERT_EQ(reference(eps), count);
+
+    PointsBatch batch;
+    std::vector<preprocess::PrepStatus> status;
+    preprocess::prep(eps, curve, batch, status);
+    std::vector<std::pair<double,double>> expected = computeAreaAndMomentumTimeslices(batch);
+
+    // chunks that do not divide the history, and the smallest queues
+    for (std::size_t chunk_size : {7u, 64u, 5000u}) {
+        MemorySink sink;
+        PipelineResult result = runPipeline(linearStrains(0.0, 12.0, count), curve, sink,
+                                            PipelineOptions{chunk_size, 1});
+
+        ASSERT_TRUE(result.ok);
+        EXPECT_EQ(result.timesteps, count);
+        EXPECT_EQ(result.chunks, (count + chunk_size - 1) / chunk_size);
+        EXPECT_EQ(result.diagnostics.ok, count);
+        ASSERT_EQ(sink.columns[0].size(), count);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(sink.columns[0][i], eps[i]);
+            EXPECT_EQ(sink.columns[1][i], expected[i].first);
+            EXPECT_EQ(sink.columns[2][i], expected[i].second);
+        }
+    }
+
+    test_logger->info("Pipeline - same results as the in-memory functions passed");
+}
+
+TEST_F(PipelineTest, FailureTest) {
+    test_logger->info("Pipeline - failed cuts and a failing sink");
+
+    // cuts outside the curve give (0, 0) and are counted
+    std::vector<double> eps = {-1.0, 1.5, 13.0, 6.0};
+    MemorySink sink;
+    PipelineResult result = runPipeline(strainsFrom(eps), curve, sink, PipelineOptions{3, 2});
+
+    ASSERT_TRUE(result.ok);
+    EXPECT_EQ(result.diagnostics.ok, 2u);
+    EXPECT_EQ(result.diagnostics.out_of_range, 2u);
+    ASSERT_EQ(sink.columns[1].size(), 4u);
+    EXPECT_EQ(sink.columns[1][0], 0.0);
+    EXPECT_GT(sink.columns[1][1], 0.0);
+    EXPECT_EQ(sink.columns[2][2], 0.0);
+    EXPECT_GT(sink.columns[2][3], 0.0);
+
+    // a sink that fails stops the pipeline, and it still finishes
+    MemorySink failing;
+    failing.fail_after = 2;
+    result = runPipeline(linearStrains(0.0, 12.0, 100000), curve, failing, PipelineOptions{100, 1});
+
+    EXPECT_FALSE(result.ok);
+    EXPECT_EQ(result.timesteps, 200u);
+    EXPECT_EQ(failing.columns[0].size(), 200u);
+
+    test_logger->info("Pipeline - failed cuts and a failing sink passed");
+}
+
+TEST_F(PipelineTest, OverlapTest) {
+    test_logger->info("Pipeline - prep and the kernel run at the same time");
+
+    for (ExecutionBackend backend : {ExecutionBackend::ThreadPool, ExecutionBackend::WorkStealing,
+                                     ExecutionBackend::OpenMP}) {
+        const PipelineStages stages = pipelineStages(ExecutionPolicy{backend, 4});
+        EXPECT_EQ(stages.prep.threads + stages.kernel.threads, 4u);
+
+        // every block of either stage waits until the other stage has started one
+        std::mutex mutex;
+        std::condition_variable changed;
+        bool started[2] = {false, false};
+        bool overlapped[2] = {false, false};
+
+        auto stage = [&](const ExecutionPolicy& policy, int self) {
+            parallelFor(policy, 8, [&](std::size_t, std::size_t, std::size_t) {
+                std::unique_lock<std::mutex> lock(mutex);
+                started[self] = true;
+                changed.notify_all();
+                if (changed.wait_for(lock, std::chrono::seconds(5), [&] { return started[1 - self]; })) {
+                    overlapped[self] = true;
+                }
+            });
+        };
+
+        std::thread prep(stage, std::cref(stages.prep), 0);
+        std::thread kernel(stage, std::cref(stages.kernel), 1);
+        prep.join();
+        kernel.join();
+
+        EXPECT_TRUE(overlapped[0] && overlapped[1]) << backendName(backend);
+    }
+
+    test_logger->info("Pipeline - prep and the kernel run at the same time passed");
+}
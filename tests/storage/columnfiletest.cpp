@@ -0,0 +1,209 @@
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "storage/columnfile.h"
+#include "inputreader/prep.h"
+#include "simulation/simulation.h"
+
+class ColumnFileTest : public ::testing::Test {
+protected:
+
+    Points curve;
+    PointsBatch batch;
+    std::filesystem::path directory;
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+
+        curve = Points(
+            std::vector<double>{0.0, 1.0, 2.0, 3.0, 4.5, 6.0, 7.5, 9.0, 10.0, 12.0},
+            std::vector<double>{0.0, 3.0, 4.0, 2.5, 2.0, 5.0, 1.0, 0.5, 1.5, 2.0}
+        );
+
+        std::vector<double> cuts;
+        for (double eps_cut = 0.5; eps_cut <= 12.0; eps_cut += 0.25) {
+            cuts.push_back(eps_cut);
+        }
+        std::vector<preprocess::PrepStatus> status;
+        preprocess::prep(cuts, curve, batch, status);
+
+        directory = std::filesystem::temp_directory_path() / "spline_columnfiletest";
+        std::filesystem::create_directories(directory);
+
+        test_logger->info("ColumnFileTest setup complete");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+        test_logger->info("ColumnFileTest teardown complete\n\n");
+    }
+
+    std::string path(const std::string& name) const {
+        return (directory / name).string();
+    }
+};
+
+TEST_F(ColumnFileTest, RoundTripTest) {
+    test_logger->info("ColumnFile - curves, batches and results round trip");
+
+    ASSERT_TRUE(storage::writeCurve(path("curve.col"), curve));
+    ASSERT_TRUE(storage::writeBatch(path("batch.col"), batch));
+
+    storage::ColumnFile curve_file(path("curve.col"));
+    ASSERT_TRUE(curve_file.valid());
+    ASSERT_EQ(curve_file.columns().size(), 2u);
+    EXPECT_TRUE(curve_file.columns()[0].mapped);
+
+    PointsView view = storage::curveView(curve_file);
+    ASSERT_EQ(view.size(), curve.size());
+    for (std::size_t i = 0; i < curve.size(); ++i) {
+        EXPECT_EQ(view.get_epsilon()[i], curve.get_epsilon()[i]);
+        EXPECT_EQ(view.get_sigma()[i], curve.get_sigma()[i]);
+    }
+    // columns start on 64-byte boundaries of the (page aligned) mapping
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(view.get_epsilon().data()) % 64, 0u);
+
+    storage::ColumnFile batch_file(path("batch.col"));
+    ASSERT_TRUE(batch_file.valid());
+    std::vector<PointsView> slices = storage::batchViews(batch_file);
+    ASSERT_EQ(slices.size(), batch.size());
+
+    std::vector<std::pair<double,double>> expected = computeAreaAndMomentumTimeslices(batch);
+    std::vector<std::pair<double,double>> loaded = computeAreaAndMomentumTimeslices(slices);
+    EXPECT_EQ(loaded, expected);
+
+    ASSERT_TRUE(storage::writeMoments(path("moments.col"), expected));
+    storage::ColumnFile moments(path("moments.col"));
+    ASSERT_EQ(moments.doubles("m0").size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(moments.doubles("m0")[i], expected[i].first);
+        EXPECT_EQ(moments.doubles("m1")[i], expected[i].second);
+    }
+
+    SectionStateBatch states;
+    states.m_ca = {1.0, 2.0, 3.0};
+    states.f_cc = {4.0, 5.0, 6.0};
+    ASSERT_TRUE(storage::writeSectionStates(path("states.col"), states));
+    storage::ColumnFile state_file(path("states.col"));
+    EXPECT_EQ(state_file.columns().size(), 2u);
+    EXPECT_FALSE(state_file.contains("eps_cc"));
+    EXPECT_EQ(state_file.doubles("m_ca")[2], 3.0);
+
+    // wrong type and missing columns give empty spans
+    EXPECT_TRUE(batch_file.doubles("offsets").empty());
+    EXPECT_TRUE(batch_file.doubles("m0").empty());
+
+    test_logger->info("ColumnFile - curves, batches and results round trip passed");
+}
+
+TEST_F(ColumnFileTest, ChunkAndCompressionTest) {
+    test_logger->info("ColumnFile - chunked and compressed columns");
+
+    std::vector<double> first = {1.0, 2.0, 3.0};
+    std::vector<double> second = {4.0, 5.0};
+    std::vector<std::uint64_t> ids = {7, 8, 9, 10, 11};
+
+    {
+        storage::ColumnWriter writer(path("chunks.col"));
+        ASSERT_TRUE(writer.add("values", std::span<const double>(first)));
+        ASSERT_TRUE(writer.add("ids", std::span<const std::uint64_t>(ids)));
+        ASSERT_TRUE(writer.add("values", std::span<const double>(second), storage::Compression::Deflate));
+        EXPECT_FALSE(writer.add("ids", std::span<const double>(second)));   // other type
+        EXPECT_FALSE(writer.add("a_column_name_longer_than_31_chars", std::span<const double>(second)));
+        ASSERT_TRUE(writer.close());
+    }
+
+    storage::ColumnFile file(path("chunks.col"));
+    ASSERT_TRUE(file.valid());
+    std::span<const double> values = file.doubles("values");
+    ASSERT_EQ(values.size(), 5u);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(values[i], static_cast<double>(i + 1));
+    }
+    EXPECT_FALSE(file.columns()[0].mapped);
+    EXPECT_EQ(file.columns()[0].chunks, 2u);
+    EXPECT_EQ(file.integers("ids")[4], 11u);
+
+    // compressed batches are smaller and decode to the same values
+    ASSERT_TRUE(storage::writeBatch(path("plain.col"), batch));
+    ASSERT_TRUE(storage::writeBatch(path("packed.col"), batch, storage::Compression::Deflate));
+    if (storage::compressionAvailable()) {
+        EXPECT_LT(std::filesystem::file_size(path("packed.col")), std::filesystem::file_size(path("plain.col")));
+    }
+    storage::ColumnFile packed(path("packed.col"));
+    ASSERT_TRUE(packed.valid());
+    std::span<const double> eps = packed.doubles("epsilon");
+    ASSERT_EQ(eps.size(), batch.total_points());
+    for (std::size_t i = 0; i < eps.size(); ++i) {
+        EXPECT_EQ(eps[i], batch.epsilon()[i]);
+    }
+
+    // not a column file
+    std::ofstream(path("text.col")) << "eps,sigma\n0,0\n";
+    EXPECT_FALSE(storage::ColumnFile(path("text.col")).valid());
+    EXPECT_FALSE(storage::ColumnFile(path("missing.col")).valid());
+
+    test_logger->info("ColumnFile - chunked and compressed columns passed");
+}
+
+TEST_F(ColumnFileTest, CorruptCountTest) {
+    test_logger->info("ColumnFile - directory entries that do not fit the file");
+
+    for (storage::Compression compression : {storage::Compression::None, storage::Compression::Deflate}) {
+        ASSERT_TRUE(storage::writeBatch(path("batch.col"), batch, compression));
+
+        storage::FileHeader header;
+        storage::DirectoryEntry entry;
+        std::fstream file(path("batch.col"), std::ios::binary | std::ios::in | std::ios::out);
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        file.seekg(static_cast<std::streamoff>(header.directory_offset));
+        file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+        ASSERT_TRUE(file);
+
+        // a count far beyond the mapping is rejected before anything is allocated for it
+        entry.count = std::uint64_t(1) << 60;
+        file.seekp(static_cast<std::streamoff>(header.directory_offset));
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        file.close();
+
+        storage::ColumnFile corrupt(path("batch.col"));
+        EXPECT_FALSE(corrupt.valid());
+        EXPECT_TRUE(corrupt.columns().empty());
+
+        // so is a chunk that does not start on the alignment the writer pads to
+        ASSERT_TRUE(storage::writeBatch(path("batch.col"), batch, compression));
+        file.open(path("batch.col"), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(static_cast<std::streamoff>(header.directory_offset));
+        file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+        ASSERT_TRUE(file);
+
+        entry.offset += 8;
+        file.seekp(static_cast<std::streamoff>(header.directory_offset));
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        file.close();
+
+        EXPECT_FALSE(storage::ColumnFile(path("batch.col")).valid());
+    }
+
+    // a curve file with columns of different lengths gives no view
+    {
+        storage::ColumnWriter writer(path("uneven.col"));
+        std::vector<double> eps = {0.0, 1.0, 2.0};
+        std::vector<double> sig = {0.0, 1.0};
+        ASSERT_TRUE(writer.add("epsilon", std::span<const double>(eps)));
+        ASSERT_TRUE(writer.add("sigma", std::span<const double>(sig)));
+        ASSERT_TRUE(writer.close());
+    }
+    storage::ColumnFile uneven(path("uneven.col"));
+    ASSERT_TRUE(uneven.valid());
+    EXPECT_TRUE(storage::curveView(uneven).empty());
+
+    test_logger->info("ColumnFile - directory entries that do not fit the file passed");
+}
@@ -0,0 +1,113 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include "storage/resultwriter.h"
+#include "inputreader/csvreader.h"
+#include "simulation/simulation.h"
+
+class ResultWriterTest : public ::testing::Test {
+protected:
+
+    Points curve;
+    std::vector<double> cuts;
+    std::filesystem::path directory;
+
+    std::shared_ptr<spdlog::logger> test_logger = spdlog::get("test_logger");
+
+    void SetUp() override {
+        spdlog::set_level(spdlog::level::info);
+
+        curve = Points(
+            std::vector<double>{0.0, 0.003, 0.01},
+            std::vector<double>{0.0, 180.0, 180.0}
+        );
+        for (std::size_t t = 0; t < 1000; ++t) {
+            cuts.push_back(0.01 * static_cast<double>(t) / 999.0);
+        }
+
+        directory = std::filesystem::temp_directory_path() / "spline_resultwritertest";
+        std::filesystem::create_directories(directory);
+
+        test_logger->info("ResultWriterTest setup complete");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+        test_logger->info("ResultWriterTest teardown complete\n\n");
+    }
+
+    std::string path(const std::string& name) const {
+        return (directory / name).string();
+    }
+};
+
+TEST_F(ResultWriterTest, StreamTest) {
+    test_logger->info("ResultWriter - streamed cuts match the in-memory results");
+
+    preprocess::CompiledCurve compiled(curve);
+    std::vector<std::pair<double,double>> expected = computeAreaAndMomentumCuts(cuts, compiled);
+
+    // small buffers and blocks, so that buffers are swapped many times
+    for (const char* name : {"moments.csv", "moments.col"}) {
+        storage::ResultWriter writer(storage::openResultSink(path(name), {"m0", "m1"}), 2, 64);
+        computeAreaAndMomentumCuts(cuts, compiled, writer, 100);
+        ASSERT_TRUE(writer.close());
+        EXPECT_EQ(writer.rows_appended(), cuts.size());
+    }
+
+    // text: shortest round-trip form reads back exactly
+    preprocess::CsvColumns text = preprocess::readCsv(path("moments.csv"), 2);
+    ASSERT_TRUE(text.ok) << text.error;
+    ASSERT_EQ(text.rows, expected.size());
+
+    storage::ColumnFile binary(path("moments.col"));
+    ASSERT_TRUE(binary.valid());
+    std::span<const double> m0 = binary.doubles("m0");
+    std::span<const double> m1 = binary.doubles("m1");
+    ASSERT_EQ(m0.size(), expected.size());
+
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(text.columns[0][i], expected[i].first);
+        EXPECT_EQ(text.columns[1][i], expected[i].second);
+        EXPECT_EQ(m0[i], expected[i].first);
+        EXPECT_EQ(m1[i], expected[i].second);
+    }
+
+    test_logger->info("ResultWriter - streamed cuts match the in-memory results passed");
+}
+
+TEST_F(ResultWriterTest, AppendTest) {
+    test_logger->info("ResultWriter - rows, blocks and errors");
+
+    {
+        storage::ResultWriter writer(std::make_unique<storage::CsvSink>(path("rows.csv"),
+                                     std::vector<std::string>{"a", "b", "c"}, ';'), 3, 2);
+        writer.append_row({1.0, 2.0, 3.0});
+        std::vector<double> a = {4.0, 7.0, 10.0};
+        std::vector<double> b = {5.0, 8.0, 11.0};
+        std::vector<double> c = {6.0, 9.0, 12.5};
+        writer.append({a, b, c});
+
+        // wrong shapes are rejected
+        writer.append({a, b});
+        writer.append_row({1.0});
+        EXPECT_EQ(writer.rows_appended(), 4u);
+    }   // closed by the destructor
+
+    std::ifstream file(path("rows.csv"));
+    std::stringstream contents;
+    contents << file.rdbuf();
+    EXPECT_EQ(contents.str(), "a;b;c\n1;2;3\n4;5;6\n7;8;9\n10;11;12.5\n");
+
+    // a sink that cannot be created drops the results and reports it
+    storage::ResultWriter broken(storage::openResultSink(path("missing/dir.csv"), {"m0"}), 1);
+    broken.append_row({1.0});
+    EXPECT_FALSE(broken.close());
+
+    test_logger->info("ResultWriter - rows, blocks and errors passed");
+}
@@ -42,10 +42,18 @@ def residual_vec(eps_ca_vec, kappa_vec):
     eps_ca_vec = np.asarray(eps_ca_vec, dtype=np.float64)
     kappa_vec  = np.asarray(kappa_vec, dtype=np.float64)
 
+    return np.asarray(cal.forceresidual_batch(eps_ca_vec.tolist(), kappa_vec.tolist()))
+
+
+# Analytic derivative of the residual (C++ forceresidual_prime), lets newton
+# converge quadratically instead of falling back to the secant method
+def residual_prime_vec(eps_ca_vec, kappa_vec):
+    eps_ca_vec = np.asarray(eps_ca_vec, dtype=np.float64)
+    kappa_vec  = np.asarray(kappa_vec, dtype=np.float64)
 
     out = np.empty_like(eps_ca_vec)
     for i in range(eps_ca_vec.size):
-        out[i] = cal.forceresidual(float(eps_ca_vec[i]), float(kappa_vec[i]))
+        out[i] = cal.forceresidual_prime(float(eps_ca_vec[i]), float(kappa_vec[i]))
     return out
 
 
@@ -57,6 +65,7 @@ if __name__ == "__main__":
     eps_ca_opt = newton(
         residual_vec,
         eps_ca_ini,
+        fprime=residual_prime_vec,
         args=(K,),
         tol=1e-10,
         maxiter=50
@@ -65,6 +74,15 @@ if __name__ == "__main__":
 
     print(f"Newton finished in {end-start:.6f} s")
 
+    # Same solve in C++ (safeguarded Newton, all kappa in parallel)
+    start = timer()
+    sol = cal.solve_batch(K.tolist(), eps_ca_ini.tolist())
+    end = timer()
+
+    print(f"C++ solve_batch finished in {end-start:.6f} s, "
+          f"{int(np.sum(sol.converged))}/{K.size} converged, "
+          f"max {max(sol.iterations)} iterations")
+
     # Use the effective kappa for moment computation
     eps_ca_opt = np.clip(np.asarray(eps_ca_opt, dtype=np.float64), 0.0, EPS_MAX)
 
@@ -74,9 +92,7 @@ if __name__ == "__main__":
     kmax = np.maximum(kmax, 0.0)
     K_eff = np.clip(np.asarray(K, dtype=np.float64), 0.0, kmax)
 
-    m_ca = np.empty_like(eps_ca_opt)
-    for i in range(len(K_eff)):
-        m_ca[i] = cal.moment(float(eps_ca_opt[i]), float(K_eff[i]))
+    m_ca = np.asarray(cal.moment_batch(eps_ca_opt.tolist(), K_eff.tolist()))
 
     # Example of section state (first data point)
     st0 = cal.eval(float(eps_ca_opt[0]), float(K_eff[0]))
@@ -0,0 +1,37 @@
+# tests/test_columnfile.py
+
+import gc
+
+import splinepy
+
+
+def _batch(cuts):
+    curve = splinepy.Points([0.0, 0.003, 0.010], [0.0, 180.0, 180.0])
+    batch = splinepy.PointsBatch()
+    for eps_cut in cuts:
+        batch.append(splinepy.preprocess(eps_cut, curve))
+    return batch
+
+
+def test_batch_views(tmp_path):
+    cuts = [0.002, 0.005, 0.009]
+    batch = _batch(cuts)
+    path = str(tmp_path / "batch.col")
+    assert splinepy.write_batch(path, batch)
+
+    views = splinepy.batch_views(splinepy.ColumnFile(path))
+    assert len(views) == len(cuts)
+
+    # the views keep the file mapped after every other reference to it is gone
+    gc.collect()
+    for i, view in enumerate(views):
+        expected = batch[i].to_points()
+        assert view.size() == expected.size()
+        assert view.to_points().get_epsilon() == expected.get_epsilon()
+        assert view.to_points().get_sigma() == expected.get_sigma()
+
+    # a single view outlives the holder as well
+    first = views[0]
+    del views
+    gc.collect()
+    assert splinepy.cal_area_momentum(first) == splinepy.cal_area_momentum(batch[0])